@@ -0,0 +1,423 @@
+#include "common.h"
+#include "block.h"
+#include "record.h"
+#include "table.h"
+#include "tpch_gen.h"
+#include "memory_tracker.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * ============================================================================
+ * 레코드 / 블록 / 조인 커널 마이크로벤치마크
+ * ============================================================================
+ *
+ * 디스크 없이 메모리에서 만든 TPC-H 레코드(tpch_gen.h, 고정 seed)로 커널 하나씩 반복 실행해
+ * 연산 하나당 시간(ns/op), 힙 할당 바이트(bytes/op), 할당 횟수(allocs/op)를 잰다.
+ * 할당은 추적 할당기(memory_tracker.h)의 프로세스 합계로 센다.
+ *
+ * 벤치마크마다 반복 횟수를 늘려 가며 한 번 실행이 --min-time 이상 걸리는 횟수를 찾고,
+ * 그 횟수로 --repetitions번 실행한 중앙값을 출력한다.
+ *
+ *   ./dbsys_bench                          # 전체
+ *   ./dbsys_bench --filter hash            # 이름에 "hash"가 들어간 것만
+ *   ./dbsys_bench --json bench.json        # 결과를 JSON으로도 기록 (빌드끼리 비교용)
+ */
+
+// ============================================================================
+// 측정 도구
+// ============================================================================
+namespace {
+
+// 컴파일러가 결과를 버리지 못하게 함
+template <typename T>
+inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile char sink;
+    sink = *reinterpret_cast<const volatile char*>(&value);
+#endif
+}
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;
+    double ns_per_op;
+    double bytes_per_op;
+    double allocs_per_op;
+};
+
+class BenchRunner {
+private:
+    double min_time;
+    int repetitions;
+    std::string filter;
+    std::vector<BenchResult> results;
+
+    template <typename Kernel>
+    static double timeRun(Kernel& kernel, uint64_t iterations) {
+        auto start = std::chrono::steady_clock::now();
+        kernel(iterations);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+public:
+    BenchRunner(double min_seconds, int reps, const std::string& name_filter)
+        : min_time(min_seconds), repetitions(std::max(1, reps)), filter(name_filter) {}
+
+    // kernel(n): 연산 n번 실행
+    template <typename Kernel>
+    void run(const std::string& name, Kernel kernel) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) {
+            return;
+        }
+
+        // 한 번 실행이 min_time 이상 걸리는 반복 횟수 찾기 (처음 실행은 예열)
+        uint64_t iterations = 1;
+        timeRun(kernel, iterations);
+        while (true) {
+            double seconds = timeRun(kernel, iterations);
+            if (seconds >= min_time || iterations >= (1ull << 40)) {
+                break;
+            }
+            double scale = seconds > 0 ? min_time / seconds * 1.2 : 100.0;
+            iterations = static_cast<uint64_t>(iterations * std::min(100.0, std::max(2.0, scale)));
+        }
+
+        std::vector<double> ns_per_op;
+        uint64_t allocations = 0, allocated = 0;
+        for (int r = 0; r < repetitions; ++r) {
+            MemoryUsage before = MemoryTracker::processUsage();
+            double seconds = timeRun(kernel, iterations);
+            MemoryUsage after = MemoryTracker::processUsage();
+            ns_per_op.push_back(seconds * 1e9 / iterations);
+            allocations += after.allocations - before.allocations;
+            allocated += after.allocated - before.allocated;
+        }
+        std::sort(ns_per_op.begin(), ns_per_op.end());
+
+        BenchResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.ns_per_op = ns_per_op[ns_per_op.size() / 2];
+        double total_ops = static_cast<double>(iterations) * repetitions;
+        result.bytes_per_op = allocated / total_ops;
+        result.allocs_per_op = allocations / total_ops;
+        results.push_back(result);
+
+        std::cout << std::left << std::setw(28) << name << std::right
+                  << std::setw(12) << iterations
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(11) << result.ns_per_op
+                  << std::setw(11) << result.bytes_per_op
+                  << std::setprecision(2)
+                  << std::setw(11) << result.allocs_per_op << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+
+    void writeJson(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            throw std::runtime_error("Cannot open benchmark output file: " + path);
+        }
+        out << "[\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            out << "  {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << r.ns_per_op << ", \"bytes_per_op\": " << r.bytes_per_op
+                << ", \"allocs_per_op\": " << r.allocs_per_op << "}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "]\n";
+    }
+};
+
+// ============================================================================
+// 합성 데이터 (SF 0.01 생성기의 앞부분, 고정 seed)
+// ============================================================================
+const size_t DATA_PARTS = 1024;
+
+struct BenchData {
+    std::vector<PartRecord> parts;
+    std::vector<PartSuppRecord> partsupps;
+    std::vector<Record> part_records;
+    std::vector<Record> partsupp_records;
+
+    BenchData() {
+        TpchGenerator generator(0.01);
+        for (size_t i = 0; i < DATA_PARTS; ++i) {
+            int_t partkey = static_cast<int_t>(i + 1);
+            parts.push_back(generator.makePart(partkey));
+            part_records.push_back(parts.back().toRecord());
+            for (int s = 0; s < 4; ++s) {
+                partsupps.push_back(generator.makePartSupp(partkey, s));
+                partsupp_records.push_back(partsupps.back().toRecord());
+            }
+        }
+    }
+};
+
+// records를 블록 하나에 들어가는 만큼 채움
+void fillBlock(Block& block, const std::vector<Record>& records) {
+    block.clear();
+    for (const auto& record : records) {
+        std::vector<char> bytes = record.serialize();
+        if (!block.append(bytes.data(), bytes.size())) {
+            break;
+        }
+    }
+}
+
+// ============================================================================
+// 벤치마크
+// ============================================================================
+void benchRecords(BenchRunner& runner, const BenchData& data) {
+    const std::vector<Record>& records = data.part_records;
+
+    runner.run("record/serialize", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            std::vector<char> bytes = records[i % records.size()].serialize();
+            keep(bytes.data());
+        }
+    });
+
+    // 블록과 같은 배치: [record_size(4)][레코드 바이트]
+    std::vector<char> buffer;
+    std::vector<size_t> offsets;
+    for (const auto& record : records) {
+        offsets.push_back(buffer.size());
+        std::vector<char> bytes = record.serialize();
+        uint32_t size = static_cast<uint32_t>(bytes.size());
+        buffer.insert(buffer.end(), reinterpret_cast<const char*>(&size),
+                      reinterpret_cast<const char*>(&size) + sizeof(uint32_t));
+        buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+    }
+    runner.run("record/deserialize", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            size_t offset = offsets[i % offsets.size()];
+            Record record = Record::deserialize(buffer.data(), offset);
+            keep(record.getFieldCount());
+        }
+    });
+
+    Block block(DEFAULT_BLOCK_SIZE);
+    fillBlock(block, records);
+    runner.run("record_reader/readNext", [&](uint64_t n) {
+        RecordReader reader(&block);
+        for (uint64_t i = 0; i < n; ++i) {
+            if (!reader.hasNext()) {
+                reader.reset();
+            }
+            Record record = reader.readNext();
+            keep(record.getFieldCount());
+        }
+    });
+    runner.run("record_reader/readNextView", [&](uint64_t n) {
+        RecordReader reader(&block);
+        for (uint64_t i = 0; i < n; ++i) {
+            if (!reader.hasNext()) {
+                reader.reset();
+            }
+            RecordView view = reader.readNextView();
+            keep(view.getFieldCount());
+        }
+    });
+
+    runner.run("part/fromRecord", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            PartRecord part = PartRecord::fromRecord(records[i % records.size()]);
+            keep(part.partkey);
+        }
+    });
+    runner.run("partsupp/fromRecord", [&](uint64_t n) {
+        const std::vector<Record>& inner = data.partsupp_records;
+        for (uint64_t i = 0; i < n; ++i) {
+            PartSuppRecord partsupp = PartSuppRecord::fromRecord(inner[i % inner.size()]);
+            keep(partsupp.partkey);
+        }
+    });
+}
+
+void benchBlocks(BenchRunner& runner, const BenchData& data) {
+    std::vector<std::vector<char>> serialized;
+    for (const auto& record : data.part_records) {
+        serialized.push_back(record.serialize());
+    }
+
+    // 가득 차면 비우고 계속 (비우는 비용은 레코드 수로 나눠짐)
+    Block block(DEFAULT_BLOCK_SIZE);
+    runner.run("block/append", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            const std::vector<char>& bytes = serialized[i % serialized.size()];
+            if (!block.append(bytes.data(), bytes.size())) {
+                block.clear();
+                block.append(bytes.data(), bytes.size());
+            }
+        }
+        keep(block.getUsedSize());
+    });
+
+    runner.run("block/clear", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            block.setUsedSize(block.getSize());
+            block.clear();
+            keep(block.getData()[0]);
+        }
+    });
+}
+
+void benchHashJoin(BenchRunner& runner, const BenchData& data) {
+    // HashJoin과 같은 구조: partkey → PART 레코드 목록
+    typedef std::unordered_map<int_t, std::vector<PartRecord>> PartTable;
+
+    PartTable build_table;
+    runner.run("hash/build", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            const PartRecord& part = data.parts[i % data.parts.size()];
+            if (i % data.parts.size() == 0) {
+                PartTable().swap(build_table);
+            }
+            build_table[part.partkey].push_back(part);
+        }
+        keep(build_table.size());
+    });
+
+    PartTable table;
+    for (const auto& part : data.parts) {
+        table[part.partkey].push_back(part);
+    }
+    Block output(DEFAULT_BLOCK_SIZE);
+    RecordBuilder builder(&output);
+    runner.run("hash/probe", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            const PartSuppRecord& partsupp = data.partsupps[i % data.partsupps.size()];
+            auto it = table.find(partsupp.partkey);
+            if (it == table.end()) {
+                continue;
+            }
+            for (const auto& part : it->second) {
+                if (!JoinResultRecord::encode(builder, part, partsupp)) {
+                    output.clear();
+                    JoinResultRecord::encode(builder, part, partsupp);
+                }
+            }
+        }
+        keep(output.getUsedSize());
+    });
+
+    runner.run("join_result/encode", [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            const PartSuppRecord& partsupp = data.partsupps[i % data.partsupps.size()];
+            const PartRecord& part = data.parts[(partsupp.partkey - 1) % data.parts.size()];
+            if (!JoinResultRecord::encode(builder, part, partsupp)) {
+                output.clear();
+                JoinResultRecord::encode(builder, part, partsupp);
+            }
+        }
+        keep(output.getUsedSize());
+    });
+}
+
+void benchNestedLoops(BenchRunner& runner, const BenchData& data) {
+    // BNLJ 안쪽 루프: outer 레코드 × inner 블록의 레코드 쌍마다 파싱, 키 비교, 일치하면 인코딩
+    // (BlockNestedLoopsJoin::joinPartAndPartSupp의 joinInnerBlock과 같은 연산). 연산 하나 = 쌍 하나
+    std::vector<Record> outer(data.part_records.begin(), data.part_records.begin() + 64);
+    Block inner_block(DEFAULT_BLOCK_SIZE);
+    fillBlock(inner_block, data.partsupp_records);
+    std::vector<Record> inner;
+    RecordReader reader(&inner_block);
+    while (reader.hasNext()) {
+        inner.push_back(reader.readNext());
+    }
+
+    Block output(DEFAULT_BLOCK_SIZE);
+    RecordBuilder builder(&output);
+    runner.run("bnlj/inner_loop", [&](uint64_t n) {
+        uint64_t done = 0;
+        while (done < n) {
+            for (size_t o = 0; o < outer.size() && done < n; ++o) {
+                for (size_t r = 0; r < inner.size() && done < n; ++r, ++done) {
+                    PartRecord part = PartRecord::fromRecord(outer[o]);
+                    PartSuppRecord partsupp = PartSuppRecord::fromRecord(inner[r]);
+                    if (part.partkey == partsupp.partkey &&
+                        !JoinResultRecord::encode(builder, part, partsupp)) {
+                        output.clear();
+                        JoinResultRecord::encode(builder, part, partsupp);
+                    }
+                }
+            }
+        }
+        keep(output.getUsedSize());
+    });
+}
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [OPTION]...\n\n";
+    std::cout << "  --filter TEXT        Run only benchmarks whose name contains TEXT\n";
+    std::cout << "  --min-time SEC       Minimum time of one measured run (default: 0.2)\n";
+    std::cout << "  --repetitions NUM    Measured runs per benchmark, median reported (default: 5)\n";
+    std::cout << "  --json FILE          Also write the results as JSON\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        double min_time = 0.2;
+        int repetitions = 5;
+        std::string filter, json_file;
+
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--filter" && i + 1 < argc) {
+                filter = argv[++i];
+            } else if (arg == "--min-time" && i + 1 < argc) {
+                min_time = std::atof(argv[++i]);
+            } else if (arg == "--repetitions" && i + 1 < argc) {
+                repetitions = std::atoi(argv[++i]);
+            } else if (arg == "--json" && i + 1 < argc) {
+                json_file = argv[++i];
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return 0;
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+
+        BenchData data;
+        BenchRunner runner(min_time, repetitions, filter);
+
+        std::cout << "Microbenchmarks (min time " << min_time << " s, median of "
+                  << repetitions << " runs)\n" << std::endl;
+        std::cout << std::left << std::setw(28) << "benchmark" << std::right
+                  << std::setw(12) << "iterations" << std::setw(11) << "ns/op"
+                  << std::setw(11) << "bytes/op" << std::setw(11) << "allocs/op" << std::endl;
+
+        benchRecords(runner, data);
+        benchBlocks(runner, data);
+        benchHashJoin(runner, data);
+        benchNestedLoops(runner, data);
+
+        if (!json_file.empty()) {
+            runner.writeJson(json_file);
+            std::cout << "\nResults written to " << json_file << std::endl;
+        }
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "common.h"
+#include "result_sink.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * ============================================================================
+ * 조인 벤치마크 (--benchmark)
+ * ============================================================================
+ *
+ * 알고리즘 × 버퍼 크기 × 블록 크기의 모든 조합을 예열 실행 후 여러 번 반복해
+ * 시간의 중앙값/p95, I/O, 메모리를 모은다. 결과를 CSV/JSON으로 저장해 빌드끼리 비교하는 용도.
+ *
+ * 입력은 기존 블록 파일(블록 크기는 파일 헤더 값 하나)이거나, scale_factor가 주어지면
+ * 블록 크기마다 고정 seed로 생성한 PART / PARTSUPP 파일이다 (같은 설정이면 같은 데이터).
+ *
+ * 알고리즘
+ *   bnlj, hash, auto : 조인 계획기로 실행 (--join --algorithm과 같은 경로, outer/build = 첫 테이블)
+ * MultithreadedJoin은 아직 단일 스레드 BNLJ로 실행되므로 스레드 수 축은 두지 않는다
+ * (병렬 조인이 생기면 추가).
+ *
+ * 반복 사이 페이지 캐시 비우기(drop_caches)는 /proc/sys/vm/drop_caches를 쓸 수 있으면 그것으로,
+ * 아니면 입력/출력 파일마다 posix_fadvise(DONTNEED)로 한다 (Linux 전용).
+ */
+
+struct BenchmarkConfig {
+    // 입력 (scale_factor > 0이면 생성, 아니면 파일 사용)
+    std::string outer_table;
+    std::string outer_type;
+    std::string inner_table;
+    std::string inner_type;
+    double scale_factor;
+    uint64_t seed;
+    std::string output_file;       // 조인 결과 (실행마다 덮어씀), 생성 데이터도 이 이름 옆에 둠
+    SinkMode sink;                 // 결과 출력 대상 (checksum이면 조합별 체크섬도 보고)
+
+    // 조합 축
+    std::vector<std::string> algorithms;
+    std::vector<size_t> buffer_sizes;
+    std::vector<size_t> block_sizes;
+
+    size_t warmups;
+    size_t repetitions;
+    bool drop_caches;
+
+    BenchmarkConfig()
+        : scale_factor(0), seed(0), sink(SinkMode::FILE), warmups(1), repetitions(5),
+          drop_caches(false) {}
+};
+
+// 조합 하나의 결과
+struct BenchmarkResult {
+    std::string algorithm;
+    size_t buffer_size;
+    size_t block_size;
+
+    std::vector<double> times;     // 측정한 반복의 elapsed_time (실행 순서)
+    double median_time;
+    double p95_time;
+    double min_time;
+
+    Statistics stats;              // 마지막 반복의 I/O/출력 통계
+    size_t tracked_memory_peak;    // 반복 중 최대값
+
+    BenchmarkResult()
+        : buffer_size(0), block_size(0), median_time(0), p95_time(0), min_time(0),
+          tracked_memory_peak(0) {}
+};
+
+class BenchmarkRunner {
+private:
+    BenchmarkConfig config;
+    std::vector<BenchmarkResult> results;
+    bool global_drop;              // /proc/sys/vm/drop_caches 사용 가능
+
+    // 블록 크기별 입력 파일 준비 (생성 또는 기존 파일 검증)
+    void prepareInputs(size_t block_size, std::string& outer, std::string& inner);
+
+    // 조합 하나를 한 번 실행하고 통계 반환
+    Statistics runOnce(const std::string& algorithm, const std::string& outer,
+                       const std::string& inner, size_t buffer_size, size_t block_size) const;
+
+    void dropCaches(const std::string& outer, const std::string& inner) const;
+
+public:
+    explicit BenchmarkRunner(const BenchmarkConfig& cfg);
+
+    // 모든 조합 실행 (진행 상황은 out에 한 줄씩)
+    void run(std::ostream& out);
+
+    const std::vector<BenchmarkResult>& getResults() const { return results; }
+
+    // 결과 표
+    void print(std::ostream& out) const;
+
+    // 조합마다 한 행 / 설정 + 조합별 결과 (path가 "-"면 표준 출력)
+    void writeCsv(const std::string& path) const;
+    void writeJson(const std::string& path) const;
+};
+
+// 쉼표로 구분한 목록 파싱 ("5,10,20")
+std::vector<std::string> splitList(const std::string& text);
+std::vector<size_t> parseSizeList(const std::string& text);
+
+#endif // BENCHMARK_H
@@ -5,16 +5,178 @@
 #include "block.h"
 #include <vector>
 #include <memory>
+#include <string>
+#include <functional>
+#include <unordered_map>
 
+/**
+ * ============================================================================
+ * 버퍼 풀
+ * ============================================================================
+ *
+ * 프레임은 두 종류로 나뉜다.
+ *   - 작업 버퍼 (getBuffer(idx)): 조인이 인덱스로 직접 쓰는 고정 프레임 (기존 방식)
+ *   - 페이지 캐시 프레임: (파일, 페이지 번호) → 프레임 페이지 테이블로 관리
+ *
+ * 페이지 캐시는 fetchPage()로 페이지를 고정(pin)해 돌려주고, unpinPage()에서
+ * 고정 횟수를 줄이며 수정 여부(dirty)를 기록한다. 고정되지 않은 프레임만
+ * 교체 정책이 내보낼 수 있고, dirty 페이지는 내보내기 전에 파일별 쓰기 함수로 기록한다.
+ *
+ * 교체 정책:
+ *   CLOCK  - 참조 비트를 쓰는 2차 기회 알고리즘 (일반 용도)
+ *   LRU_K  - 최근 K(=2)번째 접근 시각이 가장 오래된 페이지 (접근이 K번 미만이면 우선)
+ *   MRU    - 가장 최근에 쓴 페이지 (반복 순차 스캔에서 앞부분 페이지를 남김)
+ *
+ * TableReader에 setBufferPool()로 연결하면 블록 읽기가 페이지 캐시를 거치고,
+ * 적중/미스가 Statistics에 기록된다.
+ */
+
+enum class ReplacementPolicy {
+    CLOCK,
+    LRU_K,
+    MRU
+};
+
+// "clock" / "lru-k" / "mru" 파싱 (모르는 이름이면 예외)
+ReplacementPolicy parseReplacementPolicy(const std::string& name);
+const char* replacementPolicyName(ReplacementPolicy policy);
+
+// LRU-K의 K
+#define LRU_K_HISTORY 2
+
+// ============================================================================
+// 교체 정책 (프레임 번호 단위)
+// ============================================================================
+class Replacer {
+public:
+    virtual ~Replacer() {}
+
+    // 프레임 접근 기록
+    virtual void recordAccess(size_t frame) = 0;
+
+    // 내보내기 후보 여부 (pin_count가 0이면 후보)
+    virtual void setEvictable(size_t frame, bool evictable) = 0;
+
+    // 내보낼 프레임 선택 (후보가 없으면 false)
+    virtual bool evict(size_t& frame) = 0;
+
+    // 프레임을 비웠을 때 기록 삭제
+    virtual void remove(size_t frame) = 0;
+};
+
+class ClockReplacer : public Replacer {
+private:
+    std::vector<bool> referenced;
+    std::vector<bool> evictable;
+    size_t hand;
+
+public:
+    explicit ClockReplacer(size_t num_frames);
+
+    void recordAccess(size_t frame) override;
+    void setEvictable(size_t frame, bool value) override;
+    bool evict(size_t& frame) override;
+    void remove(size_t frame) override;
+};
+
+class LruKReplacer : public Replacer {
+private:
+    std::vector<std::vector<uint64_t>> history;   // 프레임별 최근 K개 접근 시각
+    std::vector<bool> evictable;
+    size_t k;
+    uint64_t clock;
+
+public:
+    LruKReplacer(size_t num_frames, size_t history_k = LRU_K_HISTORY);
+
+    void recordAccess(size_t frame) override;
+    void setEvictable(size_t frame, bool value) override;
+    bool evict(size_t& frame) override;
+    void remove(size_t frame) override;
+};
+
+class MruReplacer : public Replacer {
+private:
+    std::vector<uint64_t> last_access;
+    std::vector<bool> evictable;
+    uint64_t clock;
+
+public:
+    explicit MruReplacer(size_t num_frames);
+
+    void recordAccess(size_t frame) override;
+    void setEvictable(size_t frame, bool value) override;
+    bool evict(size_t& frame) override;
+    void remove(size_t frame) override;
+};
+
+// ============================================================================
 // 버퍼 풀 관리자
+// ============================================================================
 class BufferManager {
+public:
+    // 미스 시 페이지를 frame으로 읽음 (페이지가 없으면 false)
+    using PageLoader = std::function<bool(Block* frame)>;
+
+    // dirty 페이지를 파일에 기록
+    using PageWriter = std::function<void(uint64_t page_no, const Block& frame)>;
+
 private:
-    std::vector<std::unique_ptr<Block>> buffers;
-    size_t buffer_count;
+    struct PageId {
+        uint32_t file_id;
+        uint64_t page_no;
+
+        bool operator==(const PageId& other) const {
+            return file_id == other.file_id && page_no == other.page_no;
+        }
+    };
+
+    struct PageIdHash {
+        size_t operator()(const PageId& id) const {
+            return std::hash<uint64_t>()(id.page_no * 1000003u + id.file_id);
+        }
+    };
+
+    struct FrameInfo {
+        PageId page;
+        size_t pin_count;
+        bool dirty;
+        bool in_use;
+    };
+
+    std::vector<std::unique_ptr<Block>> buffers;   // 작업 버퍼 + 페이지 캐시 프레임
+    size_t buffer_count;                           // 작업 버퍼 개수
     size_t block_size;
 
+    // 페이지 캐시 상태 (프레임 번호는 buffer_count부터)
+    ReplacementPolicy policy;
+    std::unique_ptr<Replacer> replacer;            // 캐시 프레임 번호(0부터) 단위
+    std::vector<FrameInfo> frames;
+    std::vector<size_t> free_frames;
+    std::unordered_map<PageId, size_t, PageIdHash> page_table;
+
+    // 파일 등록 정보
+    std::unordered_map<std::string, uint32_t> file_ids;
+    std::vector<PageWriter> page_writers;
+
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t write_backs;
+
+    Block* frameBlock(size_t frame) { return buffers[buffer_count + frame].get(); }
+
+    // 빈 프레임 확보 (모두 고정되어 있으면 false)
+    bool allocateFrame(size_t& frame);
+
+    // dirty 프레임 기록
+    void writeBack(size_t frame);
+
 public:
-    BufferManager(size_t num_buffers, size_t blk_size = DEFAULT_BLOCK_SIZE);
+    // num_buffers개의 작업 버퍼와 cache_frames개의 페이지 캐시 프레임
+    BufferManager(size_t num_buffers, size_t blk_size = DEFAULT_BLOCK_SIZE,
+                  size_t cache_frames = 0,
+                  ReplacementPolicy replacement = ReplacementPolicy::CLOCK);
 
     // 버퍼 접근
     Block* getBuffer(size_t idx);
@@ -26,10 +188,39 @@ public:
     // 모든 버퍼 초기화
     void clearAll();
 
-    // 메모리 사용량 계산
+    // 메모리 사용량 계산 (작업 버퍼 + 페이지 캐시)
     size_t getMemoryUsage() const {
-        return buffer_count * block_size;
+        return buffers.size() * block_size;
     }
+
+    // 프레임 하나가 쓰는 메모리 (블록 데이터 + Block 객체와 포인터 + 페이지 캐시 메타데이터:
+    // 프레임 정보, 빈 프레임 번호, 페이지 테이블 노드와 버킷, 교체 정책 기록). 메모리 예약용 상한
+    static size_t frameBytes(size_t blk_size);
+
+    // ========== 페이지 캐시 ==========
+
+    // 파일 등록 (같은 파일은 같은 id). writer가 있으면 dirty 페이지를 기록할 수 있음
+    uint32_t registerFile(const std::string& filename, PageWriter writer = nullptr);
+
+    // 페이지를 고정해 반환. 없으면 loader로 읽음
+    // (페이지가 없거나 모든 프레임이 고정되어 있으면 nullptr)
+    Block* fetchPage(uint32_t file_id, uint64_t page_no, const PageLoader& loader);
+
+    // 고정 해제 (dirty면 내보낼 때 기록)
+    void unpinPage(uint32_t file_id, uint64_t page_no, bool dirty = false);
+
+    // dirty 페이지 모두 기록
+    void flushAll();
+
+    // 파일의 캐시 페이지 버리기 (고정된 페이지가 있으면 예외)
+    void invalidateFile(uint32_t file_id);
+
+    size_t getCacheFrameCount() const { return frames.size(); }
+    ReplacementPolicy getPolicy() const { return policy; }
+    size_t getHits() const { return hits; }
+    size_t getMisses() const { return misses; }
+    size_t getEvictions() const { return evictions; }
+    size_t getWriteBacks() const { return write_backs; }
 };
 
 #endif // BUFFER_H
@@ -14,16 +14,44 @@ typedef int32_t int_t;
 typedef uint32_t uint_t;
 typedef float decimal_t;
 
+// 컬럼 타입 (PAX 페이지 및 스키마 기술용)
+enum class ColumnType : uint8_t {
+    INT = 0,       // int_t
+    DECIMAL = 1,   // decimal_t
+    STRING = 2     // 가변 길이 문자열
+};
+
+// 단계별 시간 개수 (phase_timer.h의 TimerPhase: read, decode, compare, encode, write)
+#define STAT_PHASE_COUNT 5
+
+// 하드웨어 카운터 개수 (perf_counters.h의 PerfEvent: cycles, instructions, LLC/분기/dTLB 미스)
+#define STAT_PERF_EVENT_COUNT 5
+
 // 성능 측정을 위한 통계
 struct Statistics {
-    size_t block_reads;
-    size_t block_writes;
+    size_t block_reads;             // 논리 블록 (페이지) 읽기
+    size_t block_writes;            // 논리 블록 (페이지) 쓰기
+    size_t physical_block_reads;    // 디스크에서 읽은 block_size 단위 블록 (압축 시 더 적음)
+    size_t physical_block_writes;   // 디스크에 쓴 block_size 단위 블록
+    size_t blocks_skipped;          // 존 맵으로 읽지 않고 건너뛴 블록
+    size_t buffer_hits;             // 버퍼 풀 페이지 캐시 적중 (디스크 읽기 없음)
+    size_t buffer_misses;           // 버퍼 풀 미스 (디스크에서 읽음)
     size_t output_records;
     double elapsed_time;
-    size_t memory_usage;
+    size_t memory_usage;            // 예약/계산한 작업 메모리 (버퍼, 해시 테이블)
+    size_t tracked_memory_peak;     // 추적 할당기로 잰 연산자 최대 힙 사용량 (memory_tracker.h)
+    uint64_t phase_ticks[STAT_PHASE_COUNT];  // 단계별 누적 틱 (phase_timer.h)
+    uint64_t perf_counts[STAT_PERF_EVENT_COUNT];  // 하드웨어 카운터 합계 (perf_counters.h)
+    uint32_t perf_valid;            // perf_counts 중 측정한 이벤트 (비트 i = PerfEvent i)
+    uint64_t result_checksum;       // 결과 행 해시의 합 (--sink checksum, result_sink.h)
+    bool has_checksum;
 
-    Statistics() : block_reads(0), block_writes(0), output_records(0),
-                   elapsed_time(0.0), memory_usage(0) {}
+    Statistics() : block_reads(0), block_writes(0),
+                   physical_block_reads(0), physical_block_writes(0), blocks_skipped(0),
+                   buffer_hits(0), buffer_misses(0),
+                   output_records(0), elapsed_time(0.0), memory_usage(0),
+                   tracked_memory_peak(0), phase_ticks(),
+                   perf_counts(), perf_valid(0), result_checksum(0), has_checksum(false) {}
 };
 
 #endif // COMMON_H
@@ -0,0 +1,65 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include "common.h"
+#include <vector>
+#include <cstddef>
+
+/**
+ * ============================================================================
+ * 페이지 압축 코덱
+ * ============================================================================
+ *
+ * 블록 파일을 압축 모드로 쓰면 각 블록(논리 페이지)을 아래 코덱 중 가장 작게
+ * 줄어드는 것으로 압축해 프레임으로 연달아 기록한다. 읽을 때는 block_size 단위의
+ * 물리 블록을 읽어 프레임을 복원하므로, 물리 블록 수가 논리 블록 수보다 적다.
+ *
+ * 코덱:
+ *   NONE     - 압축하지 않음 (압축 결과가 더 클 때)
+ *   LZ       - LZ4 계열 바이트 단위 LZ77 (리터럴 + 4바이트 이상 매치)
+ *   RLE      - PackBits 형식 런 길이 인코딩 (빈 공간 0 채움에 유리)
+ *   DELTA_LZ - 4바이트 워드 델타 변환 후 LZ
+ *              (PAX 페이지의 정렬된 정수 키 배열 → 작은 상수 델타)
+ *
+ * 압축 파일 형식:
+ *   [magic 'DBZ1' (4B)][logical block size (4B)]
+ *   [frame]...  - [compressed_size (4B)][raw_size (4B)][codec (1B)][payload]
+ */
+
+// 압축 블록 파일 식별자 ('D','B','Z','1' little-endian)
+#define COMPRESSED_FILE_MAGIC 0x315A4244u
+
+// 압축 파일 헤더 크기: magic + logical block size
+#define COMPRESSED_FILE_HEADER_SIZE 8
+
+// 프레임 헤더 크기: compressed_size + raw_size + codec
+#define COMPRESSED_FRAME_HEADER_SIZE 9
+
+enum class CompressionCodec : uint8_t {
+    NONE = 0,
+    LZ = 1,
+    RLE = 2,
+    DELTA_LZ = 3
+};
+
+// 코덱 이름 (통계 출력용)
+const char* getCodecName(CompressionCodec codec);
+
+// 개별 코덱 (out에 덧붙이지 않고 덮어씀)
+void lzCompress(const char* src, size_t size, std::vector<char>& out);
+void lzDecompress(const char* src, size_t size, char* dst, size_t raw_size);
+
+void rleCompress(const char* src, size_t size, std::vector<char>& out);
+void rleDecompress(const char* src, size_t size, char* dst, size_t raw_size);
+
+void deltaLzCompress(const char* src, size_t size, std::vector<char>& out);
+void deltaLzDecompress(const char* src, size_t size, char* dst, size_t raw_size);
+
+// 페이지를 가장 작게 압축하는 코덱을 골라 out에 기록하고 코덱 반환
+CompressionCodec compressPage(const char* page, size_t size, std::vector<char>& out);
+
+// 압축된 페이지를 dst (raw_size 바이트)로 복원
+void decompressPage(CompressionCodec codec, const char* src, size_t size,
+                    char* dst, size_t raw_size);
+
+#endif // COMPRESSION_H
@@ -0,0 +1,83 @@
+#ifndef CSV_LOADER_H
+#define CSV_LOADER_H
+
+#include "common.h"
+#include "record.h"
+#include "table.h"
+#include <string>
+#include <vector>
+#include <memory>
+
+class PartDictionary;
+
+/**
+ * ============================================================================
+ * 멀티스레드 CSV(.tbl) 로더
+ * ============================================================================
+ *
+ * 파일을 큰 청크 단위로 읽고, 청크를 줄바꿈 경계에 맞춰 스레드 수만큼 나눈다.
+ * 각 스레드는 '|' 토크나이저와 직접 구현한 숫자 파서로 레코드를 파싱해
+ * 자기 전용 스테이징 블록에 인코딩하고, 메인 스레드가 스레드 순서대로
+ * 레코드를 출력 블록에 이어 붙여 TableWriter로 기록한다.
+ *
+ * 블록 채우기 규칙이 단일 스레드 변환과 같으므로 출력 파일은 스레드 수와
+ * 관계없이 동일하다. 딕셔너리 인코딩은 코드 할당 순서를 유지하기 위해
+ * 파싱만 병렬로 하고 인코딩은 메인 스레드에서 순서대로 한다.
+ *
+ * 사용 예:
+ *   TableWriter writer("part.dat");
+ *   CsvLoader loader("PART", 4096);
+ *   size_t count = loader.load("part.tbl", writer);
+ */
+
+// 기본 청크 크기 (바이트)
+#define CSV_DEFAULT_CHUNK_SIZE (32u * 1024u * 1024u)
+
+// 숫자 필드 파싱 - std::stoi / std::stof와 같은 값 (앞뒤 공백 허용, 실패 시 false)
+bool parseCsvInt(const char* begin, const char* end, int_t& value);
+bool parseCsvDecimal(const char* begin, const char* end, decimal_t& value);
+
+class CsvLoader {
+private:
+    std::string table_type;
+    size_t block_size;
+    RecordEncoding encoding;
+    size_t num_threads;
+    size_t chunk_size;
+    PartDictionary* dict;
+    size_t error_count;
+
+    // 스레드 하나가 파싱한 결과
+    struct ChunkResult {
+        RecordStaging staged;                      // 인코딩된 레코드
+        std::vector<PartRecord> parts;             // 딕셔너리 모드: 파싱된 레코드
+        std::vector<std::string> errors;
+
+        ChunkResult(size_t blk_size, RecordEncoding enc) : staged(blk_size, enc) {}
+    };
+
+    // [begin, end) 범위의 줄들을 파싱
+    void parseRange(const char* begin, const char* end, ChunkResult& result) const;
+
+    // 파싱 결과를 출력 블록에 이어 붙이고 가득 찬 블록을 기록. 추가된 레코드 수 반환
+    size_t appendResult(ChunkResult& result, Block& block, RecordBuilder& builder,
+                        TableWriter& writer);
+
+public:
+    CsvLoader(const std::string& type, size_t blk_size = DEFAULT_BLOCK_SIZE,
+              RecordEncoding enc = RecordEncoding::LENGTH_PREFIXED, size_t threads = 0);
+
+    // 딕셔너리 인코딩 사용 (PART만)
+    void setDictionary(PartDictionary* dictionary) { dict = dictionary; }
+
+    // 한 번에 읽을 청크 크기
+    void setChunkSize(size_t bytes) { chunk_size = bytes; }
+
+    // CSV 파일을 읽어 writer에 블록으로 기록. 변환된 레코드 개수 반환
+    size_t load(const std::string& csv_file, TableWriter& writer);
+
+    size_t getThreadCount() const { return num_threads; }
+    size_t getErrorCount() const { return error_count; }
+};
+
+#endif // CSV_LOADER_H
@@ -0,0 +1,132 @@
+#ifndef DELTA_JOIN_H
+#define DELTA_JOIN_H
+
+#include "common.h"
+#include "table.h"
+#include "dictionary.h"
+#include "memory_governor.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+/**
+ * ============================================================================
+ * 증분(델타) 조인 유지
+ * ============================================================================
+ *
+ * PART ⋈ PARTSUPP 결과 파일을 입력 테이블에 추가된 행만큼만 갱신한다.
+ *
+ * 결과 순서는 해시 조인과 같은 probe 순서로 정의한다:
+ *   PARTSUPP 파일 순서대로, 각 행에 맞는 PART 행을 PART 파일 순서대로 출력
+ * 이 순서에서는 PARTSUPP에 추가된 행의 결과가 항상 기존 결과 뒤에 오므로
+ * 이전 결과에 이어 쓰면 전체 재계산과 바이트 단위로 같은 파일이 된다.
+ *
+ * 실행마다 결과 파일 옆에 워터마크(<output>.wm)를 남긴다.
+ * 워터마크는 입력별로 마지막으로 처리한 블록 번호와 그 블록 안의 레코드 수,
+ * 파일 헤더의 write_id, 내용 지문, 결과 레코드 수를 담는다. 다음 실행에서는
+ *   1. 워터마크 이후의 PARTSUPP 행을 읽어 키 집합을 만들고
+ *   2. PART 존 맵으로 그 키를 포함하는 블록만 읽어 해시 테이블을 만든 뒤
+ *   3. 새 PARTSUPP 행을 probe해 결과 파일에 추가 쓰기 한다.
+ * 새 PART 행이 이미 처리한 PARTSUPP 행과 맞으면 결과 중간에 끼워야 하므로
+ * (존 맵으로 후보 블록만 확인) 전체 재계산으로 바꾼다.
+ * 워터마크가 없거나 입력/결과 파일이 워터마크와 맞지 않아도 전체 재계산한다.
+ * 다시 쓴 입력은 write_id로 잡는다: TableWriter가 새로 쓸 때마다 새 값을 헤더에 넣고
+ * 추가 쓰기에서는 유지하므로, 개수가 같고 가운데 블록만 바뀐 경우도 달라진다.
+ * 지문은 처리한 첫 블록과 마지막 블록(처리한 레코드까지)의 해시로 함께 확인하고,
+ * write_id가 없는 이전 파일은 처리한 블록 전체를 해시한다.
+ *
+ * 비용은 새 행 수 + 새 키를 포함하는 PART 블록 수에 비례한다
+ * (정렬된 PART 파일이면 새 키 범위의 블록 몇 개).
+ *
+ * 조회용 해시 테이블은 메모리 예약(--memory-limit) 안에서만 키우고,
+ * 넘치면 결과를 건드리기 전에 예외로 멈춘다 (델타는 보통 작아 나눠 쓰지 않음).
+ *
+ * 워터마크 형식:
+ *   [magic 'DJWM' (4B)][version (4B)]
+ *   [PART: block_count (8B)][record_count (8B)][tail_records (8B)][write_id (8B)][fingerprint (8B)]
+ *   [PARTSUPP: block_count (8B)][record_count (8B)][tail_records (8B)][write_id (8B)][fingerprint (8B)]
+ *   [output_records (8B)]
+ */
+
+// 워터마크 파일 식별자 ('D','J','W','M' little-endian)
+#define JOIN_WATERMARK_MAGIC 0x4D574A44u
+#define JOIN_WATERMARK_VERSION 3
+
+// 입력 테이블 하나에서 처리한 위치
+struct TableWatermark {
+    uint64_t block_count;    // 읽은 블록 수
+    uint64_t record_count;   // 읽은 레코드 수
+    uint64_t tail_records;   // 마지막 블록 안의 레코드 수 (추가 쓰기로 채워질 수 있음)
+    uint64_t write_id;       // 입력 파일 헤더의 write_id (다시 쓴 입력 감지, 헤더 없으면 0)
+    uint64_t fingerprint;    // 처리한 블록 내용의 해시 (write_id가 없으면 전체 블록)
+
+    TableWatermark()
+        : block_count(0), record_count(0), tail_records(0), write_id(0), fingerprint(0) {}
+};
+
+struct JoinWatermark {
+    TableWatermark part;
+    TableWatermark partsupp;
+    uint64_t output_records;
+
+    JoinWatermark() : output_records(0) {}
+
+    static std::string sidecarPath(const std::string& output_file) { return output_file + ".wm"; }
+
+    void save(const std::string& output_file) const;
+    static bool loadIfExists(const std::string& output_file, JoinWatermark& watermark);
+};
+
+class DeltaJoin {
+private:
+    std::string part_table_file;
+    std::string partsupp_table_file;
+    std::string output_file;
+    size_t block_size;
+    Statistics stats;
+
+    // PART 파일이 딕셔너리 인코딩된 경우 코드 복원용
+    std::unique_ptr<PartDictionary> part_dict;
+
+    // 조회용 해시 테이블: PARTKEY → PART 레코드 (파일 순서)
+    std::unordered_map<int_t, std::vector<PartRecord>> part_table;
+
+    // 메모리 예약 (execute() 동안 유지)
+    std::unique_ptr<MemoryGrant> grant;
+    size_t table_bytes;
+
+    bool full_recompute;
+    uint64_t delta_records;   // 이번 실행에서 probe한 PARTSUPP 행 수
+
+    // 워터마크를 이어서 쓸 수 있는지 확인 (아니면 reason에 이유)
+    bool canApplyDelta(const JoinWatermark& watermark, std::string& reason);
+
+    // mark까지 처리한 블록(마지막 블록은 tail_records까지)의 내용 해시
+    // write_id가 있으면 첫 블록과 마지막 블록만, 없으면 모든 블록을 해시
+    uint64_t fingerprint(const std::string& table_file, const TableWatermark& mark);
+
+    // 새 PART 키가 워터마크 이전 PARTSUPP 행과 맞는지 (존 맵으로 후보 블록만 읽음)
+    bool matchesProcessedRows(const std::vector<int_t>& part_keys,
+                              const TableWatermark& partsupp_mark);
+
+    // keys에 있는 PART 행을 해시 테이블에 로드 (존 맵으로 후보 블록만 읽음)
+    void loadParts(const std::vector<int_t>& keys);
+
+    // from 이후의 행을 조인해 결과에 쓰고 새 워터마크 반환
+    JoinWatermark run(const JoinWatermark& from, bool append);
+
+public:
+    DeltaJoin(const std::string& part_file,
+              const std::string& partsupp_file,
+              const std::string& out_file,
+              size_t blk_size = DEFAULT_BLOCK_SIZE);
+
+    void execute();
+    const Statistics& getStatistics() const { return stats; }
+
+    // 마지막 실행이 전체 재계산이었는지
+    bool wasFullRecompute() const { return full_recompute; }
+};
+
+#endif // DELTA_JOIN_H
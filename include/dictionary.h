@@ -0,0 +1,121 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include "common.h"
+#include "record.h"
+#include "table.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+
+/**
+ * ============================================================================
+ * 딕셔너리 인코딩 (PART 저카디널리티 문자열 컬럼)
+ * ============================================================================
+ *
+ * mfgr(5종), brand(25종), type(150종), container(40종)은 값의 종류가 적으므로
+ * 파일 단위 딕셔너리에 문자열을 한 번만 저장하고 레코드에는 2바이트 코드만 기록한다.
+ *
+ * - 딕셔너리는 블록 파일 옆 사이드카 파일(<block_file>.dict)에 저장
+ * - 인코딩된 필드: uint16 코드 (2바이트, little-endian)
+ * - 술어(brand = 'Brand#23')는 값을 코드로 한 번 변환한 뒤 2바이트 비교로 평가
+ *
+ * 사이드카 형식:
+ *   [magic 'DICT' (4B)][column_count (2B)]
+ *   반복: [column_index (2B)][value_count (2B)] + 반복: [len (2B)][bytes]
+ */
+
+// 사이드카 파일 식별자 ('D','I','C','T' little-endian)
+#define DICTIONARY_MAGIC 0x54434944u
+
+// 단일 컬럼 딕셔너리 (값 ↔ 코드)
+class ColumnDictionary {
+private:
+    std::vector<std::string> values;
+    std::unordered_map<std::string, uint16_t> codes;
+
+public:
+    // 값의 코드 반환 (없으면 새 코드 할당)
+    uint16_t encode(const std::string& value);
+
+    // 값의 코드 조회 (없으면 false)
+    bool lookup(const std::string& value, uint16_t& code) const;
+
+    // 코드의 값 반환
+    const std::string& decode(uint16_t code) const;
+
+    size_t size() const { return values.size(); }
+    const std::vector<std::string>& getValues() const { return values; }
+
+    // 값 배열과 코드 해시 테이블이 쓰는 메모리 (메모리 예산 추적용)
+    size_t memoryBytes() const;
+};
+
+// PART 테이블 딕셔너리 (mfgr, brand, type, container)
+class PartDictionary {
+private:
+    // PART 필드 인덱스 → 딕셔너리
+    std::unordered_map<size_t, ColumnDictionary> columns;
+
+public:
+    PartDictionary();
+
+    // 딕셔너리 인코딩 대상 컬럼인지 확인 (PART 필드 인덱스 기준)
+    static bool isEncodedColumn(size_t col);
+
+    ColumnDictionary& getColumn(size_t col);
+    const ColumnDictionary& getColumn(size_t col) const;
+
+    // 모든 컬럼 딕셔너리가 쓰는 메모리
+    size_t memoryBytes() const;
+
+    // 코드 ↔ 필드 바이트 변환
+    static std::string codeToField(uint16_t code);
+    static uint16_t fieldToCode(const char* data, size_t size);
+
+    // 사이드카 파일 경로
+    static std::string sidecarPath(const std::string& block_file) { return block_file + ".dict"; }
+
+    // 사이드카 저장/로드
+    void save(const std::string& block_file) const;
+    static std::unique_ptr<PartDictionary> load(const std::string& block_file);
+
+    // 파일 헤더에 딕셔너리 플래그가 있으면 사이드카 로드, 아니면 nullptr
+    // (인코딩 없이 다시 쓴 파일 옆에 남은 오래된 사이드카는 무시)
+    static std::unique_ptr<PartDictionary> loadIfExists(const std::string& block_file);
+
+    // 사이드카 삭제 (없으면 무시)
+    static void remove(const std::string& block_file);
+};
+
+/**
+ * 등호 술어 (column = value)
+ *
+ * 딕셔너리 인코딩된 컬럼이면 생성 시 값을 코드로 바꾸고 레코드마다 코드만 비교한다.
+ * 딕셔너리에 없는 값이면 어떤 레코드와도 일치하지 않는다.
+ */
+class EqualsPredicate {
+private:
+    size_t column;
+    std::string value;
+    bool use_code;       // 코드 비교 여부
+    bool never_matches;  // 딕셔너리에 없는 값
+    char code_bytes[2];
+
+public:
+    EqualsPredicate(const std::string& table_type,
+                    const std::string& column_name,
+                    const std::string& val,
+                    const PartDictionary* dict);
+
+    bool matches(const RecordView& view) const { return matchesField(view.getField(column)); }
+
+    // 술어 컬럼 값 하나 검사 (PAX 페이지는 PaxPage::getFieldText로 전달)
+    bool matchesField(const FieldRef& field) const;
+
+    size_t getColumn() const { return column; }
+    bool usesDictionary() const { return use_code; }
+};
+
+#endif // DICTIONARY_H
@@ -0,0 +1,86 @@
+#ifndef FILE_HEADER_H
+#define FILE_HEADER_H
+
+#include "common.h"
+#include <string>
+#include <istream>
+
+/**
+ * ============================================================================
+ * 블록 파일 헤더 (테이블 메타데이터 캐시)
+ * ============================================================================
+ *
+ * TableWriter가 파일 맨 앞에 고정 크기 헤더 자리를 잡아 두고, 닫을 때
+ * 레코드/블록 개수, 블록 크기, 테이블 타입, 정렬 여부, 인코딩 정보를 채운다.
+ * 파일 정보 출력이나 옵션 자동 설정은 파일 전체를 스캔하지 않고 헤더만 읽는다.
+ *
+ * 헤더 형식 (FILE_HEADER_SIZE 바이트, 나머지는 0):
+ *   [magic 'DBH1' (4B)][format_version (2B)][header_size (2B)]
+ *   [block_size (4B)][flags (4B)][record_count (8B)][block_count (8B)]
+ *   [record_encoding (1B)][reserved (3B)][table_type (16B, NUL 채움)]
+ *   [write_id (4B)][last_block_offset (8B)]
+ *
+ * 헤더 뒤에는 기존 형식 그대로 블록(또는 압축 파일 헤더 + 프레임)이 이어진다.
+ * 행 블록의 첫 4바이트는 레코드 크기이므로 magic과 겹치지 않고,
+ * 헤더가 없는 이전 파일도 그대로 읽을 수 있다.
+ *
+ * write_id는 새로 쓸 때마다(추가 쓰기 제외) 바뀌는 임의 값으로,
+ * 같은 개수로 다시 쓴 파일을 추가 쓰기와 구분하는 데 쓴다 (델타 조인 워터마크).
+ * 이전 파일에서는 0이다.
+ */
+
+// 파일 헤더 식별자 ('D','B','H','1' little-endian)
+#define FILE_HEADER_MAGIC 0x31484244u
+
+// 헤더 크기 (바이트)
+#define FILE_HEADER_SIZE 64
+
+// 블록/레코드 인코딩 형식 버전
+#define FILE_FORMAT_VERSION 1
+
+// 헤더 플래그
+#define FILE_FLAG_COMPLETE    0x01u   // 정상적으로 닫혀 개수가 유효함
+#define FILE_FLAG_SORTED      0x02u   // partkey 순으로 정렬됨
+#define FILE_FLAG_COMPRESSED  0x04u   // 압축 프레임 파일
+#define FILE_FLAG_PAX         0x08u   // PAX 페이지 레이아웃
+#define FILE_FLAG_DICTIONARY  0x10u   // 딕셔너리 사이드카 사용
+
+// 테이블 타입 필드 크기
+#define FILE_HEADER_TYPE_SIZE 16
+
+struct FileHeader {
+    uint16_t format_version;
+    uint32_t block_size;
+    uint32_t flags;
+    uint64_t record_count;
+    uint64_t block_count;
+    uint8_t record_encoding;     // RecordEncoding 값
+    std::string table_type;
+    uint32_t write_id;           // 새로 쓸 때마다 바뀌는 값 (추가 쓰기는 유지)
+    uint64_t last_block_offset;  // 마지막 블록(압축 파일은 프레임) 위치, 추가 쓰기에 사용
+
+    FileHeader()
+        : format_version(FILE_FORMAT_VERSION), block_size(0), flags(0),
+          record_count(0), block_count(0), record_encoding(0), write_id(0),
+          last_block_offset(0) {}
+
+    bool hasFlag(uint32_t flag) const { return (flags & flag) != 0; }
+    bool isComplete() const { return hasFlag(FILE_FLAG_COMPLETE); }
+
+    // FILE_HEADER_SIZE 바이트 버퍼로 직렬화
+    void serialize(char* buf) const;
+
+    // 버퍼에서 역직렬화 (magic이 다르면 false)
+    static bool deserialize(const char* buf, size_t size, FileHeader& header);
+};
+
+// 새 write_id 생성 (0은 "없음"이라 쓰지 않음)
+uint32_t newWriteId();
+
+// 스트림 처음에서 헤더 읽기 (헤더가 없으면 false, 스트림 위치는 헤더 뒤)
+bool readFileHeader(std::istream& in, FileHeader& header);
+
+// 파일의 헤더 읽기 (파일이 없거나 헤더가 없으면 false)
+bool readFileHeader(const std::string& filename, FileHeader& header);
+
+#endif // FILE_HEADER_H
@@ -193,6 +193,7 @@ public:
 
     /**
      * 블록 파일의 레코드 개수 카운트
+     * 파일 헤더가 있으면 스캔하지 않고 헤더 값을 반환
      *
      * @param block_file 블록 파일 경로
      * @return 레코드 개수
@@ -201,14 +202,33 @@ public:
 
     /**
      * 블록 파일의 블록 개수 카운트
+     * 파일 헤더가 있으면 스캔하지 않고 헤더 값을 반환
      *
      * @param block_file 블록 파일 경로
      * @return 블록 개수
      */
     size_t countBlocks(const std::string& block_file);
 
+    /**
+     * 등호 술어(column = value)를 만족하는 레코드 개수 카운트
+     *
+     * 딕셔너리 사이드카(.dict)가 있으면 값을 코드로 한 번 변환한 뒤
+     * 레코드마다 2바이트 코드만 비교한다 (문자열 복원 없음).
+     *
+     * @param block_file 블록 파일 경로
+     * @param table_type 테이블 타입 ("PART" 또는 "PARTSUPP")
+     * @param column 컬럼 이름 (예: "brand")
+     * @param value 비교 값 (예: "Brand#23")
+     * @return 일치하는 레코드 개수
+     */
+    size_t countMatching(const std::string& block_file,
+                         const std::string& table_type,
+                         const std::string& column,
+                         const std::string& value);
+
     /**
      * 블록 파일 정보 출력
+     * 파일 헤더만 읽음 (헤더가 없는 이전 형식 파일은 전체 스캔)
      *
      * @param block_file 블록 파일 경로
      */
@@ -4,7 +4,58 @@
 #include "common.h"
 #include "table.h"
 #include "buffer.h"
+#include "dictionary.h"
+#include "result_sink.h"
+#include "memory_governor.h"
 #include <string>
+#include <memory>
+
+// 탐색(seek) 한 번의 비용 (블록 읽기 개수로 환산)
+#define BNLJ_SEEK_COST_BLOCKS 4
+
+// BNLJ 버퍼 분할 계획과 예상 I/O (존 맵 건너뛰기는 고려하지 않은 상한)
+struct BnljPlan {
+    size_t outer_blocks;        // |R|
+    size_t inner_blocks;        // |S|
+    size_t outer_buffers;       // 청크당 outer 블록 수
+    size_t inner_buffers;       // inner를 한 번에 연속으로 읽는 블록 수
+    bool inner_cached;          // inner 전체를 버퍼에 한 번만 올림
+    bool output_in_budget;      // 출력 블록을 버퍼 예산에 포함
+    size_t outer_chunks;        // ⌈|R| / outer_buffers⌉
+    size_t predicted_reads;     // 예상 블록 읽기
+    size_t predicted_seeks;     // 예상 탐색 횟수 (outer 청크 + inner 연속 구간)
+
+    BnljPlan()
+        : outer_blocks(0), inner_blocks(0), outer_buffers(0), inner_buffers(0),
+          inner_cached(false), output_in_budget(false), outer_chunks(0),
+          predicted_reads(0), predicted_seeks(0) {}
+
+    // 비교용 비용 (읽기 + 탐색 × BNLJ_SEEK_COST_BLOCKS)
+    size_t cost() const { return predicted_reads + predicted_seeks * BNLJ_SEEK_COST_BLOCKS; }
+};
+
+// 버퍼 buffer_size개로 계획 수립
+// inner_buffers = 0이면 비용이 가장 작은 inner 블록 수를 선택
+BnljPlan planBlockNestedLoops(size_t outer_blocks, size_t inner_blocks, size_t buffer_size,
+                              size_t inner_buffers, bool output_in_budget);
+
+// 메모리 예산(바이트) 안에 들어가도록 버퍼/캐시 블록 수를 줄임 (캐시를 먼저 줄임)
+// 블록 하나는 frame_bytes (BufferManager::frameBytes())로 셈
+// output_in_budget이 아니면 출력 블록 하나를 따로 셈. budget_bytes = 0이면 그대로
+// 최소 버퍼도 들어가지 않으면 예외, 줄였으면 true
+bool fitBnljToMemory(size_t budget_bytes, size_t frame_bytes, bool output_in_budget,
+                     size_t& buffer_size, size_t& cache_blocks);
+
+// 디코딩한 레코드가 원래 블록의 몇 배 메모리를 쓰는지 (레코드 객체 + 문자열 힙 + 벡터 여유)
+// 추적 할당기(memory_tracker.h)의 build 단계 측정값 기준
+#define BNLJ_DECODED_BLOCK_RATIO 2
+
+// 한도가 있을 때 버퍼/캐시 프레임에 쓸 예산: 남은 예산 중 outer 블록을 디코딩한
+// 레코드가 쓸 몫을 뺀 나머지 (available = SIZE_MAX면 무제한이라 그대로)
+size_t bnljFrameBudget(size_t available_bytes);
+
+// 테이블 블록 수 (헤더 → 존 맵 → 스캔 순서로 확인)
+size_t countTableBlocks(const std::string& block_file, size_t block_size);
 
 // Block Nested Loops Join 실행자
 class BlockNestedLoopsJoin {
@@ -16,15 +67,27 @@ private:
     std::string inner_table_type;  // "PART" or "PARTSUPP"
     size_t buffer_size;            // 버퍼 크기 (블록 개수)
     size_t block_size;             // 블록 크기 (바이트)
+    size_t cache_blocks;           // inner 페이지 캐시 프레임 개수 (버퍼 외 추가)
+    ReplacementPolicy replacement; // 페이지 캐시 교체 정책
+    bool auto_plan;                // 버퍼 분할 자동 선택
+    bool auto_outer;               // 자동 모드에서 작은 테이블을 outer로 바꿈
+    SinkMode sink_mode;            // 결과 출력 대상
+    BnljPlan plan;
     Statistics stats;
 
+    // PART 파일이 딕셔너리 인코딩된 경우 코드 복원용
+    std::unique_ptr<PartDictionary> part_dict;
+
+    // 메모리 예약 (execute() 동안 유지: 리더, 버퍼, 디코딩한 레코드)
+    std::unique_ptr<MemoryGrant> grant;
+
     // 조인 수행 헬퍼 함수
     void performJoin();
 
     // PART와 PARTSUPP 조인
     void joinPartAndPartSupp(TableReader& outer_reader,
                              TableReader& inner_reader,
-                             TableWriter& writer,
+                             ResultSink& sink,
                              BufferManager& buffer_mgr,
                              bool part_is_outer);
 
@@ -37,9 +100,30 @@ public:
                          size_t buf_size = 10,
                          size_t blk_size = DEFAULT_BLOCK_SIZE);
 
+    // inner 테이블 페이지 캐시 설정 (frames = 0이면 캐시 없음)
+    // inner를 반복 스캔하므로 MRU가 캐시에 들어가는 앞부분 페이지를 유지함
+    void setInnerCache(size_t frames, ReplacementPolicy policy = ReplacementPolicy::MRU) {
+        cache_blocks = frames;
+        replacement = policy;
+    }
+
+    // 자동 모드: 작은 테이블을 outer로, 출력 블록을 예산에 포함하고
+    // inner 연속 읽기 블록 수를 비용으로 선택
+    // (choose_outer = false면 지정한 outer/inner를 유지하고 버퍼 분할만 선택)
+    void setAutoPlan(bool enabled, bool choose_outer = true) {
+        auto_plan = enabled;
+        auto_outer = choose_outer;
+    }
+
+    // 결과 출력 대상 (기본: 파일)
+    void setSink(SinkMode mode) { sink_mode = mode; }
+
     // 조인 실행
     void execute();
 
+    // 실행에 사용한 계획
+    const BnljPlan& getPlan() const { return plan; }
+
     // 통계 정보 가져오기
     const Statistics& getStatistics() const { return stats; }
 };
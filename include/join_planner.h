@@ -0,0 +1,192 @@
+#ifndef JOIN_PLANNER_H
+#define JOIN_PLANNER_H
+
+#include "common.h"
+#include "join.h"
+#include "buffer.h"
+#include "zone_map.h"
+#include "table_stats.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <ostream>
+
+/**
+ * ============================================================================
+ * 비용 기반 조인 계획기
+ * ============================================================================
+ *
+ * 두 테이블의 메타데이터로 조인 알고리즘과 방향(outer/build 테이블)별 비용을
+ * 추정하고 가장 싼 계획을 실행한다.
+ *
+ * 사용하는 메타데이터 (파일을 스캔하지 않음):
+ *   - 파일 헤더: 블록/레코드 개수, 정렬 여부
+ *   - 존 맵 사이드카: 키 범위, 블록별 키 범위 (인덱스로 사용해 건너뛸 블록 계산)
+ *   - 통계 사이드카(--analyze, table_stats.h)가 있으면 조인 키의 HyperLogLog 고유 값 수,
+ *     빈발 값, 평균 레코드 폭으로 결과 크기와 해시 테이블 메모리를 계산
+ *   - 통계가 없으면 고유 키 개수를 min(레코드 수, 키 범위 폭)으로 추정
+ *     키 범위를 모르는 테이블은 상대 테이블의 키 집합에 포함된다고 보고
+ *     min(레코드 수, 상대 고유 키 수)
+ *
+ * 후보:
+ *   - BNLJ: 각 테이블을 outer로 (버퍼 분할은 planBlockNestedLoops)
+ *     존 맵이 있으면 outer 청크 키 범위와 겹치는 inner 블록만 읽는다고 계산
+ *   - Hash Join: 각 테이블을 build로. 메모리 예산은 --memory-limit 한도 (없으면 무제한,
+ *     BNLJ 버퍼 수는 해시 조인에 적용하지 않음). 해시 테이블이 예산에 들어가지 않으면
+ *     파티션으로 나눠 쓰고 다시 읽는 I/O를 더함 (HashJoin의 grace hash join과 같은 계산)
+ *     probe 테이블은 build 키 범위와 겹치는 블록만 읽는다고 계산하고, 여러 번 나눠 채우면
+ *     채우기마다 그 구간의 키 범위로 같은 계산을 함 (BNLJ 청크와 같은 존 맵 건너뛰기)
+ *
+ * 비용은 예상 실행 시간(마이크로초)으로 비교한다:
+ *   블록 읽기/쓰기, 탐색, 레코드 쌍 비교(BNLJ), 해시 삽입/조회 횟수에
+ *   아래 단가를 곱해 더한다. 단가는 이 구현(레코드 파싱 포함)을 기준으로 잡은 값.
+ */
+
+// 비용 단가 (마이크로초)
+#define COST_BLOCK_READ_US   2.0    // 블록 하나 읽기
+#define COST_BLOCK_WRITE_US  4.0    // 블록 하나 쓰기
+#define COST_SEEK_US         8.0    // 탐색 한 번
+#define COST_PAIR_US         0.9    // BNLJ 레코드 쌍 하나 비교 (쌍마다 두 레코드를 파싱)
+#define COST_PARSE_US        1.0    // 레코드 하나 파싱
+#define COST_HASH_US         0.2    // 해시 테이블 삽입/조회 한 번
+#define COST_OUTPUT_US       0.5    // 결과 레코드 하나 인코딩
+
+// 해시 테이블 엔트리당 추가 메모리 (노드 + 버킷 + vector 헤더)
+#define HASH_ENTRY_OVERHEAD 64
+
+// 조인 입력 테이블 메타데이터
+struct TableProfile {
+    std::string file;
+    std::string type;            // "PART" or "PARTSUPP"
+    uint64_t blocks;
+    uint64_t records;
+    bool sorted;
+    bool has_zone_map;
+    bool has_key_range;
+    int_t key_min;
+    int_t key_max;
+    uint64_t distinct_keys;      // 추정 고유 키 개수
+    std::vector<ZoneEntry> zones; // 존 맵 (없으면 비어 있음)
+    std::shared_ptr<TableStats> stats; // 통계 사이드카 (없거나 파일과 맞지 않으면 nullptr)
+
+    TableProfile()
+        : blocks(0), records(0), sorted(false), has_zone_map(false), has_key_range(false),
+          key_min(0), key_max(0), distinct_keys(0) {}
+
+    // 블록당 평균 레코드 수
+    double recordsPerBlock() const { return blocks > 0 ? double(records) / blocks : 0.0; }
+
+    // 레코드 하나를 메모리에 올렸을 때의 문자열 바이트 (통계가 없으면 파일 크기로 추정)
+    double recordBytes(size_t block_size) const;
+
+    // 헤더, 존 맵, 통계 사이드카에서 읽기 (헤더가 없으면 블록/레코드를 세기 위해 스캔)
+    static TableProfile load(const std::string& file, const std::string& type, size_t block_size);
+};
+
+enum class JoinAlgorithm {
+    BLOCK_NESTED_LOOPS,
+    HASH
+};
+
+const char* joinAlgorithmName(JoinAlgorithm algorithm);
+
+// "bnlj" / "hash" / "auto" 파싱 ("auto"면 auto_select = true)
+JoinAlgorithm parseJoinAlgorithm(const std::string& name, bool& auto_select);
+
+// 후보 계획 하나의 추정치
+struct JoinCandidate {
+    JoinAlgorithm algorithm;
+    bool first_is_outer;         // 첫 번째 테이블이 outer(BNLJ) / build(Hash)
+    bool feasible;
+    std::string note;            // 실행할 수 없는 이유 또는 계획 요약
+
+    double est_reads;
+    double est_writes;
+    double est_seeks;
+    double est_cpu_ops;          // 비교 + 해시 연산 횟수
+    double est_memory;           // 바이트
+    double est_cost_us;          // 비교용 총 비용
+
+    BnljPlan bnlj;               // BNLJ 후보일 때 버퍼 분할
+
+    JoinCandidate()
+        : algorithm(JoinAlgorithm::BLOCK_NESTED_LOOPS), first_is_outer(true), feasible(true),
+          est_reads(0), est_writes(0), est_seeks(0), est_cpu_ops(0), est_memory(0),
+          est_cost_us(0) {}
+};
+
+class JoinPlanner {
+private:
+    TableProfile first;
+    TableProfile second;
+    std::string output_file;
+    size_t buffer_size;
+    size_t block_size;
+    size_t cache_blocks;
+    ReplacementPolicy replacement;
+    bool auto_split;             // BNLJ 버퍼 분할 자동 선택 (출력 블록 예산 포함)
+    size_t memory_budget;        // 해시 조인 한도 (--memory-limit, 0이면 무제한, 바이트)
+    size_t fixed_memory;         // 리더, 디코딩 작업 공간, 출력 스트림 (plan()에서 계산, 바이트)
+    SinkMode sink_mode;          // 결과 출력 대상
+
+    double est_output_records;
+    double est_output_blocks;
+    std::vector<JoinCandidate> candidates;
+
+    // 실행 결과
+    int executed;                // candidates 인덱스 (-1이면 실행 전)
+    Statistics actual;
+
+    JoinCandidate planBnlj(const TableProfile& outer, const TableProfile& inner, bool first_is_outer) const;
+    JoinCandidate planHash(const TableProfile& build, const TableProfile& probe, bool first_is_outer) const;
+
+    // table을 읽는 리더 하나가 쓰는 메모리 (TableReader::memoryBytes()와 같은 계산)
+    size_t readerBytes(const TableProfile& table) const;
+
+    // table에서 키 범위 [lo, hi]와 겹치는 블록 수와 그 레코드 수 (존 맵이 없으면 전부)
+    static void overlappingBlocks(const TableProfile& table, int_t lo, int_t hi,
+                                  double& blocks, double& records);
+
+    // build를 파일 순서로 passes번 나눠 채울 때 채우기마다 읽는 probe 블록 수의 합
+    // (채운 구간의 키 범위와 겹치는 블록만, build 존 맵이 없으면 build 전체 키 범위로)
+    static double passOverlapReads(const TableProfile& build, const TableProfile& probe,
+                                   size_t passes);
+
+public:
+    JoinPlanner(const std::string& file_a, const std::string& type_a,
+                const std::string& file_b, const std::string& type_b,
+                const std::string& out_file,
+                size_t buf_size = 10,
+                size_t blk_size = DEFAULT_BLOCK_SIZE);
+
+    // 실행 옵션 (후보 계산 전에 설정)
+    void setInnerCache(size_t frames, ReplacementPolicy policy = ReplacementPolicy::MRU) {
+        cache_blocks = frames;
+        replacement = policy;
+    }
+    void setAutoSplit(bool enabled) { auto_split = enabled; }
+    void setSink(SinkMode mode) { sink_mode = mode; }
+
+    // 모든 후보 비용 계산
+    void plan();
+
+    const std::vector<JoinCandidate>& getCandidates() const { return candidates; }
+
+    // 실행 가능한 후보 중 가장 싼 것의 인덱스 (없으면 예외)
+    // only_algorithm이 주어지면 그 알고리즘 중에서 고르고, 실행 가능한 후보가 없으면
+    // 예산을 넘는 후보 중 가장 싼 것 (사용자가 알고리즘을 지정한 경우)
+    size_t chooseBest() const;
+    size_t chooseBest(JoinAlgorithm only_algorithm) const;
+
+    // 알고리즘과 방향이 정해진 후보 (사용자가 outer를 지정한 경우)
+    size_t findCandidate(JoinAlgorithm algorithm, bool first_is_outer) const;
+
+    // 후보 실행 (실행할 수 없는 후보면 경고 후 실행)
+    void execute(size_t index);
+    const Statistics& getStatistics() const { return actual; }
+
+    // 추정치 표 (실행 후라면 실제 값 포함)
+    void printExplain(std::ostream& out) const;
+};
+
+#endif // JOIN_PLANNER_H
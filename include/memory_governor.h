@@ -0,0 +1,152 @@
+#ifndef MEMORY_GOVERNOR_H
+#define MEMORY_GOVERNOR_H
+
+#include "common.h"
+#include <string>
+#include <mutex>
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * ============================================================================
+ * 프로세스 전체 메모리 예산 (--memory-limit)
+ * ============================================================================
+ *
+ * 연산자는 메모리를 쓰기 전에 MemoryGrant로 예산을 예약하고, 끝나면 (소멸자에서) 반납한다.
+ * 한 프로세스에서 여러 연산자가 동시에 돌아도 예약 합계가 한도를 넘지 않는다.
+ *
+ *   - BNLJ: 리더 + 버퍼 + 페이지 캐시 + 출력 블록을 예약. 다 받지 못하면 캐시, 버퍼 순으로 줄여 실행.
+ *     디코딩한 outer 청크와 inner 레코드도 예약 안에서 키우고, 넘치면 청크를 일찍 끊음
+ *   - Hash Join: 입출력 블록을 먼저 예약하고, 해시 테이블이 커질 때마다 늘려 받음.
+ *     더 받을 수 없으면 두 입력을 파티션 파일로 나눠(grace hash join) 파티션별로 조인
+ *   - Delta Join: 조회용 해시 테이블을 예약 안에서만 키우고, 넘치면 예외
+ *
+ * 한도가 0이면 무제한 (예약량만 기록).
+ * 해시 테이블 크기는 레코드 객체, 문자열 힙, 노드, 버킷 배열을 더해 추적한다
+ * (할당기 자체의 오버헤드는 제외).
+ */
+
+// 예약 단위 (해시 테이블이 자랄 때 한 번에 늘려 받는 크기)
+#define MEMORY_GRANT_STEP (64 * 1024)
+
+class MemoryGovernor {
+private:
+    mutable std::mutex mutex;
+    size_t limit;        // 0 = 무제한
+    size_t reserved;
+    size_t peak_reserved;
+
+    MemoryGovernor() : limit(0), reserved(0), peak_reserved(0) {}
+
+public:
+    static MemoryGovernor& instance();
+
+    void setLimit(size_t bytes);
+    size_t getLimit() const;
+    size_t getReserved() const;
+    size_t getPeakReserved() const;
+
+    // 남은 예산 (무제한이면 SIZE_MAX)
+    size_t getAvailable() const;
+
+    // bytes만큼 예약 (한도를 넘으면 false)
+    bool tryReserve(size_t bytes);
+
+    // minimum 이상 desired 이하에서 가능한 만큼 예약 (minimum도 안 되면 0)
+    size_t reserveUpTo(size_t desired, size_t minimum);
+
+    void release(size_t bytes);
+};
+
+// 연산자 하나의 예약 (소멸 시 반납)
+// 예약한 크기(size)와 실제로 쓰는 크기(used)를 따로 기록하고,
+// 쓰는 크기가 예약을 넘으려 하면 MEMORY_GRANT_STEP 단위로 늘려 받는다.
+class MemoryGrant {
+private:
+    std::string owner;
+    size_t granted;
+    size_t used;
+    size_t peak_used;
+    size_t cap;          // 연산자 자체 한도 (0 = 전역 한도만)
+
+public:
+    explicit MemoryGrant(const std::string& owner_name, size_t cap_bytes = 0)
+        : owner(owner_name), granted(0), used(0), peak_used(0), cap(cap_bytes) {}
+    ~MemoryGrant() { releaseAll(); }
+
+    MemoryGrant(const MemoryGrant&) = delete;
+    MemoryGrant& operator=(const MemoryGrant&) = delete;
+
+    // minimum 이상 desired 이하를 예약해 바로 사용 처리하고 받은 크기 반환
+    // (minimum도 안 되면 예외)
+    size_t acquire(size_t desired, size_t minimum);
+
+    // bytes만큼 더 사용 (예약을 늘려 받지 못하면 false, 사용량은 그대로)
+    bool use(size_t bytes);
+
+    // 사용량을 bytes만큼 줄임 (예약은 trim()으로 반납)
+    void unuse(size_t bytes);
+
+    // 쓰지 않는 예약 반납
+    void trim();
+    void releaseAll();
+
+    size_t size() const { return granted; }
+    size_t getUsed() const { return used; }
+    size_t getPeakUsed() const { return peak_used; }
+    const std::string& getOwner() const { return owner; }
+};
+
+// 스코프 동안 bytes를 예약에 더해 두고 끝나면 되돌림 (리더처럼 크기가 정해진 작업 메모리)
+// 예약을 늘려 받지 못하면 예외
+class ScopedMemoryUse {
+private:
+    MemoryGrant& grant;
+    size_t bytes;
+
+public:
+    ScopedMemoryUse(MemoryGrant& memory_grant, size_t used_bytes)
+        : grant(memory_grant), bytes(used_bytes) {
+        if (!grant.use(bytes)) {
+            throw std::runtime_error(grant.getOwner() + ": memory limit too small (needs " +
+                                     std::to_string(bytes) + " more bytes)");
+        }
+    }
+    ~ScopedMemoryUse() { grant.unuse(bytes); }
+
+    ScopedMemoryUse(const ScopedMemoryUse&) = delete;
+    ScopedMemoryUse& operator=(const ScopedMemoryUse&) = delete;
+};
+
+// 문자열이 힙에 할당한 바이트 (짧은 문자열이 객체 안에 저장되어 있으면 0)
+size_t stringHeapBytes(const std::string& value);
+
+// unordered_map<K, vector<V>>에 key로 값 하나를 추가할 때 늘어나는 바이트
+// (새 키의 노드와 첫 원소, 벡터 재할당, 버킷 배열 재해싱. 값이 가리키는 힙 바이트는 제외)
+template <typename Map>
+size_t hashInsertBytes(const Map& table, const typename Map::key_type& key) {
+    typedef typename Map::mapped_type::value_type Value;
+    auto it = table.find(key);
+    if (it != table.end()) {
+        // 가득 찬 벡터는 두 배로 재할당
+        const auto& values = it->second;
+        return values.size() == values.capacity() ? values.capacity() * sizeof(Value) : 0;
+    }
+
+    // 노드 = 다음 노드 포인터 + 키/값 쌍 + 캐시된 해시
+    size_t bytes = sizeof(void*) + sizeof(typename Map::value_type) + sizeof(size_t) + sizeof(Value);
+    if (table.size() + 1 > table.bucket_count() * table.max_load_factor()) {
+        // 재해싱하는 동안 새 버킷 배열(약 두 배)과 기존 배열이 함께 존재
+        bytes += std::max<size_t>(table.bucket_count() * 2, 16) * sizeof(void*);
+    }
+    return bytes;
+}
+
+// 레코드 하나를 디코딩하는 동안 잠깐 쓰는 메모리 (Record 필드 문자열, 디코딩 중인 값)
+// 연산자가 디코딩한 레코드를 예약에 더하기 전에 생기므로 작업 공간으로 미리 예약한다
+#define RECORD_DECODE_SCRATCH_BYTES (2 * 1024)
+
+// "4096", "512K", "64M", "2G" → 바이트 (잘못된 형식이면 예외)
+size_t parseMemorySize(const std::string& text);
+
+#endif // MEMORY_GOVERNOR_H
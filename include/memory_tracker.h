@@ -0,0 +1,113 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include "common.h"
+#include <string>
+#include <ostream>
+
+/**
+ * ============================================================================
+ * 할당 추적 (연산자 / 단계별 실제 힙 사용량)
+ * ============================================================================
+ *
+ * 전역 operator new/delete를 바꿔 모든 할당 앞에 16바이트 헤더
+ * [크기 (8B)][계정 번호 (4B)][식별자 (4B)]를 붙이고, 할당한 스레드의 현재
+ * (연산자, 단계) 계정에 크기를 더한다. 해제는 헤더의 계정에서 빼므로
+ * 다른 단계나 스레드에서 해제해도 할당한 계정의 현재 사용량이 맞게 줄어든다.
+ *
+ * 계정마다 현재 사용량(live), 최대 사용량(peak), 할당 횟수와 누적 바이트를 원자적으로 기록한다.
+ * 연산자 합계는 단계 계정과 따로 기록한다 (합계 최대 ≠ 단계 최대의 합).
+ *
+ * 사용:
+ *   OperatorMemoryScope op("Hash join");       // 이 스레드의 할당을 연산자의 setup 단계로
+ *   { MemoryPhaseScope phase(MemoryPhase::BUILD); ... }  // build 단계로 기록
+ *   printTrackedMemory(std::cout, op.id());
+ *
+ * 범위 밖(연산자 없음)의 할당은 프로세스 합계에만 들어간다.
+ * 표준 라이브러리 내부 버퍼나 malloc 직접 호출은 추적하지 않으므로,
+ * 프로세스 합계를 /proc/self/status의 RSS와 나란히 출력해 비교한다.
+ *
+ * 연산자 계정은 범위 객체마다 새로 받는다 (이름이 같아도 따로). 계정이 모자라면 가장 오래된
+ * 계정을 다시 쓰고 세대 번호를 올리므로, 이전 연산자가 남긴 할당의 해제는 새 계정에서 빠지지 않는다.
+ *
+ * DBSYS_TRACK_ALLOC=0으로 빌드하면 operator new/delete를 바꾸지 않는다. 계정은 모두 0이고
+ * 출력은 RSS만 남는다 (CMake: -DDBSYS_TRACK_ALLOC=OFF, Make: make TRACK_ALLOC=0).
+ */
+
+#ifndef DBSYS_TRACK_ALLOC
+#define DBSYS_TRACK_ALLOC 1
+#endif
+
+#define MEMORY_TRACKER_MAX_OPERATORS 32
+
+enum class MemoryPhase {
+    SETUP = 0,      // 리더/라이터 생성, 계획 등
+    BUILD,          // outer 청크 적재, 해시 테이블 구축
+    PROBE,          // inner 스캔, 해시 테이블 조회
+    OUTPUT,         // 출력 블록과 결과 파일 쓰기
+    PARTITION,      // 해시 조인 파티션 파일 쓰기
+    COUNT
+};
+
+const char* memoryPhaseName(MemoryPhase phase);
+
+struct MemoryUsage {
+    int64_t live;           // 현재 할당된 바이트
+    int64_t peak;           // 최대 바이트
+    uint64_t allocations;   // 할당 횟수
+    uint64_t allocated;     // 할당한 바이트 누적
+
+    MemoryUsage() : live(0), peak(0), allocations(0), allocated(0) {}
+};
+
+class MemoryTracker {
+public:
+    // 새 연산자 계정 번호 (호출마다 새 계정, 사용량은 0에서 시작)
+    static int beginOperator(const std::string& name);
+
+    static std::string operatorName(int op);
+    static MemoryUsage phaseUsage(int op, MemoryPhase phase);
+    static MemoryUsage operatorUsage(int op);
+
+    // 추적한 전체 할당 (연산자 범위 밖 포함)
+    static MemoryUsage processUsage();
+
+    // /proc/self/status의 VmRSS, VmHWM (바이트, 읽을 수 없으면 false)
+    static bool readResidentSet(size_t& rss, size_t& peak_rss);
+};
+
+// 이 스레드의 할당을 연산자 계정에 기록 (소멸 시 이전 상태로)
+class OperatorMemoryScope {
+private:
+    int op;
+    int saved_op;
+    int saved_phase;
+
+public:
+    explicit OperatorMemoryScope(const std::string& name);
+    ~OperatorMemoryScope();
+
+    OperatorMemoryScope(const OperatorMemoryScope&) = delete;
+    OperatorMemoryScope& operator=(const OperatorMemoryScope&) = delete;
+
+    int id() const { return op; }
+};
+
+// 이 스레드의 할당을 현재 연산자의 phase 단계로 기록 (소멸 시 이전 단계로)
+// 하드웨어 카운터(perf_counters.h)를 재고 있으면 카운터 단계도 함께 전환
+class MemoryPhaseScope {
+private:
+    int saved_phase;
+
+public:
+    explicit MemoryPhaseScope(MemoryPhase phase);
+    ~MemoryPhaseScope();
+
+    MemoryPhaseScope(const MemoryPhaseScope&) = delete;
+    MemoryPhaseScope& operator=(const MemoryPhaseScope&) = delete;
+};
+
+// 단계별 최대/현재 사용량과 프로세스 합계, RSS 출력
+void printTrackedMemory(std::ostream& out, int op);
+
+#endif // MEMORY_TRACKER_H
@@ -5,6 +5,7 @@
 #include "table.h"
 #include "buffer.h"
 #include "join.h"
+#include "memory_governor.h"
 #include <string>
 #include <unordered_map>
 #include <thread>
@@ -25,12 +26,25 @@
  * 해시 조인 구현
  *
  * 알고리즘:
- * 1. Build Phase: 작은 테이블(PART)을 해시 테이블에 로드
- * 2. Probe Phase: 큰 테이블(PARTSUPP)을 스캔하며 매칭
+ * 1. Build Phase: 작은 테이블(보통 PART)을 해시 테이블에 로드
+ * 2. Probe Phase: 큰 테이블(보통 PARTSUPP)을 스캔하며 매칭
+ *    (PARTSUPP를 build, PART를 probe로 하는 반대 방향도 지원)
+ *
+ * build 테이블의 통계 사이드카(--analyze)가 있으면 조인 키 고유 값 수만큼
+ * 해시 테이블 버킷을 미리 잡아 구축 중 재해싱을 피한다.
+ *
+ * 메모리 예산 (memory_governor.h):
+ *   입출력 블록 3개를 먼저 예약하고, 레코드를 넣을 때마다 늘어나는 크기
+ *   (레코드 객체 + 문자열 힙 + 노드 + 버킷 배열)만큼 예약을 늘려 받는다.
+ *   더 받을 수 없으면 해시 테이블을 비우고 두 입력을 키 해시로 P개 파티션 파일로 나눠
+ *   (grace hash join) 파티션 쌍마다 조인한다. P는 넘치기 전까지 읽은 build 비율로 정하고,
+ *   파티션 하나도 들어가지 않으면 build를 예산만큼씩 나눠 여러 번 채우며
+ *   매번 probe 파티션을 다시 읽는다.
  *
  * 시간 복잡도: O(|R| + |S|) - 이상적인 경우
  * I/O 복잡도: |R| + |S| (각 테이블을 한 번씩만 스캔)
- * 메모리 요구: PART 테이블 전체를 메모리에 로드
+ *   파티션으로 나누면 두 입력을 한 번 더 쓰고 읽음: 3(|R| + |S|)
+ * 메모리 요구: PART 테이블 전체를 메모리에 로드 (예산을 넘으면 파티션 하나씩)
  *
  * 장점:
  * - Block Nested Loops보다 훨씬 빠름 (특히 큰 데이터셋)
@@ -40,6 +54,10 @@
  * - 작은 테이블이 메모리에 들어가야 함
  * - 해시 테이블 구축 오버헤드
  */
+// 파티션 파일 하나를 쓰는 동안 블록 외에 드는 메모리 (파일 스트림 버퍼, 존 맵)
+// 추적 할당기(memory_tracker.h)의 partition 단계 측정값 기준
+#define HASH_PARTITION_WRITER_BYTES (12 * 1024)
+
 class HashJoin {
 private:
     std::string build_table_file;   // 작은 테이블 (메모리에 로드)
@@ -48,13 +66,60 @@ private:
     std::string build_table_type;
     std::string probe_table_type;
     size_t block_size;
+    SinkMode sink_mode;
     Statistics stats;
 
-    // 해시 테이블: PARTKEY → PartRecord 리스트
+    // 해시 테이블: PARTKEY → 레코드 리스트 (build 테이블 타입에 따라 하나만 사용)
     std::unordered_map<int_t, std::vector<PartRecord>> hash_table;
+    std::unordered_map<int_t, std::vector<PartSuppRecord>> partsupp_table;
+
+    // PART 테이블이 딕셔너리 인코딩된 경우 코드 복원용
+    std::unique_ptr<PartDictionary> part_dict;
+
+    // 메모리 예산 (execute() 동안 유지)
+    size_t memory_budget;                  // 연산자 한도 (0이면 전역 한도만)
+    std::unique_ptr<MemoryGrant> grant;
+    size_t table_bytes;                    // 해시 테이블이 쓰는 크기
+    size_t spill_partitions;               // 0이면 파티션 없이 조인
+    size_t build_passes;                   // 해시 테이블을 채운 횟수
+
+    // build 테이블의 키 범위 (probe 블록 건너뛰기용, 비어 있으면 false)
+    bool getBuildKeyRange(int_t& lo, int_t& hi) const;
+
+    // 레코드 하나를 해시 테이블에 추가 (예약을 늘려 받지 못하면 false, 테이블은 그대로)
+    template <typename T>
+    bool insertBuild(std::unordered_map<int_t, std::vector<T>>& table, T&& value);
+    bool insertBuildRecord(const Record& record);
 
-    void buildHashTable();
-    void probeAndJoin(TableWriter& writer);
+    // 통계의 고유 키 수로 버킷 미리 확보 (예약 안에서만)
+    void presizeFromStatistics();
+
+    // 해시 테이블을 비우고 예약 반납
+    void clearTable();
+
+    // 결과 하나를 출력 블록에 인코딩 (가득 차면 플러시 후 다시 인코딩)
+    void emitResult(const PartRecord& part, const PartSuppRecord& partsupp, ResultSink& sink,
+                    Block& output_block, RecordBuilder& output_builder);
+
+    // probe 레코드 하나를 조인해 출력 블록에 기록
+    void probeRecord(const Record& record, ResultSink& sink,
+                     Block& output_block, RecordBuilder& output_builder);
+
+    // build 파일을 예약이 허락하는 만큼씩 해시 테이블에 채우고 probe 파일과 조인
+    // allow_spill이면 첫 채우기에서 넘칠 때 false 반환 (loaded_blocks = 그때까지 읽은 build 블록)
+    bool joinFiles(const std::string& build_file, const std::string& probe_file,
+                   bool allow_spill, ResultSink& sink,
+                   Block& output_block, RecordBuilder& output_builder,
+                   size_t& loaded_blocks);
+
+    // 두 입력을 파티션 파일로 나눠 파티션 쌍마다 조인
+    void joinPartitioned(size_t loaded_blocks, ResultSink& sink,
+                         Block& output_block, RecordBuilder& output_builder);
+
+    // 입력 파일을 키 해시로 partitions개 파일에 나눔
+    std::vector<std::string> partitionFile(const std::string& input_file,
+                                           const std::string& table_type,
+                                           const std::string& prefix, size_t partitions);
 
 public:
     HashJoin(const std::string& build_file,
@@ -64,8 +129,14 @@ public:
              const std::string& probe_type,
              size_t blk_size = DEFAULT_BLOCK_SIZE);
 
+    // 연산자 메모리 한도 (0이면 --memory-limit 전역 한도만 적용)
+    void setMemoryBudget(size_t bytes) { memory_budget = bytes; }
+    void setSink(SinkMode mode) { sink_mode = mode; }
+
     void execute();
     const Statistics& getStatistics() const { return stats; }
+    size_t getSpillPartitions() const { return spill_partitions; }
+    size_t getBuildPasses() const { return build_passes; }
 };
 
 // ============================================================================
@@ -91,6 +162,7 @@ private:
     size_t buffer_size;
     size_t block_size;
     size_t num_threads;
+    SinkMode sink_mode;
     Statistics stats;
 
     // 스레드 동기화
@@ -115,6 +187,7 @@ public:
                       size_t blk_size = DEFAULT_BLOCK_SIZE,
                       size_t threads = 2);
 
+    void setSink(SinkMode mode) { sink_mode = mode; }
     void execute();
     const Statistics& getStatistics() const { return stats; }
 };
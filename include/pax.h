@@ -0,0 +1,162 @@
+#ifndef PAX_H
+#define PAX_H
+
+#include "common.h"
+#include "block.h"
+#include "record.h"
+#include "table.h"
+#include <string>
+#include <vector>
+
+/**
+ * ============================================================================
+ * PAX (Partition Attributes Across) 페이지 레이아웃
+ * ============================================================================
+ *
+ * 한 페이지(블록)에 들어가는 레코드들을 컬럼별 미니페이지로 나누어 저장한다.
+ * 조인 키처럼 일부 컬럼만 필요한 스캔은 해당 미니페이지만 연속으로 읽으면 된다.
+ *
+ * 페이지 형식:
+ *   [magic 'PAX1' (4B)][record_count (2B)][column_count (2B)]
+ *   [column descriptor × column_count]   - [minipage_offset (4B)][type (4B)]
+ *   [minipage 0][minipage 1]...           - 각 미니페이지는 4바이트 정렬
+ *
+ * 미니페이지 형식:
+ *   INT / DECIMAL : int_t / decimal_t 배열 [record_count]
+ *   STRING        : end_offset 배열 (2B × record_count) + 문자열 데이터
+ *
+ * 행 블록의 첫 4바이트는 레코드 크기(< 블록 크기)이므로 magic과 겹치지 않는다.
+ */
+
+// PAX 페이지 식별자 ('P','A','X','1' little-endian)
+#define PAX_PAGE_MAGIC 0x31584150u
+
+// 블록 레이아웃
+enum class BlockLayout : uint8_t {
+    ROW = 0,   // 행 단위 레코드 (기본)
+    PAX = 1    // 컬럼별 미니페이지
+};
+
+// 문자열 레이아웃 이름 → BlockLayout ("row" 또는 "pax")
+BlockLayout parseBlockLayout(const std::string& name);
+
+// PAX 페이지 리더 - 블록 데이터를 복사 없이 해석
+class PaxPage {
+private:
+    const char* data;
+    uint16_t record_count;
+    uint16_t column_count;
+
+    uint32_t getMinipageOffset(size_t col) const;
+
+public:
+    explicit PaxPage(const Block* block);
+
+    // 블록이 PAX 페이지인지 확인
+    static bool isPaxPage(const Block* block);
+
+    size_t getRecordCount() const { return record_count; }
+    size_t getColumnCount() const { return column_count; }
+    ColumnType getColumnType(size_t col) const;
+
+    // 고정 길이 컬럼의 연속 배열
+    const int_t* getIntColumn(size_t col) const;
+    const decimal_t* getDecimalColumn(size_t col) const;
+
+    // 문자열 컬럼의 row번째 값
+    FieldRef getString(size_t col, size_t row) const;
+
+    // row번째 값의 텍스트 (getRecord와 같은 표기, 행 전체를 복원하지 않음)
+    // 문자열은 미니페이지를 가리키고, 숫자는 scratch에 써서 가리킴 (scratch가 바뀌기 전까지 유효)
+    FieldRef getFieldText(size_t col, size_t row, std::string& scratch) const;
+
+    // row번째 레코드를 행 형식 Record로 복원 (숫자는 std::to_string 표기)
+    Record getRecord(size_t row) const;
+};
+
+// PAX 페이지 빌더 - 레코드를 컬럼별로 모았다가 한 페이지로 기록
+class PaxPageBuilder {
+private:
+    struct ColumnData {
+        std::vector<int_t> ints;
+        std::vector<decimal_t> decimals;
+        std::vector<uint16_t> string_ends;
+        std::string string_bytes;
+    };
+
+    std::vector<ColumnType> schema;
+    size_t page_size;
+    size_t record_count;
+    std::vector<ColumnData> columns;
+
+    // record_count개 레코드와 문자열 바이트 수로 페이지 크기 계산
+    size_t computePageSize(size_t records, const std::vector<size_t>& string_bytes) const;
+
+public:
+    PaxPageBuilder(const std::vector<ColumnType>& column_types, size_t blk_size);
+
+    // 레코드 추가 (페이지에 들어가지 않으면 false, 상태 변화 없음)
+    bool add(const Record& record);
+
+    // 모인 레코드를 블록에 PAX 페이지로 기록하고 빌더 비움
+    void flush(Block* block);
+
+    size_t getRecordCount() const { return record_count; }
+    bool isEmpty() const { return record_count == 0; }
+    void clear();
+};
+
+/**
+ * 벡터화 스캔 - 블록 단위로 컬럼 배열을 제공
+ *
+ * PAX 페이지는 미니페이지를 그대로 가리키고, 행 페이지는 요청된 컬럼만
+ * 배열로 전개한다. 키만 필요한 조인 단계는 getIntColumn(0)만 읽으면 된다.
+ *
+ * 사용 예:
+ *   VectorizedScan scan(reader, block_size, "PARTSUPP");
+ *   while (scan.next()) {
+ *       const int_t* keys = scan.getIntColumn(0);
+ *       for (size_t i = 0; i < scan.size(); ++i) { ... keys[i] ... }
+ *   }
+ */
+class VectorizedScan {
+private:
+    TableReader& reader;
+    Block block;
+    std::vector<ColumnType> schema;
+    bool is_pax;
+    size_t row_count;
+
+    // 행 페이지용: 레코드 뷰와 컬럼별 전개 캐시
+    std::vector<RecordView> views;
+    std::vector<std::vector<int_t>> int_cache;
+    std::vector<std::vector<decimal_t>> decimal_cache;
+    std::vector<bool> cached;
+
+public:
+    VectorizedScan(TableReader& rdr, size_t blk_size, const std::string& table_type);
+
+    // 다음 블록으로 이동 (더 이상 없으면 false)
+    bool next();
+
+    // 현재 블록의 레코드 개수
+    size_t size() const { return row_count; }
+    bool isPax() const { return is_pax; }
+
+    const int_t* getIntColumn(size_t col);
+    const decimal_t* getDecimalColumn(size_t col);
+    FieldRef getString(size_t col, size_t row) const;
+
+    // row번째 레코드 전체 복원
+    Record getRecord(size_t row) const;
+};
+
+// 블록 파일의 레이아웃 변환 (행 ↔ PAX). 변환된 레코드 개수 반환
+size_t convertBlockLayout(const std::string& input_file,
+                          const std::string& output_file,
+                          const std::string& table_type,
+                          BlockLayout layout,
+                          size_t block_size = DEFAULT_BLOCK_SIZE,
+                          bool compress = false);
+
+#endif // PAX_H
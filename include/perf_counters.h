@@ -0,0 +1,104 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include "common.h"
+#include "memory_tracker.h"
+#include <string>
+#include <ostream>
+
+/**
+ * ============================================================================
+ * 하드웨어 성능 카운터 (--perf-counters)
+ * ============================================================================
+ *
+ * 리눅스 perf_event_open으로 사이클, 명령어, LLC 미스, 분기 예측 실패, dTLB 미스를
+ * 연산자의 단계(MemoryPhase: setup, build, probe, output, partition)별로 센다.
+ * 외부 라이브러리 없이 시스템 호출만 사용하고, 사용자 공간만 센다 (exclude_kernel).
+ *
+ * 사용:
+ *   OperatorMemoryScope memory_scope("Hash join");
+ *   OperatorPerfScope perf_scope;          // --perf-counters일 때만 카운터를 엶
+ *   ...                                    // MemoryPhaseScope가 바뀔 때마다 단계별로 누적
+ *   perf_scope.finish(stats);
+ *   printPerfCounters(std::cout, perf_scope, stats.output_records);
+ *
+ * 권한이 없거나(perf_event_paranoid) 가상 머신에 PMU가 없어 열 수 없는 이벤트는 "n/a"로,
+ * 하나도 열 수 없으면 이유 한 줄만 출력하고 조인은 그대로 실행한다.
+ * 카운터를 여러 이벤트가 나눠 쓰면(멀티플렉싱) 실행된 시간 비율로 보정한다.
+ * 카운터는 연산자를 실행한 스레드만 센다 (다른 스레드의 스캔은 포함하지 않음).
+ */
+
+enum class PerfEvent {
+    CYCLES = 0,
+    INSTRUCTIONS,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    DTLB_MISSES
+};
+
+const char* perfEventName(PerfEvent event);
+
+// 이 스레드의 카운터 묶음 (생성 시 열고 소멸 시 닫음)
+class PerfCounters {
+private:
+    int fds[STAT_PERF_EVENT_COUNT];
+    std::string error;       // 하나도 열지 못했을 때 이유
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // --perf-counters (꺼져 있으면 OperatorPerfScope가 카운터를 열지 않음)
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    bool available() const;
+    bool has(PerfEvent event) const { return fds[static_cast<int>(event)] >= 0; }
+    const std::string& getError() const { return error; }
+
+    // 현재 값 (멀티플렉싱 보정, 열지 못한 이벤트는 0)
+    void read(uint64_t values[STAT_PERF_EVENT_COUNT]) const;
+};
+
+// 연산자 하나의 단계별 카운터 (이 스레드의 MemoryPhaseScope 전환을 따라 누적)
+class OperatorPerfScope {
+private:
+    PerfCounters* counters;  // 꺼져 있으면 nullptr
+    uint64_t phase_counts[static_cast<int>(MemoryPhase::COUNT)][STAT_PERF_EVENT_COUNT];
+    uint64_t last[STAT_PERF_EVENT_COUNT];
+    int current_phase;
+    OperatorPerfScope* saved_scope;
+    bool finished;
+
+    void accumulate();
+
+public:
+    OperatorPerfScope();
+    ~OperatorPerfScope();
+
+    OperatorPerfScope(const OperatorPerfScope&) = delete;
+    OperatorPerfScope& operator=(const OperatorPerfScope&) = delete;
+
+    // 지금까지의 값을 현재 단계에 더하고 phase로 전환 (MemoryPhaseScope에서 호출)
+    void switchPhase(MemoryPhase phase);
+
+    // 측정을 끝내고 합계를 stats.perf_counts / perf_valid에 기록
+    void finish(Statistics& stats);
+
+    bool enabled() const { return counters != nullptr; }
+    const PerfCounters* getCounters() const { return counters; }
+    const uint64_t* phaseCounts(MemoryPhase phase) const {
+        return phase_counts[static_cast<int>(phase)];
+    }
+
+    // 이 스레드에서 측정 중인 연산자 (없으면 nullptr)
+    static OperatorPerfScope* current();
+};
+
+// 단계별 출력 레코드당 카운터와 IPC 출력 (--perf-counters가 꺼져 있으면 아무것도 출력하지 않음)
+void printPerfCounters(std::ostream& out, const OperatorPerfScope& scope, size_t output_records);
+
+#endif // PERF_COUNTERS_H
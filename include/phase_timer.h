@@ -0,0 +1,147 @@
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+#include "common.h"
+#include <string>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define PHASE_TIMER_RDTSC 1
+#else
+#include <chrono>
+#endif
+
+/**
+ * ============================================================================
+ * 조인 핫패스 단계별 시간
+ * ============================================================================
+ *
+ * 조인 한 번의 시간을 다섯 단계로 나눠 Statistics::phase_ticks에 누적한다.
+ *   - read:    TableReader::readBlock (디스크 대기 + 압축 해제)
+ *   - decode:  블록에서 레코드 꺼내기, fromRecord 파싱
+ *   - compare: 키 비교, 해시 테이블 삽입/조회 (루프 전체에서 다른 단계를 뺀 나머지)
+ *   - encode:  결과 레코드를 출력 블록에 인코딩
+ *   - write:   TableWriter::writeBlock
+ *
+ * 틱은 x86이면 rdtsc, 아니면 steady_clock 나노초. 초 단위 변환은 처음 필요할 때 한 번 보정한다.
+ * compare처럼 연산 하나가 타이머보다 싼 단계는 레코드마다 재지 않고, 루프 전체 시간에서
+ * 안쪽에서 잰 다른 단계 시간을 빼서 구한다 (RestPhaseTimer).
+ *
+ * DBSYS_PHASE_TIMERS=0으로 빌드하면 타이머 매크로가 모두 사라진다
+ * (CMake: -DDBSYS_PHASE_TIMERS=OFF, Make: make PHASE_TIMERS=0).
+ */
+
+#ifndef DBSYS_PHASE_TIMERS
+#define DBSYS_PHASE_TIMERS 1
+#endif
+
+// Statistics::phase_ticks 인덱스
+enum class TimerPhase {
+    READ = 0,
+    DECODE,
+    COMPARE,
+    ENCODE,
+    WRITE
+};
+
+const char* timerPhaseName(TimerPhase phase);
+
+// 현재 틱
+inline uint64_t timerNow() {
+#ifdef PHASE_TIMER_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// 초당 틱 수 (처음 호출할 때 steady_clock과 비교해 보정)
+double timerTicksPerSecond();
+
+inline double phaseSeconds(const Statistics& stats, TimerPhase phase) {
+    return stats.phase_ticks[static_cast<int>(phase)] / timerTicksPerSecond();
+}
+
+// 범위 안의 시간을 phase에 더함 (stats가 nullptr이면 아무것도 안 함)
+class PhaseTimer {
+private:
+    Statistics* stats;
+    int phase;
+    uint64_t start;
+
+public:
+    PhaseTimer(Statistics* st, TimerPhase p)
+        : stats(st), phase(static_cast<int>(p)), start(st ? timerNow() : 0) {}
+    ~PhaseTimer() {
+        if (stats) {
+            stats->phase_ticks[phase] += timerNow() - start;
+        }
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+};
+
+// 범위 안의 시간 중 다른 단계로 잰 시간을 뺀 나머지를 phase에 더함
+class RestPhaseTimer {
+private:
+    Statistics* stats;
+    int phase;
+    uint64_t start;
+    uint64_t measured_before;
+
+    uint64_t measured() const {
+        uint64_t sum = 0;
+        for (int i = 0; i < STAT_PHASE_COUNT; ++i) {
+            sum += stats->phase_ticks[i];
+        }
+        return sum;
+    }
+
+public:
+    RestPhaseTimer(Statistics* st, TimerPhase p)
+        : stats(st), phase(static_cast<int>(p)), start(timerNow()), measured_before(measured()) {}
+    ~RestPhaseTimer() {
+        uint64_t elapsed = timerNow() - start;
+        uint64_t inner = measured() - measured_before;
+        if (elapsed > inner) {
+            stats->phase_ticks[phase] += elapsed - inner;
+        }
+    }
+
+    RestPhaseTimer(const RestPhaseTimer&) = delete;
+    RestPhaseTimer& operator=(const RestPhaseTimer&) = delete;
+};
+
+#define PHASE_TIMER_CONCAT_(a, b) a##b
+#define PHASE_TIMER_CONCAT(a, b) PHASE_TIMER_CONCAT_(a, b)
+
+#if DBSYS_PHASE_TIMERS
+// 현재 범위 끝까지의 시간을 phase에 더함 (stats_ptr: Statistics*)
+#define PHASE_TIMER(stats_ptr, phase) \
+    PhaseTimer PHASE_TIMER_CONCAT(phase_timer_, __LINE__)((stats_ptr), (phase))
+// 현재 범위 끝까지의 시간에서 다른 단계 시간을 뺀 나머지를 phase에 더함
+#define PHASE_TIMER_REST(stats_ptr, phase) \
+    RestPhaseTimer PHASE_TIMER_CONCAT(phase_timer_, __LINE__)((stats_ptr), (phase))
+#else
+#define PHASE_TIMER(stats_ptr, phase) ((void)sizeof(stats_ptr))
+#define PHASE_TIMER_REST(stats_ptr, phase) ((void)sizeof(stats_ptr))
+#endif
+
+// 단계별 시간과 전체 대비 비율 출력 (타이머를 끄고 빌드했으면 한 줄 안내)
+void printPhaseBreakdown(std::ostream& out, const Statistics& stats);
+
+// JSON 문자열 리터럴 (따옴표 포함, 이스케이프 적용)
+std::string jsonString(const std::string& value);
+
+// 통계를 JSON 객체 하나로 기록 (path가 "-"이면 표준 출력)
+void writeStatisticsJson(const std::string& path, const std::string& algorithm,
+                         const Statistics& stats);
+
+#endif // PHASE_TIMER_H
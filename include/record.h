@@ -9,6 +9,35 @@
 
 // 가변 길이 레코드 형식
 // [record_size(4 bytes)][field1_len(2 bytes)][field1_data][field2_len][field2_data]...
+//
+// 오프셋 인덱스 형식 (OFFSET_INDEXED)
+// [record_size(4 bytes)][tag=0xFFFF(2)][field_count(2)][end_offset_1(2)]...[end_offset_n(2)][field_data...]
+//   - end_offset_k: 필드 데이터 영역 시작 기준 k번째 필드의 끝 위치
+//   - k번째 필드는 [end_offset_{k-1}, end_offset_k) 구간 → 선형 탐색 없이 O(1) 접근
+//   - tag 0xFFFF는 길이 접두 형식의 첫 필드 길이와 구분하기 위한 표식
+//     (그래서 길이 접두 형식의 첫 필드는 0xFFFF 바이트일 수 없음)
+
+enum class RecordEncoding : uint8_t {
+    LENGTH_PREFIXED = 0,   // 기본 형식 (필드마다 길이 접두)
+    OFFSET_INDEXED = 1     // 레코드 헤더에 필드 오프셋 테이블 포함
+};
+
+// 오프셋 인덱스 형식 식별 태그
+constexpr uint16_t RECORD_INDEXED_TAG = 0xFFFF;
+
+// 문자열 인코딩 이름 → RecordEncoding ("row" 또는 "indexed")
+RecordEncoding parseRecordEncoding(const std::string& name);
+
+// 블록 내 필드 참조 (복사 없음)
+struct FieldRef {
+    const char* data;
+    size_t size;
+
+    std::string toString() const { return std::string(data, size); }
+    bool equals(const std::string& value) const {
+        return size == value.size() && std::memcmp(data, value.data(), size) == 0;
+    }
+};
 
 class Record {
 private:
@@ -27,39 +56,123 @@ public:
     const std::vector<std::string>& getFields() const { return fields; }
 
     // 레코드를 바이트 배열로 직렬화
-    std::vector<char> serialize() const;
+    std::vector<char> serialize(RecordEncoding encoding = RecordEncoding::LENGTH_PREFIXED) const;
 
-    // 바이트 배열에서 레코드 역직렬화
+    // 바이트 배열에서 레코드 역직렬화 (두 인코딩 모두 자동 인식)
     static Record deserialize(const char* data, size_t& offset);
 
     // 레코드의 직렬화된 크기 계산
-    size_t getSerializedSize() const;
+    size_t getSerializedSize(RecordEncoding encoding = RecordEncoding::LENGTH_PREFIXED) const;
+};
+
+// 레코드 뷰 클래스 - 블록 안의 레코드를 복사 없이 필드 단위로 접근
+// OFFSET_INDEXED 레코드는 O(1), LENGTH_PREFIXED 레코드는 선형 탐색
+class RecordView {
+private:
+    const char* body;      // record_size 다음 위치
+    uint32_t body_size;
+    bool indexed;
+    uint16_t field_count;
+
+public:
+    RecordView() : body(nullptr), body_size(0), indexed(false), field_count(0) {}
+    // OFFSET_INDEXED 레코드는 오프셋 테이블을 한 번 검증 (손상되었으면 예외)
+    RecordView(const char* data, uint32_t size);
+
+    bool isIndexed() const { return indexed; }
+    size_t getFieldCount() const { return field_count; }
+
+    // k번째 필드 참조
+    FieldRef getField(size_t idx) const;
+
+    // 전체 필드를 Record로 복사
+    Record toRecord() const;
 };
 
 // 레코드 리더 클래스 - 블록에서 레코드 읽기
+// 행 블록과 PAX 페이지(pax.h)를 모두 지원
 class RecordReader {
 private:
     const Block* block;
     size_t current_offset;
 
+    // PAX 페이지 상태
+    bool is_pax;
+    size_t pax_row;
+    size_t pax_row_count;
+    std::vector<char> scratch;   // PAX 레코드를 뷰로 제공하기 위한 임시 버퍼
+
 public:
-    RecordReader(const Block* blk) : block(blk), current_offset(0) {}
+    RecordReader(const Block* blk);
 
     // 다음 레코드 읽기
     bool hasNext() const;
     Record readNext();
 
+    // 다음 레코드를 뷰로 읽기 (필드 복사 없음, 블록이 유효한 동안만 사용)
+    // PAX 페이지에서는 행 형식 호환용으로 레코드를 임시 버퍼에 복원하므로 느리고
+    // 다음 readNextView() 호출 전까지만 유효. PAX를 읽는 쪽은 PaxPage 컬럼 접근자
+    // (getIntColumn, getFieldText)나 VectorizedScan을 사용할 것
+    RecordView readNextView();
+
     // 리더 초기화
-    void reset() { current_offset = 0; }
+    void reset() { current_offset = 0; pax_row = 0; }
+};
+
+// 레코드 빌더 클래스 - 블록에 공간을 예약하고 필드를 직접 인코딩
+// 임시 버퍼 없이 필드당 memcpy 한 번으로 레코드를 기록
+//
+// 사용 예:
+//   RecordBuilder builder(&block);
+//   builder.begin(3);
+//   builder.addInt(partkey).addString(name).addDecimal(price);
+//   if (!builder.commit()) { /* 블록 부족 → 이미 롤백됨 */ }
+class RecordBuilder {
+private:
+    Block* block;
+    RecordEncoding encoding;
+    size_t record_start;     // record_size 필드 위치
+    size_t data_start;       // 첫 필드 데이터 위치
+    size_t write_pos;        // 다음 쓰기 위치
+    size_t expected_fields;  // OFFSET_INDEXED: begin()에서 지정한 필드 개수
+    size_t field_index;
+    bool overflow;
+    bool active;
+
+    // len 바이트를 쓸 공간이 있는지 확인 (없으면 overflow 표시)
+    bool reserve(size_t len);
+
+public:
+    RecordBuilder(Block* blk, RecordEncoding enc = RecordEncoding::LENGTH_PREFIXED);
+
+    // 새 레코드 시작 (OFFSET_INDEXED는 필드 개수 필요)
+    void begin(size_t num_fields = 0);
+
+    // 필드 추가 (블록이 부족하면 무시되고 commit()이 false 반환)
+    // LENGTH_PREFIXED의 첫 필드는 RECORD_INDEXED_TAG 바이트일 수 없어 거부됨
+    RecordBuilder& addString(const char* data, size_t len);
+    RecordBuilder& addString(const std::string& value) {
+        return addString(value.data(), value.size());
+    }
+    RecordBuilder& addInt(int_t value);
+    RecordBuilder& addDecimal(decimal_t value);
+
+    // 레코드 확정 (record_size 기록). 공간 부족이면 롤백 후 false
+    bool commit();
+
+    // 현재 레코드를 취소하고 블록을 begin() 이전 상태로 복원
+    void rollback();
 };
 
 // 레코드 라이터 클래스 - 블록에 레코드 쓰기
 class RecordWriter {
 private:
     Block* block;
+    RecordEncoding encoding;
 
 public:
-    RecordWriter(Block* blk) : block(blk) {}
+    RecordWriter(Block* blk, RecordEncoding enc = RecordEncoding::LENGTH_PREFIXED)
+        : block(blk), encoding(enc) {}
 
     // 레코드 쓰기
     bool writeRecord(const Record& record);
@@ -0,0 +1,72 @@
+#ifndef RESULT_SINK_H
+#define RESULT_SINK_H
+
+#include "common.h"
+#include "block.h"
+#include "table.h"
+#include "memory_governor.h"
+#include <memory>
+#include <string>
+
+/**
+ * ============================================================================
+ * 조인 결과 출력 대상 (--sink)
+ * ============================================================================
+ *
+ *   file     : 출력 블록을 파일에 기록 (기본)
+ *   null     : 결과를 블록에 인코딩만 하고 버림 (디스크 쓰기 없이 조인 + 인코딩 시간)
+ *   count    : 인코딩도 하지 않고 개수만 셈 (순수 조인 처리량)
+ *   checksum : 인코딩한 결과 행마다 64비트 해시를 구해 더함 (mod 2^64)
+ *
+ * checksum은 덧셈이라 행 순서와 관계없고 메모리는 O(1)이다. 같은 결과 멀티셋이면
+ * BNLJ / 해시 / 병렬 조인의 값이 같다. 행 해시는 파일에 쓰였을 레코드 바이트 그대로의
+ * hashBytes()이므로 값은 출력 형식(JoinResultRecord 인코딩)이 바뀌면 함께 바뀐다.
+ */
+
+enum class SinkMode {
+    FILE,
+    NULL_SINK,
+    COUNT,
+    CHECKSUM
+};
+
+// "file" / "null" / "count" / "checksum" 파싱 (그 외는 예외)
+SinkMode parseSinkMode(const std::string& name);
+const char* sinkModeName(SinkMode mode);
+
+// 체크섬 표시 형식 ("0x" + 16자리 16진수)
+std::string checksumString(uint64_t checksum);
+
+class ResultSink {
+private:
+    SinkMode mode;
+    StatisticsRef stats;
+    std::unique_ptr<TableWriter> writer;   // FILE 모드만
+    uint64_t checksum;
+    MemoryGrant* grant;                    // 연결되면 라이터 메모리를 예약에 더함
+    size_t granted_bytes;
+
+public:
+    // FILE 모드면 output_file을 만들고 JOIN 테이블로 표시
+    ResultSink(SinkMode sink_mode, const std::string& output_file, StatisticsRef st);
+
+    SinkMode getMode() const { return mode; }
+
+    // 결과 행을 블록에 인코딩해야 하는지 (COUNT는 개수만 셈)
+    bool encodesRows() const { return mode != SinkMode::COUNT; }
+
+    // 가득 찬 (또는 마지막) 출력 블록 전달. 호출 후 블록은 비워도 됨
+    void writeBlock(const Block* block);
+
+    // 파일 닫기, CHECKSUM이면 stats에 결과 기록
+    void close();
+
+    uint64_t getChecksum() const { return checksum; }
+
+    // FILE 모드 라이터가 쓰는 메모리(스트림 버퍼, 쓴 블록마다 자라는 존 맵)를 grant에 더하고
+    // 블록을 쓸 때마다 늘어난 만큼 더 받음 (존 맵을 늘려 받지 못하면 출력 존 맵을 버림)
+    // close()에서 반납
+    void setMemoryGrant(MemoryGrant* memory_grant);
+};
+
+#endif // RESULT_SINK_H
@@ -0,0 +1,89 @@
+#ifndef STAT_SHARDS_H
+#define STAT_SHARDS_H
+
+#include "common.h"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * ============================================================================
+ * 스레드별 통계 샤드
+ * ============================================================================
+ *
+ * 여러 스레드가 같은 Statistics를 ++로 올리면 데이터 경쟁이고, 원자 변수로 바꾸면
+ * 블록마다 코어 사이에 캐시 라인이 오간다. 대신 스레드마다 자기 샤드(Statistics 사본)에
+ * 잠금 없이 올리고, 단계가 끝나 작업 스레드가 모두 멈춘 뒤 merge()로 대상에 더한다.
+ *
+ * - 샤드는 앞뒤로 캐시 라인 하나씩 채워 다른 샤드/객체와 같은 라인을 쓰지 않음
+ *   (C++14 new는 64바이트 정렬을 보장하지 않으므로 alignas 대신 양쪽 채움)
+ * - 샤드를 만든 스레드(연산자를 실행하는 스레드)는 대상에 직접 올림.
+ *   연산자 자신이 stats.output_records++ 하던 코드가 그대로 맞음
+ * - 다른 스레드는 처음 local()을 부를 때 한 번만 잠금을 잡고 샤드를 등록하고,
+ *   이후에는 스레드 로컬 캐시에서 찾음
+ *
+ * 더하는 값: 블록/버퍼 카운터, output_records, phase_ticks, result_checksum (덧셈 체크섬).
+ * 시간, 메모리, 하드웨어 카운터는 연산자가 대상에 직접 기록한다.
+ *
+ * 사용처는 여러 스레드가 리더를 돌리는 병렬 스캔(--analyze, table_stats.cpp)뿐이다.
+ * 조인 연산자는 단일 스레드로 돌므로 리더/라이터에 Statistics*를 그대로 넘긴다.
+ */
+
+// 거짓 공유를 피할 간격 (바이트)
+#define STAT_CACHE_LINE_SIZE 64
+
+// from의 누적 카운터를 into에 더함
+void addStatistics(Statistics& into, const Statistics& from);
+
+class StatisticsShards {
+private:
+    struct Shard {
+        char pad_front[STAT_CACHE_LINE_SIZE];
+        Statistics counters;
+        char pad_back[STAT_CACHE_LINE_SIZE];
+        std::thread::id thread;
+    };
+
+    Statistics* target;              // nullptr이면 세지 않음
+    std::thread::id owner;
+    uint64_t generation;             // 스레드 캐시 키 (주소 재사용과 구분)
+    std::mutex mutex;                // 샤드 등록과 merge()만
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    // 이 스레드의 샤드 찾기/등록 (캐시 미스)
+    Statistics* registerThread();
+
+public:
+    explicit StatisticsShards(Statistics* merge_target);
+
+    StatisticsShards(const StatisticsShards&) = delete;
+    StatisticsShards& operator=(const StatisticsShards&) = delete;
+
+    // 호출한 스레드가 올릴 Statistics (대상이 없으면 nullptr)
+    Statistics* local();
+
+    // 모든 샤드를 대상에 더하고 비움 (샤드에 쓰는 스레드가 없을 때 호출)
+    void merge();
+
+    Statistics* getTarget() const { return target; }
+};
+
+// 리더/라이터가 통계를 올릴 곳: 한 스레드만 쓰는 Statistics 또는 스레드별 샤드
+class StatisticsRef {
+private:
+    Statistics* stats;
+    StatisticsShards* shards;
+
+public:
+    StatisticsRef() : stats(nullptr), shards(nullptr) {}
+    StatisticsRef(std::nullptr_t) : stats(nullptr), shards(nullptr) {}
+    StatisticsRef(Statistics* st) : stats(st), shards(nullptr) {}
+    StatisticsRef(StatisticsShards* sh) : stats(nullptr), shards(sh) {}
+
+    // 호출한 스레드가 올릴 Statistics (없으면 nullptr)
+    Statistics* get() const { return shards ? shards->local() : stats; }
+};
+
+#endif // STAT_SHARDS_H
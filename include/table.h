@@ -4,9 +4,26 @@
 #include "common.h"
 #include "record.h"
 #include "block.h"
+#include "zone_map.h"
+#include "file_header.h"
+#include "stat_shards.h"
 #include <string>
 #include <vector>
 #include <fstream>
+#include <memory>
+#include <stdexcept>
+
+// 테이블 타입별 컬럼 타입 목록 ("PART", "PARTSUPP", "JOIN")
+// 레코드의 필드 순서와 동일
+const std::vector<ColumnType>& getTableSchema(const std::string& table_type);
+
+// 테이블 타입별 컬럼 이름 목록 (소문자, 레코드 필드 순서)
+const std::vector<std::string>& getTableColumnNames(const std::string& table_type);
+
+// 컬럼 이름 → 필드 인덱스 (없으면 예외)
+size_t getColumnIndex(const std::string& table_type, const std::string& column_name);
+
+class PartDictionary;
 
 // TPC-H PART 테이블 스키마
 struct PartRecord {
@@ -23,11 +40,21 @@ struct PartRecord {
     // Record로 변환
     Record toRecord() const;
 
-    // Record에서 생성
-    static PartRecord fromRecord(const Record& rec);
+    // 블록에 직접 인코딩 (toRecord()와 동일한 바이트, 공간 부족 시 false)
+    bool writeTo(RecordBuilder& builder) const;
+
+    // 딕셔너리 인코딩으로 블록에 기록 (새 값은 딕셔너리에 추가)
+    bool writeTo(RecordBuilder& builder, PartDictionary* dict) const;
+
+    // Record에서 생성 (dict가 있으면 딕셔너리 코드를 문자열로 복원)
+    static PartRecord fromRecord(const Record& rec, const PartDictionary* dict = nullptr);
 
     // CSV 라인에서 파싱
     static PartRecord fromCSV(const std::string& line);
+    static PartRecord fromCSV(const char* begin, const char* end);
+
+    // 문자열 필드가 힙에 할당한 바이트 (메모리 예산 추적용)
+    size_t heapBytes() const;
 };
 
 // TPC-H PARTSUPP 테이블 스키마
@@ -41,11 +68,18 @@ struct PartSuppRecord {
     // Record로 변환
     Record toRecord() const;
 
+    // 블록에 직접 인코딩 (toRecord()와 동일한 바이트, 공간 부족 시 false)
+    bool writeTo(RecordBuilder& builder) const;
+
     // Record에서 생성
     static PartSuppRecord fromRecord(const Record& rec);
 
     // CSV 라인에서 파싱
     static PartSuppRecord fromCSV(const std::string& line);
+    static PartSuppRecord fromCSV(const char* begin, const char* end);
+
+    // 문자열 필드가 힙에 할당한 바이트 (메모리 예산 추적용)
+    size_t heapBytes() const;
 };
 
 // Join 결과 레코드
@@ -55,53 +89,236 @@ struct JoinResultRecord {
 
     // Record로 변환
     Record toRecord() const;
+
+    // 블록에 직접 인코딩 (공간 부족 시 롤백 후 false)
+    bool writeTo(RecordBuilder& builder) const { return encode(builder, part, partsupp); }
+
+    // 결과 레코드를 만들지 않고 두 입력 레코드를 바로 출력 블록에 인코딩
+    static bool encode(RecordBuilder& builder, const PartRecord& part,
+                       const PartSuppRecord& partsupp);
 };
 
+class BufferManager;
+
+// 파일 스트림이 내부에서 쓰는 버퍼 크기 (libstdc++ filebuf 기본값, 메모리 예산 추적용)
+#define TABLE_STREAM_BUFFER_BYTES 8192
+
 // 테이블 리더 클래스
+// 일반 블록 파일과 압축 블록 파일(compression.h)을 모두 읽음
+// 존 맵 사이드카가 있으면 setKeyRange()로 범위 밖 블록을 건너뜀
+// 버퍼 풀을 연결하면 (파일, 블록 번호) 페이지 캐시를 거쳐 읽음
 class TableReader {
 private:
     std::string filename;
     std::ifstream file;
     size_t block_size;
-    Statistics* stats;
+    StatisticsRef stats;           // 병렬 스캔(--analyze)은 스레드별 샤드를 넘김 (stat_shards.h)
+
+    // 파일 헤더 (없는 이전 형식 파일이면 has_header = false)
+    FileHeader header;
+    bool has_header;
+    uint64_t data_start;           // 첫 블록(또는 압축 파일 헤더) 위치
+
+    // 압축 파일 상태
+    bool compressed;
+    std::vector<char> staging;     // 마지막으로 읽은 물리 블록
+    size_t staging_pos;
+    size_t staging_len;
+    std::vector<char> frame;       // 압축 프레임 조립 버퍼
+
+    // 존 맵 상태
+    std::unique_ptr<ZoneMap> zone_map;
+    size_t next_block;             // 다음에 읽을 블록 번호
+    bool range_active;
+    int_t range_lo;
+    int_t range_hi;
+    bool need_seek;                // 건너뛴 뒤 다음 블록 위치로 이동 필요
+
+    // 버퍼 풀 상태
+    BufferManager* pool;
+    uint32_t pool_file_id;
+    uint64_t logical_pos;               // 압축 파일에서 다음에 소비할 바이트 위치
+    std::vector<uint64_t> frame_offsets; // 압축 파일: 지금까지 알게 된 블록별 프레임 위치
+
+    // 물리 블록 단위로 n 바이트 읽기 (파일 끝이면 false)
+    bool readPhysical(char* dst, size_t n);
+
+    // 파일에서 next_block 블록 읽기 (버퍼 풀을 거치지 않음)
+    bool readFromFile(Block* block);
+
+    // next_block 위치로 파일 포인터 이동
+    void positionAtNextBlock();
+
+    // 사이드카 로드 및 파일 크기와 일치하는지 검증
+    void loadZoneMap();
+
+    // 파일 내 위치로 이동 (압축 스테이징 초기화)
+    void seekTo(uint64_t offset);
 
 public:
     TableReader(const std::string& fname, size_t blk_size = DEFAULT_BLOCK_SIZE,
-                Statistics* st = nullptr);
+                StatisticsRef st = nullptr);
     ~TableReader();
 
-    // 다음 블록 읽기
+    // 다음 블록 읽기 (압축 파일이면 프레임을 block으로 복원)
     bool readBlock(Block* block);
 
     // 파일 처음으로 되돌리기
     void reset();
 
+    // index번째 블록부터 읽도록 이동 (존 맵이 없는 압축 파일은 앞 블록을 읽어 넘김)
+    void seekBlock(size_t index);
+    size_t getBlockIndex() const { return next_block; }
+
     // 파일이 열려있는지 확인
     bool isOpen() const { return file.is_open(); }
+
+    // 압축 파일인지 확인
+    bool isCompressed() const { return compressed; }
+
+    // 파일 헤더 (없으면 nullptr)
+    const FileHeader* getHeader() const { return has_header ? &header : nullptr; }
+
+    // 키 범위 [lo, hi]와 겹치지 않는 블록 건너뛰기 (존 맵이 없으면 효과 없음)
+    void setKeyRange(int_t lo, int_t hi);
+    void clearKeyRange() { range_active = false; }
+
+    // 존 맵 접근 (없으면 nullptr)
+    const ZoneMap* getZoneMap() const { return zone_map.get(); }
+
+    // 리더가 쓰는 메모리 (스트림 버퍼, 스테이징/압축 프레임 버퍼, 존 맵. 블록은 제외)
+    size_t memoryBytes() const;
+
+    // 버퍼 풀 연결 (nullptr이면 해제). 이후 readBlock()은 페이지 캐시를 먼저 확인
+    void setBufferPool(BufferManager* buffer_pool);
 };
 
 // 테이블 라이터 클래스
+// 추가 쓰기 모드는 기존 파일을 다시 열어 마지막 행 페이지부터 이어서 채우고,
+// 헤더 개수와 존 맵을 새로 쓴 블록만큼 갱신한다 (기존 블록은 다시 읽지 않음)
 class TableWriter {
 private:
     std::string filename;
     std::ofstream file;
-    Statistics* stats;
+    StatisticsRef stats;
+
+    // 압축 모드 상태
+    bool compress;
+    bool header_written;
+    size_t bytes_written;
+    size_t physical_block_size;
+    std::vector<char> compressed_page;
+    size_t codec_counts[4];
+
+    // 블록별 키 범위 (닫을 때 사이드카로 저장)
+    ZoneMap zone_map;
+    bool zone_map_valid;
+    bool closed;
+
+    // 닫을 때 파일 맨 앞에 기록할 메타데이터
+    FileHeader header;
+
+    // 추가 쓰기 모드 상태
+    bool append;
+    std::unique_ptr<Block> tail;   // 다시 채울 마지막 행 페이지
+    bool tail_pending;             // tail을 아직 다시 쓰지 않음
+    uint64_t original_size;        // 추가 쓰기 전 파일 크기
+
+    // 기존 파일의 헤더/존 맵/마지막 페이지를 읽고 쓰기 위치 설정
+    void openForAppend();
+
+    // 물리 쓰기 통계 갱신 (block_size 경계를 넘은 만큼)
+    void accountPhysicalWrite(size_t bytes);
 
 public:
-    TableWriter(const std::string& fname, Statistics* st = nullptr);
+    // append_mode면 기존 파일 뒤에 이어서 씀 (압축 여부는 기존 파일을 따름)
+    TableWriter(const std::string& fname, StatisticsRef st = nullptr, bool compress_pages = false,
+                bool append_mode = false);
     ~TableWriter();
 
     // 블록 쓰기
     bool writeBlock(const Block* block);
 
+    // 파일 닫기, 헤더 확정 및 존 맵 사이드카 저장 (소멸자에서도 호출)
+    void close();
+
+    // 헤더에 기록할 테이블 정보
+    void setTableType(const std::string& table_type) { header.table_type = table_type; }
+    void setRecordEncoding(RecordEncoding encoding) {
+        header.record_encoding = static_cast<uint8_t>(encoding);
+    }
+    void setDictionaryEncoded(bool encoded);
+
+    // 추가 쓰기 모드: 마지막 행 페이지를 block으로 옮겨 이어서 채우게 함
+    // (가져갈 페이지가 없으면 false, block은 비워진 상태 그대로)
+    bool takeTail(Block& block);
+
+    // 헤더 (추가 쓰기 모드에서는 기존 파일의 테이블 정보)
+    const FileHeader& getHeader() const { return header; }
+
+    // 라이터가 쓰는 메모리 (스트림 버퍼, 압축 페이지 버퍼, 존 맵, 추가 쓰기 페이지)
+    size_t memoryBytes() const;
+
+    // 다음 writeBlock()이 존 맵 배열을 늘리며 새로 할당할 바이트 (옛 배열은 그 뒤 해제)
+    size_t writeGrowthBytes() const;
+
+    // 존 맵을 버리고 더 기록하지 않음 (닫을 때 사이드카 없음, 메모리가 모자랄 때)
+    void dropZoneMap();
+
     // 파일이 열려있는지 확인
     bool isOpen() const { return file.is_open(); }
+
+    // 압축 모드에서 파일 크기 (바이트)
+    size_t getBytesWritten() const { return bytes_written; }
+
+    // 코덱별 페이지 수 출력 (압축 모드)
+    void printCompressionSummary() const;
+};
+
+// 레코드 스테이징 - 워커 스레드가 자기 블록들에 레코드를 인코딩해 두면
+// 메인 스레드가 입력 순서대로 출력 블록에 복사 (단일 스레드로 쓴 파일과 같은 결과)
+class RecordStaging {
+private:
+    std::vector<std::unique_ptr<Block>> runs;  // [record_size][body] 연속
+    size_t run_size;
+    RecordEncoding encoding;
+
+public:
+    RecordStaging(size_t blk_size, RecordEncoding enc = RecordEncoding::LENGTH_PREFIXED);
+
+    // writeTo(RecordBuilder&)를 가진 레코드 인코딩
+    template <typename RecordT>
+    void add(const RecordT& record) {
+        if (!runs.empty()) {
+            RecordBuilder builder(runs.back().get(), encoding);
+            if (record.writeTo(builder)) {
+                return;
+            }
+        }
+        runs.emplace_back(new Block(run_size));
+        RecordBuilder builder(runs.back().get(), encoding);
+        if (!record.writeTo(builder)) {
+            throw std::runtime_error("Record too large for block");
+        }
+    }
+
+    // 출력 블록에 순서대로 복사하고 가득 찬 블록은 writer로 기록. 복사한 레코드 수 반환
+    // (출력 블록보다 큰 레코드는 건너뛰고 oversized 증가)
+    size_t drainTo(Block& block, TableWriter& writer, size_t& oversized);
+
+    void clear() { runs.clear(); }
 };
 
-// CSV 파일을 블록 기반 파일로 변환
+// CSV 파일을 블록 기반 파일로 변환 (num_threads = 0이면 하드웨어 스레드 수)
+// append면 기존 블록 파일 뒤에 추가 (블록 크기/인코딩/압축/딕셔너리는 기존 파일을 따름)
 void convertCSVToBlocks(const std::string& csv_file,
                         const std::string& block_file,
                         const std::string& table_type,
-                        size_t block_size = DEFAULT_BLOCK_SIZE);
+                        size_t block_size = DEFAULT_BLOCK_SIZE,
+                        RecordEncoding encoding = RecordEncoding::LENGTH_PREFIXED,
+                        bool dictionary_encode = false,
+                        bool compress = false,
+                        size_t num_threads = 0,
+                        bool append = false);
 
 #endif // TABLE_H
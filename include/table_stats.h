@@ -0,0 +1,126 @@
+#ifndef TABLE_STATS_H
+#define TABLE_STATS_H
+
+#include "common.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <ostream>
+
+/**
+ * ============================================================================
+ * 테이블 통계 (ANALYZE)
+ * ============================================================================
+ *
+ * 블록 파일을 한 번 읽어 컬럼별 통계를 계산하고 사이드카(<file>.stats)에 저장한다.
+ * 블록 범위를 스레드별로 나눠 읽고, 스레드마다 모은 부분 통계를 마지막에 병합한다.
+ * 부분 통계는 모두 병합 가능한 형태다. 빈발 값 횟수 하한을 빼면 결과가 스레드 수와 무관하다.
+ *
+ * 컬럼별 통계:
+ *   - 값 개수, 빈 값(NULL) 개수, 평균 폭 (딕셔너리 코드는 복원한 문자열 기준)
+ *   - 최소/최대 (INT/DECIMAL은 수치, STRING은 사전 순)
+ *   - 등깊이(equi-depth) 히스토그램: 행 표본을 정렬해 STATS_HISTOGRAM_BUCKETS개 구간 경계 선택
+ *     표본은 행 위치 해시가 가장 작은 STATS_SAMPLE_SIZE개 (bottom-k, 병합해도 같은 표본)
+ *   - HyperLogLog 고유 값 추정 (2^STATS_HLL_PRECISION 레지스터, 병합은 레지스터별 최댓값)
+ *   - 조인 키(첫 번째 컬럼)의 빈발 값: Misra-Gries 카운터 STATS_HEAVY_COUNTERS개
+ *     (횟수는 하한, 오차는 레코드 수 / (카운터 수 + 1) 이하)
+ *     하한이 평균 빈도의 STATS_HEAVY_MIN_RATIO배를 넘는 값만 저장
+ *
+ * 사이드카 형식:
+ *   [magic 'DBST' (4B)][version (4B)][record_count (8B)][block_count (8B)]
+ *   [table_type (문자열)][column_count (4B)] + 컬럼마다:
+ *   [name][type (1B)][count (8B)][null_count (8B)][total_bytes (8B)][distinct (8B)]
+ *   [min_value][max_value][bucket_count (4B)][경계 × (bucket_count + 1)]
+ *   [heavy_count (4B)][(값, 횟수 (8B)) × heavy_count]
+ *   문자열은 [길이 (4B)][바이트]
+ */
+
+// 통계 파일 식별자 ('D','B','S','T' little-endian)
+#define TABLE_STATS_MAGIC 0x54534244u
+#define TABLE_STATS_VERSION 1
+
+#define STATS_HLL_PRECISION 12        // 레지스터 4096개 (표준 오차 약 1.6%)
+#define STATS_HISTOGRAM_BUCKETS 16
+#define STATS_SAMPLE_SIZE 8192
+#define STATS_HEAVY_COUNTERS 64
+#define STATS_HEAVY_KEPT 10           // 저장하는 빈발 값 개수
+#define STATS_HEAVY_MIN_RATIO 2.0     // 빈발 값 기준 (평균 빈도 대비)
+
+// 스레드 하나가 맡을 최소 블록 수
+#define STATS_MIN_BLOCKS_PER_THREAD 32
+
+// HyperLogLog 고유 값 개수 추정기
+class HyperLogLog {
+private:
+    std::vector<uint8_t> registers;
+
+public:
+    HyperLogLog() : registers(size_t(1) << STATS_HLL_PRECISION, 0) {}
+
+    void add(uint64_t hash);
+    void merge(const HyperLogLog& other);
+    double estimate() const;
+};
+
+// 64비트 해시 (바이트열)
+uint64_t hashBytes(const char* data, size_t size, uint64_t seed = 0);
+
+struct HeavyHitter {
+    std::string value;
+    uint64_t count;      // 하한
+};
+
+struct ColumnStats {
+    std::string name;
+    ColumnType type;
+    uint64_t count;                        // 값이 있는 행
+    uint64_t null_count;                   // 빈 값
+    uint64_t total_bytes;                  // 값 폭 합계
+    uint64_t distinct;                     // HyperLogLog 추정
+    std::string min_value;
+    std::string max_value;
+    std::vector<std::string> histogram;    // 구간 경계 (bucket_count + 1개, 비어 있으면 없음)
+    std::vector<HeavyHitter> heavy_hitters;
+
+    ColumnStats()
+        : type(ColumnType::STRING), count(0), null_count(0), total_bytes(0), distinct(0) {}
+
+    double averageWidth() const { return count > 0 ? double(total_bytes) / double(count) : 0.0; }
+    bool isNumeric() const { return type != ColumnType::STRING; }
+};
+
+class TableStats {
+public:
+    std::string table_type;
+    uint64_t record_count;
+    uint64_t block_count;
+    std::vector<ColumnStats> columns;
+
+    TableStats() : record_count(0), block_count(0) {}
+
+    // 레코드 하나의 평균 폭 (필드 값 합계)
+    double averageRecordWidth() const;
+
+    // 컬럼 값의 빈발 값 횟수 (목록에 없으면 0)
+    uint64_t heavyHitterCount(size_t column, const std::string& value) const;
+
+    static std::string sidecarPath(const std::string& block_file) { return block_file + ".stats"; }
+
+    void save(const std::string& block_file) const;
+    static std::unique_ptr<TableStats> loadIfExists(const std::string& block_file);
+
+    // 블록 파일 한 번 읽어 통계 계산 (num_threads = 0이면 하드웨어 스레드 수)
+    // io_stats가 있으면 블록 읽기 개수를 더함
+    static TableStats analyze(const std::string& block_file, const std::string& table_type,
+                              size_t block_size, size_t num_threads = 0,
+                              Statistics* io_stats = nullptr);
+
+    void print(std::ostream& out) const;
+};
+
+// 두 테이블의 조인 결과 크기 추정 (컬럼 left_col = right_col)
+// 빈발 값끼리는 횟수를 곱하고, 나머지 행은 |R|·|S| / max(고유 값 수)로 계산
+double estimateJoinSize(const TableStats& left, size_t left_col,
+                        const TableStats& right, size_t right_col);
+
+#endif // TABLE_STATS_H
@@ -0,0 +1,79 @@
+#ifndef TPCH_GEN_H
+#define TPCH_GEN_H
+
+#include "common.h"
+#include "record.h"
+#include "table.h"
+#include <string>
+#include <vector>
+
+class PartDictionary;
+
+/**
+ * ============================================================================
+ * 내장 TPC-H PART / PARTSUPP 데이터 생성기
+ * ============================================================================
+ *
+ * TPC-H 명세(4.2.3)의 값 분포를 따라 레코드를 만들어 CSV 없이 블록 파일로 바로 쓴다.
+ *
+ *   PART     : SF × 200,000행, P_PARTKEY = 1..N (빈틈 없음)
+ *              P_NAME = 색상 단어 92개 중 서로 다른 5개, P_MFGR = Manufacturer#[1,5],
+ *              P_BRAND = Brand#MN (N ∈ [1,5]), P_TYPE / P_CONTAINER = 음절 조합,
+ *              P_SIZE ∈ [1,50], P_RETAILPRICE = 명세 공식, P_COMMENT = 텍스트 [5,22]
+ *   PARTSUPP : 부품마다 공급자 4개, PS_SUPPKEY = 명세 공식 (S = SF × 10,000)
+ *              PS_AVAILQTY ∈ [1,9999], PS_SUPPLYCOST ∈ [1.00,1000.00], PS_COMMENT = 텍스트 [49,198]
+ *
+ * 주석 문자열은 명세의 문장 문법(명사구/동사구/전치사구/종결 기호)으로 만든 텍스트 풀에서
+ * 임의 위치·길이로 잘라낸다 (단어 가중치는 균등).
+ *
+ * 각 행은 (seed, 테이블, partkey)로 시드한 자체 난수열을 사용하므로 스레드 수나
+ * 생성 순서와 관계없이 같은 seed면 같은 파일이 만들어진다.
+ */
+
+// 기본 난수 시드
+#define TPCH_DEFAULT_SEED 19920101ull
+
+class TpchGenerator {
+private:
+    double scale_factor;
+    uint64_t seed;
+    size_t num_threads;
+    std::string text_pool;
+
+    // 명세 문법으로 텍스트 풀 생성
+    void buildTextPool();
+
+public:
+    TpchGenerator(double sf, uint64_t rng_seed = TPCH_DEFAULT_SEED, size_t threads = 0);
+
+    // 행 개수
+    size_t getPartCount() const;
+    size_t getSupplierCount() const;
+    size_t getPartSuppCount() const { return getPartCount() * 4; }
+
+    // 개별 행 생성 (partkey는 1부터, supplier_index는 0..3)
+    PartRecord makePart(int_t partkey) const;
+    PartSuppRecord makePartSupp(int_t partkey, int supplier_index) const;
+
+    // 테이블을 생성해 writer에 블록으로 기록. 생성한 레코드 개수 반환
+    // dict가 있으면 PART를 딕셔너리 인코딩 (코드 할당은 partkey 순서)
+    size_t generate(const std::string& table_type, TableWriter& writer,
+                    size_t block_size = DEFAULT_BLOCK_SIZE,
+                    RecordEncoding encoding = RecordEncoding::LENGTH_PREFIXED,
+                    PartDictionary* dict = nullptr);
+
+    size_t getThreadCount() const { return num_threads; }
+};
+
+// TPC-H 테이블을 생성해 블록 파일로 저장 (CSV 변환과 같은 옵션). 레코드 개수 반환
+size_t generateTpchTable(const std::string& block_file,
+                         const std::string& table_type,
+                         double scale_factor,
+                         uint64_t seed = TPCH_DEFAULT_SEED,
+                         size_t block_size = DEFAULT_BLOCK_SIZE,
+                         RecordEncoding encoding = RecordEncoding::LENGTH_PREFIXED,
+                         bool dictionary_encode = false,
+                         bool compress = false,
+                         size_t num_threads = 0);
+
+#endif // TPCH_GEN_H
@@ -0,0 +1,98 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "common.h"
+#include <atomic>
+#include <string>
+
+/**
+ * ============================================================================
+ * 실행 타임라인 (--trace, Chrome / Perfetto trace-event JSON)
+ * ============================================================================
+ *
+ * 범위(span)마다 시작 시각, 길이, 스레드를 기록해 chrome://tracing이나
+ * https://ui.perfetto.dev에서 스레드별 타임라인으로 볼 수 있게 한다.
+ * CSV 변환/데이터 생성/통계 수집의 작업 스레드가 어디서 노는지, 조인의 각 단계가 어디서
+ * 시간을 쓰는지 확인하는 용도. 조인은 모두 단일 스레드라 조인 범위는 "main" 한 줄에만 나온다
+ * (MultithreadedJoin / PrefetchingJoin은 아직 BNLJ로 대신 실행하므로 따로 기록할 범위가 없음).
+ *
+ * 기록은 스레드마다 따로 가진 버퍼에 잠금 없이 추가한다. 버퍼는 스레드가 처음 기록할 때
+ * 한 번만 (잠금을 잡고) 전역 목록에 등록하고, 고정 크기 청크를 malloc으로 이어 붙인다
+ * (할당 추적 통계에 섞이지 않게 operator new를 쓰지 않음). 스레드가 끝나도 버퍼는
+ * 남아 있다가 프로세스 종료 시 한 파일로 기록된다 (그때는 모든 작업 스레드가 끝난 뒤).
+ *
+ * 사용:
+ *   TRACE_SPAN("hash build", "join");          // 범위 끝까지
+ *   TraceSpan span("chunk load", "join");
+ *   span.setArg("records", n);                 // 숫자 인자 하나 (선택)
+ *   span.end();                                // 범위 끝 전에 닫기 (선택)
+ *
+ * 이름과 분류는 문자열 리터럴이어야 한다 (포인터만 저장).
+ * 꺼져 있으면 범위마다 원자 변수 하나만 읽는다.
+ */
+
+class Trace {
+public:
+    // 기록 시작 (path: 종료 시 쓸 파일). 종료 시 자동으로 기록하도록 atexit에 등록
+    static void start(const std::string& path);
+
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+    // 지금까지의 기록을 파일로 쓰고 기록 종료 (두 번째 호출부터는 아무것도 안 함)
+    static void finish();
+
+    // 현재 스레드의 타임라인 이름 (기본: 처음 기록한 스레드는 "main", 나머지는 "worker N")
+    static void setThreadName(const char* name);
+
+    // 기록 시작 이후 나노초
+    static uint64_t now();
+
+    // 완료된 범위 하나 기록
+    static void record(const char* name, const char* category, uint64_t start_ns,
+                       uint64_t end_ns, const char* arg_name, uint64_t arg_value);
+
+private:
+    static std::atomic<bool> active;
+};
+
+class TraceSpan {
+private:
+    const char* name;
+    const char* category;
+    const char* arg_name;
+    uint64_t arg_value;
+    uint64_t start;
+    bool enabled;
+
+public:
+    TraceSpan(const char* span_name, const char* span_category)
+        : name(span_name), category(span_category), arg_name(nullptr), arg_value(0),
+          start(0), enabled(Trace::enabled()) {
+        if (enabled) {
+            start = Trace::now();
+        }
+    }
+    ~TraceSpan() { end(); }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    void setArg(const char* key, uint64_t value) {
+        arg_name = key;
+        arg_value = value;
+    }
+
+    // 범위를 일찍 끝냄 (이후 소멸자는 아무것도 안 함)
+    void end() {
+        if (enabled) {
+            Trace::record(name, category, start, Trace::now(), arg_name, arg_value);
+            enabled = false;
+        }
+    }
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SPAN(name, category) TraceSpan TRACE_CONCAT(trace_span_, __LINE__)((name), (category))
+
+#endif // TRACE_H
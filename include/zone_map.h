@@ -0,0 +1,80 @@
+#ifndef ZONE_MAP_H
+#define ZONE_MAP_H
+
+#include "common.h"
+#include "block.h"
+#include <string>
+#include <vector>
+#include <memory>
+
+/**
+ * ============================================================================
+ * 존 맵 (블록별 partkey 최소/최대)
+ * ============================================================================
+ *
+ * TableWriter가 블록을 쓸 때마다 첫 번째 필드(partkey)의 최소/최대값과
+ * 블록의 파일 내 위치를 기록하고, 파일을 닫을 때 사이드카(<block_file>.zmap)로 저장한다.
+ * TableReader는 키 범위가 지정되면 범위와 겹치지 않는 블록을 읽지 않고 건너뛴다.
+ *
+ * 정렬/클러스터된 파일에서는 범위 조건 스캔이나 조인의 inner 스캔이
+ * 몇 개 블록 읽기로 줄어든다.
+ *
+ * 사이드카 형식:
+ *   [magic 'ZMAP' (4B)][entry_count (4B)]
+ *   [entry × entry_count] - [min_key (4B)][max_key (4B)][offset (8B)][record_count (4B)][flags (4B)]
+ */
+
+// 사이드카 파일 식별자 ('Z','M','A','P' little-endian)
+#define ZONE_MAP_MAGIC 0x50414D5Au
+
+// 블록 내부 레코드가 키 순으로 정렬되어 있음
+#define ZONE_FLAG_SORTED 0x1u
+
+struct ZoneEntry {
+    int_t min_key;
+    int_t max_key;
+    uint64_t offset;        // 파일 내 블록(압축 파일은 프레임) 시작 위치
+    uint32_t record_count;
+    uint32_t flags;
+
+    bool isSorted() const { return (flags & ZONE_FLAG_SORTED) != 0; }
+    bool overlaps(int_t lo, int_t hi) const {
+        return record_count > 0 && min_key <= hi && max_key >= lo;
+    }
+};
+
+class ZoneMap {
+private:
+    std::vector<ZoneEntry> entries;
+
+public:
+    // 블록의 키 범위 계산 (행/PAX 페이지). 첫 필드가 정수가 아니면 false
+    static bool computeEntry(const Block* block, uint64_t offset, ZoneEntry& entry);
+
+    void add(const ZoneEntry& entry) { entries.push_back(entry); }
+    void removeLast() { entries.pop_back(); }
+    void clear() { entries.clear(); }
+    void swap(ZoneMap& other) { entries.swap(other.entries); }
+
+    size_t size() const { return entries.size(); }
+    size_t capacity() const { return entries.capacity(); }
+    bool empty() const { return entries.empty(); }
+    const ZoneEntry& get(size_t idx) const { return entries[idx]; }
+    const std::vector<ZoneEntry>& getEntries() const { return entries; }
+
+    // 파일 전체 키 범위 (비어 있으면 false)
+    bool getKeyRange(int_t& lo, int_t& hi) const;
+
+    // 파일 전체가 키 순으로 정렬되어 있는지 (블록 내부 정렬 + 블록 간 비감소)
+    bool isSorted() const;
+
+    // 사이드카 파일 경로
+    static std::string sidecarPath(const std::string& block_file) { return block_file + ".zmap"; }
+
+    // 사이드카 저장/로드/삭제
+    void save(const std::string& block_file) const;
+    static std::unique_ptr<ZoneMap> loadIfExists(const std::string& block_file);
+    static void remove(const std::string& block_file);
+};
+
+#endif // ZONE_MAP_H
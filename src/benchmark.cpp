@@ -0,0 +1,376 @@
+#include "benchmark.h"
+#include "file_header.h"
+#include "join_planner.h"
+#include "memory_tracker.h"
+#include "phase_timer.h"
+#include "tpch_gen.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 조인이 출력하는 보고서를 버림 (반복마다 수십 줄)
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+class QuietStdout {
+private:
+    NullBuffer null_buffer;
+    std::streambuf* saved;
+
+public:
+    QuietStdout() : saved(std::cout.rdbuf(&null_buffer)) {}
+    ~QuietStdout() { std::cout.rdbuf(saved); }
+};
+
+// 정렬된 값의 백분위수 (nearest-rank)
+double percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+#ifdef __linux__
+// 전역 페이지 캐시 비우기 (root 권한 필요, 실패하면 false)
+bool dropGlobalCache() {
+    sync();
+    int fd = open("/proc/sys/vm/drop_caches", O_WRONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = write(fd, "3", 1) == 1;
+    close(fd);
+    return ok;
+}
+
+// 파일 하나의 캐시된 페이지 버리기 (더러운 페이지는 먼저 기록)
+void dropFileCache(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+#endif
+
+} // namespace
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+std::vector<size_t> parseSizeList(const std::string& text) {
+    std::vector<size_t> values;
+    for (const auto& item : splitList(text)) {
+        size_t pos = 0;
+        unsigned long value = 0;
+        try {
+            value = std::stoul(item, &pos);
+        } catch (const std::exception&) {
+            pos = 0;
+        }
+        if (pos != item.size() || value == 0) {
+            throw std::runtime_error("Invalid number in list: " + text);
+        }
+        values.push_back(value);
+    }
+    return values;
+}
+
+// ============================================================================
+// BenchmarkRunner
+// ============================================================================
+BenchmarkRunner::BenchmarkRunner(const BenchmarkConfig& cfg)
+    : config(cfg), global_drop(false) {
+    if (config.algorithms.empty() || config.buffer_sizes.empty() || config.block_sizes.empty()) {
+        throw std::runtime_error("Benchmark needs at least one algorithm, buffer size and block size");
+    }
+    if (config.repetitions == 0) {
+        throw std::runtime_error("Benchmark needs at least one repetition");
+    }
+    for (const auto& algorithm : config.algorithms) {
+        if (algorithm == "mt") {
+            // MultithreadedJoin::execute()는 아직 단일 스레드 BNLJ라 측정할 차이가 없음
+            throw std::runtime_error("Benchmark algorithm mt is not supported: the multithreaded "
+                                     "join still runs single-threaded BNLJ");
+        }
+        if (algorithm != "bnlj" && algorithm != "hash" && algorithm != "auto") {
+            throw std::runtime_error("Unknown benchmark algorithm: " + algorithm +
+                                     " (use bnlj, hash or auto)");
+        }
+    }
+
+    // 기존 파일은 헤더의 블록 크기로만 읽을 수 있음 (실행 전에 확인)
+    FileHeader header;
+    if (config.scale_factor <= 0 && readFileHeader(config.outer_table, header) &&
+        header.block_size != 0) {
+        for (size_t block_size : config.block_sizes) {
+            if (block_size != header.block_size) {
+                throw std::runtime_error("Block size " + std::to_string(block_size) +
+                                         " does not match " + config.outer_table + " (" +
+                                         std::to_string(header.block_size) +
+                                         " bytes); use --scale-factor to sweep block sizes");
+            }
+        }
+    }
+}
+
+void BenchmarkRunner::prepareInputs(size_t block_size, std::string& outer, std::string& inner) {
+    if (config.scale_factor <= 0) {
+        outer = config.outer_table;
+        inner = config.inner_table;
+        return;
+    }
+
+    // 블록 크기마다 같은 seed로 생성
+    std::string suffix = "-" + std::to_string(block_size) + ".dat";
+    outer = config.output_file + ".part" + suffix;
+    inner = config.output_file + ".partsupp" + suffix;
+    QuietStdout quiet;
+    generateTpchTable(outer, "PART", config.scale_factor, config.seed, block_size);
+    generateTpchTable(inner, "PARTSUPP", config.scale_factor, config.seed, block_size);
+}
+
+Statistics BenchmarkRunner::runOnce(const std::string& algorithm, const std::string& outer,
+                                    const std::string& inner, size_t buffer_size,
+                                    size_t block_size) const {
+    std::string outer_type = config.scale_factor > 0 ? "PART" : config.outer_type;
+    std::string inner_type = config.scale_factor > 0 ? "PARTSUPP" : config.inner_type;
+
+    QuietStdout quiet;
+    // --join --algorithm과 같은 경로 (지정한 알고리즘은 첫 테이블이 outer/build)
+    bool auto_select = false;
+    JoinAlgorithm chosen = parseJoinAlgorithm(algorithm, auto_select);
+    JoinPlanner planner(outer, outer_type, inner, inner_type, config.output_file,
+                        buffer_size, block_size);
+    planner.setSink(config.sink);
+    planner.plan();
+    planner.execute(auto_select ? planner.chooseBest() : planner.findCandidate(chosen, true));
+    return planner.getStatistics();
+}
+
+void BenchmarkRunner::dropCaches(const std::string& outer, const std::string& inner) const {
+#ifdef __linux__
+    if (global_drop && dropGlobalCache()) {
+        return;
+    }
+    dropFileCache(outer);
+    dropFileCache(inner);
+    dropFileCache(config.output_file);
+#else
+    (void)outer;
+    (void)inner;
+#endif
+}
+
+void BenchmarkRunner::run(std::ostream& out) {
+    results.clear();
+
+    if (config.drop_caches) {
+#ifdef __linux__
+        global_drop = dropGlobalCache();
+        out << "Page Cache: dropped before every run ("
+            << (global_drop ? "/proc/sys/vm/drop_caches" : "posix_fadvise on input/output files")
+            << ")" << std::endl;
+#else
+        out << "Page Cache: dropping is only supported on Linux, runs use a warm cache" << std::endl;
+#endif
+    }
+
+    size_t total = config.algorithms.size() * config.buffer_sizes.size() * config.block_sizes.size();
+
+    size_t index = 0;
+    for (size_t block_size : config.block_sizes) {
+        std::string outer, inner;
+        prepareInputs(block_size, outer, inner);
+
+        for (size_t buffer_size : config.buffer_sizes) {
+            for (const auto& algorithm : config.algorithms) {
+                BenchmarkResult result;
+                result.algorithm = algorithm;
+                result.buffer_size = buffer_size;
+                result.block_size = block_size;
+
+                out << "[" << ++index << "/" << total << "] " << algorithm
+                    << " buffer=" << buffer_size << " block=" << block_size << " ..." << std::flush;
+
+                for (size_t rep = 0; rep < config.warmups + config.repetitions; ++rep) {
+                    if (config.drop_caches) {
+                        dropCaches(outer, inner);
+                    }
+                    TraceSpan span("benchmark run", "bench");
+                    auto start = std::chrono::steady_clock::now();
+                    Statistics stats = runOnce(algorithm, outer, inner, buffer_size, block_size);
+                    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                    span.end();
+
+                    if (rep < config.warmups) {
+                        continue;
+                    }
+                    if (!result.times.empty() &&
+                        (stats.output_records != result.stats.output_records ||
+                         stats.result_checksum != result.stats.result_checksum)) {
+                        std::cerr << "\nWarning: result changed between repetitions ("
+                                  << result.stats.output_records << " -> " << stats.output_records
+                                  << " rows)" << std::endl;
+                    }
+                    result.times.push_back(elapsed.count());
+                    result.stats = stats;
+                    result.tracked_memory_peak = std::max(result.tracked_memory_peak,
+                                                          stats.tracked_memory_peak);
+                }
+
+                std::vector<double> sorted = result.times;
+                std::sort(sorted.begin(), sorted.end());
+                result.median_time = sorted.size() % 2
+                    ? sorted[sorted.size() / 2]
+                    : (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2;
+                result.p95_time = percentile(sorted, 95);
+                result.min_time = sorted.front();
+                results.push_back(result);
+
+                out << " median " << std::fixed << std::setprecision(4) << result.median_time
+                    << " s" << std::endl;
+                out.unsetf(std::ios::fixed);
+                out << std::setprecision(6);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// 출력
+// ============================================================================
+void BenchmarkRunner::print(std::ostream& out) const {
+    out << "\nBenchmark Results (" << config.warmups << " warmup, " << config.repetitions
+        << " measured runs each, times in seconds):" << std::endl;
+    out << "  " << std::left << std::setw(6) << "alg" << std::right
+        << std::setw(7) << "buffer" << std::setw(7) << "block"
+        << std::setw(10) << "median" << std::setw(10) << "p95"
+        << std::setw(10) << "reads" << std::setw(10) << "writes"
+        << std::setw(11) << "output" << std::setw(12) << "peak KB" << std::endl;
+
+    out << std::fixed << std::setprecision(4);
+    for (const auto& r : results) {
+        out << "  " << std::left << std::setw(6) << r.algorithm << std::right
+            << std::setw(7) << r.buffer_size << std::setw(7) << r.block_size
+            << std::setw(10) << r.median_time << std::setw(10) << r.p95_time
+            << std::setw(10) << r.stats.block_reads << std::setw(10) << r.stats.block_writes
+            << std::setw(11) << r.stats.output_records
+            << std::setw(12) << r.tracked_memory_peak / 1024 << std::endl;
+    }
+    out.unsetf(std::ios::fixed);
+    out << std::setprecision(6);
+}
+
+void BenchmarkRunner::writeCsv(const std::string& path) const {
+    std::ofstream file;
+    if (path != "-") {
+        file.open(path);
+        if (!file) {
+            throw std::runtime_error("Cannot open benchmark CSV file: " + path);
+        }
+    }
+    std::ostream& out = path == "-" ? std::cout : file;
+
+    out << "algorithm,buffer_blocks,block_size,repetitions,"
+        << "median_seconds,p95_seconds,min_seconds,"
+        << "block_reads,block_writes,physical_block_reads,physical_block_writes,"
+        << "buffer_hits,buffer_misses,output_records,memory_usage_bytes,tracked_memory_peak_bytes,"
+        << "result_checksum\n";
+    out << std::setprecision(9);
+    for (const auto& r : results) {
+        out << r.algorithm << "," << r.buffer_size << "," << r.block_size << ","
+            << r.times.size() << ","
+            << r.median_time << "," << r.p95_time << "," << r.min_time << ","
+            << r.stats.block_reads << "," << r.stats.block_writes << ","
+            << r.stats.physical_block_reads << "," << r.stats.physical_block_writes << ","
+            << r.stats.buffer_hits << "," << r.stats.buffer_misses << ","
+            << r.stats.output_records << "," << r.stats.memory_usage << ","
+            << r.tracked_memory_peak << ","
+            << (r.stats.has_checksum ? checksumString(r.stats.result_checksum) : "") << "\n";
+    }
+    out << std::setprecision(6) << std::flush;
+}
+
+void BenchmarkRunner::writeJson(const std::string& path) const {
+    std::ofstream file;
+    if (path != "-") {
+        file.open(path);
+        if (!file) {
+            throw std::runtime_error("Cannot open benchmark JSON file: " + path);
+        }
+    }
+    std::ostream& out = path == "-" ? std::cout : file;
+
+    out << std::setprecision(9);
+    out << "{\n  \"config\": {\n";
+    if (config.scale_factor > 0) {
+        out << "    \"scale_factor\": " << config.scale_factor << ",\n"
+            << "    \"seed\": " << config.seed << ",\n";
+    } else {
+        out << "    \"outer_table\": " << jsonString(config.outer_table) << ",\n"
+            << "    \"inner_table\": " << jsonString(config.inner_table) << ",\n";
+    }
+    out << "    \"warmups\": " << config.warmups << ",\n"
+        << "    \"repetitions\": " << config.repetitions << ",\n"
+        << "    \"drop_caches\": " << (config.drop_caches ? "true" : "false") << ",\n"
+        << "    \"sink\": " << jsonString(sinkModeName(config.sink)) << ",\n"
+        << "    \"phase_timers\": " << (DBSYS_PHASE_TIMERS ? "true" : "false") << ",\n"
+        << "    \"alloc_tracking\": " << (DBSYS_TRACK_ALLOC ? "true" : "false") << "\n"
+        << "  },\n  \"results\": [";
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        out << (i > 0 ? "," : "") << "\n    {\n"
+            << "      \"algorithm\": " << jsonString(r.algorithm) << ",\n"
+            << "      \"buffer_blocks\": " << r.buffer_size << ",\n"
+            << "      \"block_size\": " << r.block_size << ",\n"
+            << "      \"median_seconds\": " << r.median_time << ",\n"
+            << "      \"p95_seconds\": " << r.p95_time << ",\n"
+            << "      \"min_seconds\": " << r.min_time << ",\n"
+            << "      \"seconds\": [";
+        for (size_t t = 0; t < r.times.size(); ++t) {
+            out << (t > 0 ? ", " : "") << r.times[t];
+        }
+        out << "],\n"
+            << "      \"block_reads\": " << r.stats.block_reads << ",\n"
+            << "      \"block_writes\": " << r.stats.block_writes << ",\n"
+            << "      \"physical_block_reads\": " << r.stats.physical_block_reads << ",\n"
+            << "      \"physical_block_writes\": " << r.stats.physical_block_writes << ",\n"
+            << "      \"buffer_hits\": " << r.stats.buffer_hits << ",\n"
+            << "      \"buffer_misses\": " << r.stats.buffer_misses << ",\n"
+            << "      \"output_records\": " << r.stats.output_records << ",\n"
+            << "      \"memory_usage_bytes\": " << r.stats.memory_usage << ",\n"
+            << "      \"tracked_memory_peak_bytes\": " << r.tracked_memory_peak;
+        if (r.stats.has_checksum) {
+            out << ",\n      \"result_checksum\": " << jsonString(checksumString(r.stats.result_checksum));
+        }
+        out << "\n    }";
+    }
+    out << "\n  ]\n}" << std::endl;
+    out << std::setprecision(6);
+}
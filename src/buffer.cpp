@@ -1,17 +1,177 @@
 #include "buffer.h"
 #include <stdexcept>
 
-BufferManager::BufferManager(size_t num_buffers, size_t blk_size)
-    : buffer_count(num_buffers), block_size(blk_size) {
+// ============================================================================
+// 교체 정책
+// ============================================================================
+
+ReplacementPolicy parseReplacementPolicy(const std::string& name) {
+    if (name == "clock") return ReplacementPolicy::CLOCK;
+    if (name == "lru-k" || name == "lruk") return ReplacementPolicy::LRU_K;
+    if (name == "mru") return ReplacementPolicy::MRU;
+    throw std::runtime_error("Unknown replacement policy: " + name + " (use clock, lru-k or mru)");
+}
+
+const char* replacementPolicyName(ReplacementPolicy policy) {
+    switch (policy) {
+        case ReplacementPolicy::CLOCK: return "clock";
+        case ReplacementPolicy::LRU_K: return "lru-k";
+        case ReplacementPolicy::MRU: return "mru";
+    }
+    return "unknown";
+}
+
+// CLOCK: 참조 비트가 켜진 프레임은 한 번 건너뛰고 비트를 끔
+ClockReplacer::ClockReplacer(size_t num_frames)
+    : referenced(num_frames, false), evictable(num_frames, false), hand(0) {}
+
+void ClockReplacer::recordAccess(size_t frame) {
+    referenced[frame] = true;
+}
+
+void ClockReplacer::setEvictable(size_t frame, bool value) {
+    evictable[frame] = value;
+}
+
+bool ClockReplacer::evict(size_t& frame) {
+    size_t n = referenced.size();
+    for (size_t step = 0; step < 2 * n; ++step) {
+        size_t current = hand;
+        hand = (hand + 1) % n;
+        if (!evictable[current]) {
+            continue;
+        }
+        if (referenced[current]) {
+            referenced[current] = false;
+            continue;
+        }
+        frame = current;
+        return true;
+    }
+    return false;
+}
+
+void ClockReplacer::remove(size_t frame) {
+    referenced[frame] = false;
+    evictable[frame] = false;
+}
+
+// LRU-K: K번째 최근 접근이 가장 오래된 프레임 (K번 미만 접근은 무한대 거리, 첫 접근이 오래된 순)
+LruKReplacer::LruKReplacer(size_t num_frames, size_t history_k)
+    : history(num_frames), evictable(num_frames, false), k(history_k), clock(0) {}
+
+void LruKReplacer::recordAccess(size_t frame) {
+    std::vector<uint64_t>& accesses = history[frame];
+    accesses.push_back(++clock);
+    if (accesses.size() > k) {
+        accesses.erase(accesses.begin());
+    }
+}
+
+void LruKReplacer::setEvictable(size_t frame, bool value) {
+    evictable[frame] = value;
+}
+
+bool LruKReplacer::evict(size_t& frame) {
+    bool found = false;
+    bool best_infinite = false;
+    uint64_t best_time = 0;
+
+    for (size_t i = 0; i < history.size(); ++i) {
+        if (!evictable[i]) {
+            continue;
+        }
+        // 기록의 첫 항목: K번 접근했으면 K번째 최근 접근, 아니면 첫 접근
+        bool infinite = history[i].size() < k;
+        uint64_t time = history[i].empty() ? 0 : history[i].front();
+
+        bool better = !found ||
+                      (infinite && !best_infinite) ||
+                      (infinite == best_infinite && time < best_time);
+        if (better) {
+            found = true;
+            best_infinite = infinite;
+            best_time = time;
+            frame = i;
+        }
+    }
+    return found;
+}
+
+void LruKReplacer::remove(size_t frame) {
+    history[frame].clear();
+    evictable[frame] = false;
+}
+
+// MRU: 가장 최근에 접근한 프레임
+MruReplacer::MruReplacer(size_t num_frames)
+    : last_access(num_frames, 0), evictable(num_frames, false), clock(0) {}
+
+void MruReplacer::recordAccess(size_t frame) {
+    last_access[frame] = ++clock;
+}
+
+void MruReplacer::setEvictable(size_t frame, bool value) {
+    evictable[frame] = value;
+}
+
+bool MruReplacer::evict(size_t& frame) {
+    bool found = false;
+    for (size_t i = 0; i < last_access.size(); ++i) {
+        if (evictable[i] && (!found || last_access[i] > last_access[frame])) {
+            frame = i;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void MruReplacer::remove(size_t frame) {
+    last_access[frame] = 0;
+    evictable[frame] = false;
+}
+
+// ============================================================================
+// BufferManager 구현
+// ============================================================================
+
+BufferManager::BufferManager(size_t num_buffers, size_t blk_size,
+                             size_t cache_frames, ReplacementPolicy replacement)
+    : buffer_count(num_buffers), block_size(blk_size), policy(replacement),
+      hits(0), misses(0), evictions(0), write_backs(0) {
 
     if (buffer_count == 0) {
         throw std::runtime_error("Buffer count must be at least 1");
     }
 
-    // 버퍼 할당
-    for (size_t i = 0; i < buffer_count; ++i) {
+    // 버퍼 할당 (작업 버퍼 뒤에 페이지 캐시 프레임). 프레임 수가 정해져 있으므로
+    // 목록과 페이지 테이블을 미리 잡아 실행 중에 커지지 않게 함 (frameBytes()와 맞춤)
+    buffers.reserve(buffer_count + cache_frames);
+    free_frames.reserve(cache_frames);
+    page_table.reserve(cache_frames);
+    for (size_t i = 0; i < buffer_count + cache_frames; ++i) {
         buffers.push_back(std::make_unique<Block>(block_size));
     }
+
+    frames.resize(cache_frames, FrameInfo{PageId{0, 0}, 0, false, false});
+    for (size_t i = cache_frames; i > 0; --i) {
+        free_frames.push_back(i - 1);
+    }
+
+    switch (policy) {
+        case ReplacementPolicy::CLOCK: replacer.reset(new ClockReplacer(cache_frames)); break;
+        case ReplacementPolicy::LRU_K: replacer.reset(new LruKReplacer(cache_frames)); break;
+        case ReplacementPolicy::MRU: replacer.reset(new MruReplacer(cache_frames)); break;
+    }
+}
+
+size_t BufferManager::frameBytes(size_t blk_size) {
+    // 페이지 테이블 노드: 다음 노드 포인터 + (페이지, 프레임) + 해시 값, 버킷 포인터 하나.
+    // 교체 정책은 가장 큰 LRU-K 기록 (K개를 넘기 직전까지 자란 용량)
+    size_t page_entry = 3 * sizeof(void*) + sizeof(PageId) + sizeof(size_t);
+    size_t replacer_entry = sizeof(std::vector<uint64_t>) + 2 * LRU_K_HISTORY * sizeof(uint64_t);
+    return blk_size + sizeof(std::unique_ptr<Block>) + sizeof(Block) + sizeof(FrameInfo) +
+           sizeof(size_t) + page_entry + replacer_entry;
 }
 
 Block* BufferManager::getBuffer(size_t idx) {
@@ -29,7 +189,130 @@ const Block* BufferManager::getBuffer(size_t idx) const {
 }
 
 void BufferManager::clearAll() {
-    for (auto& buffer : buffers) {
-        buffer->clear();
+    for (size_t i = 0; i < buffer_count; ++i) {
+        buffers[i]->clear();
+    }
+}
+
+uint32_t BufferManager::registerFile(const std::string& filename, PageWriter writer) {
+    auto it = file_ids.find(filename);
+    if (it != file_ids.end()) {
+        if (writer) {
+            page_writers[it->second] = writer;
+        }
+        return it->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(page_writers.size());
+    file_ids[filename] = id;
+    page_writers.push_back(writer);
+    return id;
+}
+
+bool BufferManager::allocateFrame(size_t& frame) {
+    if (!free_frames.empty()) {
+        frame = free_frames.back();
+        free_frames.pop_back();
+        return true;
+    }
+
+    if (!replacer->evict(frame)) {
+        return false;
+    }
+
+    // 내보내기: dirty면 기록 후 페이지 테이블에서 제거
+    writeBack(frame);
+    page_table.erase(frames[frame].page);
+    replacer->remove(frame);
+    frames[frame].in_use = false;
+    evictions++;
+    return true;
+}
+
+void BufferManager::writeBack(size_t frame) {
+    FrameInfo& info = frames[frame];
+    if (!info.in_use || !info.dirty) {
+        return;
+    }
+
+    const PageWriter& writer = page_writers[info.page.file_id];
+    if (!writer) {
+        throw std::runtime_error("Dirty page has no writer");
+    }
+    writer(info.page.page_no, *frameBlock(frame));
+    info.dirty = false;
+    write_backs++;
+}
+
+Block* BufferManager::fetchPage(uint32_t file_id, uint64_t page_no, const PageLoader& loader) {
+    PageId id{file_id, page_no};
+
+    auto it = page_table.find(id);
+    if (it != page_table.end()) {
+        size_t frame = it->second;
+        frames[frame].pin_count++;
+        replacer->recordAccess(frame);
+        replacer->setEvictable(frame, false);
+        hits++;
+        return frameBlock(frame);
+    }
+
+    misses++;
+    size_t frame;
+    if (!allocateFrame(frame)) {
+        return nullptr;
+    }
+
+    Block* block = frameBlock(frame);
+    block->clear();
+    if (!loader(block)) {
+        free_frames.push_back(frame);
+        return nullptr;
+    }
+
+    frames[frame] = FrameInfo{id, 1, false, true};
+    page_table[id] = frame;
+    replacer->recordAccess(frame);
+    replacer->setEvictable(frame, false);
+    return block;
+}
+
+void BufferManager::unpinPage(uint32_t file_id, uint64_t page_no, bool dirty) {
+    auto it = page_table.find(PageId{file_id, page_no});
+    if (it == page_table.end()) {
+        throw std::runtime_error("Unpin of a page that is not in the buffer pool");
+    }
+
+    FrameInfo& info = frames[it->second];
+    if (info.pin_count == 0) {
+        throw std::runtime_error("Unpin of a page that is not pinned");
+    }
+    info.dirty = info.dirty || dirty;
+    if (--info.pin_count == 0) {
+        replacer->setEvictable(it->second, true);
+    }
+}
+
+void BufferManager::flushAll() {
+    for (size_t frame = 0; frame < frames.size(); ++frame) {
+        writeBack(frame);
+    }
+}
+
+void BufferManager::invalidateFile(uint32_t file_id) {
+    for (size_t frame = 0; frame < frames.size(); ++frame) {
+        FrameInfo& info = frames[frame];
+        if (!info.in_use || info.page.file_id != file_id) {
+            continue;
+        }
+        if (info.pin_count > 0) {
+            throw std::runtime_error("Cannot invalidate a pinned page");
+        }
+
+        writeBack(frame);
+        page_table.erase(info.page);
+        replacer->remove(frame);
+        info.in_use = false;
+        free_frames.push_back(frame);
     }
 }
@@ -0,0 +1,337 @@
+#include "compression.h"
+#include <cstring>
+#include <stdexcept>
+
+// LZ 파라미터
+static const size_t LZ_MIN_MATCH = 4;
+static const size_t LZ_MAX_OFFSET = 65535;
+static const size_t LZ_HASH_BITS = 12;
+
+const char* getCodecName(CompressionCodec codec) {
+    switch (codec) {
+        case CompressionCodec::NONE: return "none";
+        case CompressionCodec::LZ: return "lz";
+        case CompressionCodec::RLE: return "rle";
+        case CompressionCodec::DELTA_LZ: return "delta-lz";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// LZ 코덱 (LZ4 시퀀스 형식)
+// ============================================================================
+//
+// 시퀀스: [token][literal_len 확장][literals][offset (2B)][match_len 확장]
+//   token 상위 4비트: 리터럴 길이 (15 이상이면 255 단위 확장 바이트)
+//   token 하위 4비트: 매치 길이 - 4 (15 이상이면 확장)
+// 마지막 시퀀스는 리터럴만 포함하고 offset이 없다.
+
+static uint32_t readWord(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(uint32_t));
+    return value;
+}
+
+static size_t hashWord(uint32_t value) {
+    return (value * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+static void writeLength(std::vector<char>& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(static_cast<char>(255));
+        length -= 255;
+    }
+    out.push_back(static_cast<char>(length));
+}
+
+static void emitSequence(std::vector<char>& out, const char* literals, size_t literal_len,
+                         size_t offset, size_t match_len) {
+    size_t lit_token = literal_len < 15 ? literal_len : 15;
+    size_t match_token = 0;
+    if (match_len > 0) {
+        size_t extra = match_len - LZ_MIN_MATCH;
+        match_token = extra < 15 ? extra : 15;
+    }
+    out.push_back(static_cast<char>((lit_token << 4) | match_token));
+
+    if (literal_len >= 15) {
+        writeLength(out, literal_len - 15);
+    }
+    out.insert(out.end(), literals, literals + literal_len);
+
+    if (match_len > 0) {
+        uint16_t off = static_cast<uint16_t>(offset);
+        out.push_back(static_cast<char>(off & 0xFF));
+        out.push_back(static_cast<char>(off >> 8));
+        if (match_len - LZ_MIN_MATCH >= 15) {
+            writeLength(out, match_len - LZ_MIN_MATCH - 15);
+        }
+    }
+}
+
+void lzCompress(const char* src, size_t size, std::vector<char>& out) {
+    out.clear();
+    out.reserve(size / 2 + 16);
+
+    std::vector<size_t> table(static_cast<size_t>(1) << LZ_HASH_BITS, SIZE_MAX);
+    size_t anchor = 0;
+    size_t pos = 0;
+
+    while (pos + LZ_MIN_MATCH <= size) {
+        uint32_t word = readWord(src + pos);
+        size_t h = hashWord(word);
+        size_t candidate = table[h];
+        table[h] = pos;
+
+        if (candidate != SIZE_MAX && pos - candidate <= LZ_MAX_OFFSET &&
+            readWord(src + candidate) == word) {
+            // 매치 연장
+            size_t match_len = LZ_MIN_MATCH;
+            while (pos + match_len < size && src[candidate + match_len] == src[pos + match_len]) {
+                match_len++;
+            }
+
+            emitSequence(out, src + anchor, pos - anchor, pos - candidate, match_len);
+            pos += match_len;
+            anchor = pos;
+        } else {
+            pos++;
+        }
+    }
+
+    // 남은 리터럴
+    emitSequence(out, src + anchor, size - anchor, 0, 0);
+}
+
+static size_t readLength(const unsigned char*& ip, const unsigned char* end) {
+    size_t length = 0;
+    unsigned char byte;
+    do {
+        if (ip >= end) {
+            throw std::runtime_error("Corrupt LZ stream: truncated length");
+        }
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return length;
+}
+
+void lzDecompress(const char* src, size_t size, char* dst, size_t raw_size) {
+    const unsigned char* ip = reinterpret_cast<const unsigned char*>(src);
+    const unsigned char* end = ip + size;
+    size_t op = 0;
+
+    while (ip < end) {
+        unsigned char token = *ip++;
+
+        size_t literal_len = token >> 4;
+        if (literal_len == 15) {
+            literal_len += readLength(ip, end);
+        }
+        if (literal_len > static_cast<size_t>(end - ip) || op + literal_len > raw_size) {
+            throw std::runtime_error("Corrupt LZ stream: literal overflow");
+        }
+        if (literal_len > 0) {
+            std::memcpy(dst + op, ip, literal_len);
+        }
+        ip += literal_len;
+        op += literal_len;
+
+        // 마지막 시퀀스
+        if (ip >= end) {
+            break;
+        }
+
+        if (end - ip < 2) {
+            throw std::runtime_error("Corrupt LZ stream: truncated offset");
+        }
+        size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+
+        size_t match_len = (token & 0x0F);
+        if (match_len == 15) {
+            match_len += readLength(ip, end);
+        }
+        match_len += LZ_MIN_MATCH;
+
+        if (offset == 0 || offset > op || op + match_len > raw_size) {
+            throw std::runtime_error("Corrupt LZ stream: invalid match");
+        }
+        // 겹치는 매치가 가능하므로 바이트 단위 복사
+        for (size_t i = 0; i < match_len; ++i) {
+            dst[op + i] = dst[op - offset + i];
+        }
+        op += match_len;
+    }
+
+    if (op != raw_size) {
+        throw std::runtime_error("Corrupt LZ stream: size mismatch");
+    }
+}
+
+// ============================================================================
+// RLE 코덱 (PackBits)
+// ============================================================================
+//
+// 제어 바이트 c < 128 : 이어지는 c + 1 바이트를 그대로 복사
+// 제어 바이트 c >= 128: 다음 1바이트를 (c - 128 + 3)번 반복 (3 ~ 130회)
+
+void rleCompress(const char* src, size_t size, std::vector<char>& out) {
+    out.clear();
+    out.reserve(size / 4 + 16);
+
+    size_t pos = 0;
+    while (pos < size) {
+        // 반복 길이 측정
+        size_t run = 1;
+        while (pos + run < size && run < 130 && src[pos + run] == src[pos]) {
+            run++;
+        }
+
+        if (run >= 3) {
+            out.push_back(static_cast<char>(128 + run - 3));
+            out.push_back(src[pos]);
+            pos += run;
+            continue;
+        }
+
+        // 리터럴 구간: 다음 3바이트 반복이 나올 때까지
+        size_t start = pos;
+        size_t len = 0;
+        while (pos < size && len < 128) {
+            if (pos + 2 < size && src[pos] == src[pos + 1] && src[pos] == src[pos + 2]) {
+                break;
+            }
+            pos++;
+            len++;
+        }
+        out.push_back(static_cast<char>(len - 1));
+        out.insert(out.end(), src + start, src + start + len);
+    }
+}
+
+void rleDecompress(const char* src, size_t size, char* dst, size_t raw_size) {
+    size_t ip = 0;
+    size_t op = 0;
+
+    while (ip < size) {
+        unsigned char control = static_cast<unsigned char>(src[ip++]);
+
+        if (control < 128) {
+            size_t len = static_cast<size_t>(control) + 1;
+            if (ip + len > size || op + len > raw_size) {
+                throw std::runtime_error("Corrupt RLE stream: literal overflow");
+            }
+            std::memcpy(dst + op, src + ip, len);
+            ip += len;
+            op += len;
+        } else {
+            size_t run = static_cast<size_t>(control) - 128 + 3;
+            if (ip >= size || op + run > raw_size) {
+                throw std::runtime_error("Corrupt RLE stream: run overflow");
+            }
+            std::memset(dst + op, src[ip++], run);
+            op += run;
+        }
+    }
+
+    if (op != raw_size) {
+        throw std::runtime_error("Corrupt RLE stream: size mismatch");
+    }
+}
+
+// ============================================================================
+// DELTA_LZ 코덱
+// ============================================================================
+//
+// 페이지를 uint32 워드 배열로 보고 w[i] - w[i-1]로 변환한 뒤 LZ 압축.
+// 정렬된 정수 키 배열(1, 2, 3, ...)은 상수 델타가 되어 긴 매치로 압축된다.
+
+void deltaLzCompress(const char* src, size_t size, std::vector<char>& out) {
+    if (size % sizeof(uint32_t) != 0) {
+        throw std::runtime_error("DELTA_LZ requires a multiple of 4 bytes");
+    }
+
+    std::vector<char> delta(size);
+    uint32_t prev = 0;
+    for (size_t pos = 0; pos < size; pos += sizeof(uint32_t)) {
+        uint32_t word = readWord(src + pos);
+        uint32_t diff = word - prev;
+        std::memcpy(delta.data() + pos, &diff, sizeof(uint32_t));
+        prev = word;
+    }
+
+    lzCompress(delta.data(), size, out);
+}
+
+void deltaLzDecompress(const char* src, size_t size, char* dst, size_t raw_size) {
+    if (raw_size % sizeof(uint32_t) != 0) {
+        throw std::runtime_error("DELTA_LZ requires a multiple of 4 bytes");
+    }
+
+    lzDecompress(src, size, dst, raw_size);
+
+    uint32_t prev = 0;
+    for (size_t pos = 0; pos < raw_size; pos += sizeof(uint32_t)) {
+        uint32_t word = readWord(dst + pos) + prev;
+        std::memcpy(dst + pos, &word, sizeof(uint32_t));
+        prev = word;
+    }
+}
+
+// ============================================================================
+// 코덱 선택
+// ============================================================================
+
+CompressionCodec compressPage(const char* page, size_t size, std::vector<char>& out) {
+    CompressionCodec best = CompressionCodec::NONE;
+    out.assign(page, page + size);
+
+    std::vector<char> candidate;
+
+    lzCompress(page, size, candidate);
+    if (candidate.size() < out.size()) {
+        out.swap(candidate);
+        best = CompressionCodec::LZ;
+    }
+
+    rleCompress(page, size, candidate);
+    if (candidate.size() < out.size()) {
+        out.swap(candidate);
+        best = CompressionCodec::RLE;
+    }
+
+    if (size % sizeof(uint32_t) == 0) {
+        deltaLzCompress(page, size, candidate);
+        if (candidate.size() < out.size()) {
+            out.swap(candidate);
+            best = CompressionCodec::DELTA_LZ;
+        }
+    }
+
+    return best;
+}
+
+void decompressPage(CompressionCodec codec, const char* src, size_t size,
+                    char* dst, size_t raw_size) {
+    switch (codec) {
+        case CompressionCodec::NONE:
+            if (size != raw_size) {
+                throw std::runtime_error("Corrupt page: size mismatch");
+            }
+            if (size > 0) {
+                std::memcpy(dst, src, size);
+            }
+            return;
+        case CompressionCodec::LZ:
+            lzDecompress(src, size, dst, raw_size);
+            return;
+        case CompressionCodec::RLE:
+            rleDecompress(src, size, dst, raw_size);
+            return;
+        case CompressionCodec::DELTA_LZ:
+            deltaLzDecompress(src, size, dst, raw_size);
+            return;
+    }
+    throw std::runtime_error("Unknown compression codec");
+}
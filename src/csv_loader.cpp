@@ -0,0 +1,335 @@
+#include "csv_loader.h"
+#include "dictionary.h"
+#include "trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+// 스레드 하나에 맡길 최소 바이트 수 (이보다 작으면 스레드를 덜 씀)
+static const size_t MIN_BYTES_PER_THREAD = 64 * 1024;
+
+// ============================================================================
+// 숫자 필드 파싱
+// ============================================================================
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+static void trimRange(const char*& begin, const char*& end) {
+    while (begin < end && isSpace(*begin)) ++begin;
+    while (end > begin && isSpace(*(end - 1))) --end;
+}
+
+bool parseCsvInt(const char* begin, const char* end, int_t& value) {
+    trimRange(begin, end);
+
+    const char* p = begin;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    // std::stoi처럼 앞쪽 숫자만 사용 (뒤의 문자는 무시)
+    const char* digits = p;
+    int64_t result = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        result = result * 10 + (*p - '0');
+        if (result > static_cast<int64_t>(INT32_MAX) + 1) {
+            return false;
+        }
+        ++p;
+    }
+    if (p == digits) {
+        return false;
+    }
+
+    if (negative) {
+        result = -result;
+    }
+    if (result < INT32_MIN || result > INT32_MAX) {
+        return false;
+    }
+
+    value = static_cast<int_t>(result);
+    return true;
+}
+
+bool parseCsvDecimal(const char* begin, const char* end, decimal_t& value) {
+    // 10^k (k <= 10)은 float로 정확히 표현됨
+    static const float POW10[] = {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+
+    trimRange(begin, end);
+
+    // 빠른 경로: [+-]digits[.digits], 유효 숫자 <= 2^24, 소수 자릿수 <= 10
+    // 정확한 두 float의 나눗셈은 올바르게 반올림되므로 strtof와 같은 값
+    const char* p = begin;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    size_t digit_count = 0;
+    size_t frac_digits = 0;
+    bool fast = true;
+
+    while (p < end && *p >= '0' && *p <= '9') {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        if (mantissa > (1u << 24)) {
+            fast = false;
+            break;
+        }
+        ++digit_count;
+        ++p;
+    }
+    if (fast && p < end && *p == '.') {
+        ++p;
+        while (p < end && *p >= '0' && *p <= '9') {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            if (mantissa > (1u << 24) || frac_digits == 10) {
+                fast = false;
+                break;
+            }
+            ++digit_count;
+            ++frac_digits;
+            ++p;
+        }
+    }
+
+    if (fast && digit_count > 0 && p == end) {
+        float result = static_cast<float>(mantissa);
+        if (frac_digits > 0) {
+            result /= POW10[frac_digits];
+        }
+        value = negative ? -result : result;
+        return true;
+    }
+
+    // 느린 경로: strtof (지수 표기, 긴 가수 등)
+    char stack_buf[64];
+    std::string heap_buf;
+    size_t len = static_cast<size_t>(end - begin);
+    const char* text;
+    if (len < sizeof(stack_buf)) {
+        std::memcpy(stack_buf, begin, len);
+        stack_buf[len] = '\0';
+        text = stack_buf;
+    } else {
+        heap_buf.assign(begin, end);
+        text = heap_buf.c_str();
+    }
+
+    char* parse_end = nullptr;
+    errno = 0;
+    float result = std::strtof(text, &parse_end);
+    if (parse_end == text || errno == ERANGE) {
+        return false;
+    }
+
+    value = result;
+    return true;
+}
+
+// ============================================================================
+// CsvLoader 구현
+// ============================================================================
+
+CsvLoader::CsvLoader(const std::string& type, size_t blk_size, RecordEncoding enc, size_t threads)
+    : table_type(type), block_size(blk_size), encoding(enc), num_threads(threads),
+      chunk_size(CSV_DEFAULT_CHUNK_SIZE), dict(nullptr), error_count(0) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+void CsvLoader::parseRange(const char* begin, const char* end, ChunkResult& result) const {
+    bool is_part = (table_type == "PART");
+
+    const char* pos = begin;
+    while (pos < end) {
+        const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        const char* line_end = newline ? newline : end;
+
+        if (line_end > pos) {
+            try {
+                if (is_part) {
+                    PartRecord part = PartRecord::fromCSV(pos, line_end);
+                    if (dict) {
+                        result.parts.push_back(std::move(part));
+                    } else {
+                        result.staged.add(part);
+                    }
+                } else {
+                    result.staged.add(PartSuppRecord::fromCSV(pos, line_end));
+                }
+            } catch (const std::exception& e) {
+                result.errors.push_back("Error parsing line: " + std::string(pos, line_end) +
+                                        "\nError: " + e.what());
+            }
+        }
+
+        pos = line_end + 1;
+    }
+}
+
+size_t CsvLoader::appendResult(ChunkResult& result, Block& block, RecordBuilder& builder,
+                               TableWriter& writer) {
+    size_t added = 0;
+
+    for (const auto& error : result.errors) {
+        std::cerr << error << std::endl;
+    }
+    error_count += result.errors.size();
+
+    // 딕셔너리 모드: 파싱 순서대로 코드 할당하며 인코딩
+    for (const auto& part : result.parts) {
+        if (!part.writeTo(builder, dict)) {
+            writer.writeBlock(&block);
+            block.clear();
+
+            if (!part.writeTo(builder, dict)) {
+                std::cerr << "Error: Record too large for block" << std::endl;
+                error_count++;
+                continue;
+            }
+        }
+        added++;
+    }
+
+    // 스테이징된 레코드를 그대로 복사
+    size_t oversized = 0;
+    added += result.staged.drainTo(block, writer, oversized);
+    for (size_t i = 0; i < oversized; ++i) {
+        std::cerr << "Error: Record too large for block" << std::endl;
+    }
+    error_count += oversized;
+
+    result.parts.clear();
+    return added;
+}
+
+size_t CsvLoader::load(const std::string& csv_file, TableWriter& writer) {
+    if (table_type != "PART" && table_type != "PARTSUPP") {
+        throw std::runtime_error("Unknown table type: " + table_type);
+    }
+    if (dict && table_type != "PART") {
+        throw std::runtime_error("Dictionary encoding is only supported for PART");
+    }
+
+    std::ifstream input(csv_file, std::ios::binary);
+    if (!input.is_open()) {
+        throw std::runtime_error("Failed to open CSV file: " + csv_file);
+    }
+
+    // 추가 쓰기면 기존 마지막 페이지의 빈 공간부터 채움
+    Block block(block_size);
+    writer.takeTail(block);
+    RecordBuilder builder(&block, encoding);
+
+    std::vector<char> buffer(std::max<size_t>(chunk_size, 1));
+    size_t carry = 0;
+    size_t record_count = 0;
+    error_count = 0;
+
+    while (true) {
+        // 한 줄이 버퍼보다 길면 버퍼 확장
+        if (carry == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+
+        input.read(buffer.data() + carry, buffer.size() - carry);
+        size_t got = static_cast<size_t>(input.gcount());
+        bool at_eof = (got < buffer.size() - carry);
+        size_t filled = carry + got;
+
+        if (filled == 0) {
+            break;
+        }
+
+        // 마지막 줄바꿈까지만 처리하고 나머지는 다음 청크로 넘김
+        size_t process_end = filled;
+        if (!at_eof) {
+            while (process_end > 0 && buffer[process_end - 1] != '\n') {
+                --process_end;
+            }
+            if (process_end == 0) {
+                carry = filled;
+                continue;
+            }
+        }
+
+        const char* begin = buffer.data();
+        const char* end = begin + process_end;
+        size_t length = process_end;
+
+        // 줄바꿈 경계에 맞춰 스레드별 범위 분할
+        size_t parts = std::min(num_threads, std::max<size_t>(1, length / MIN_BYTES_PER_THREAD));
+        std::vector<const char*> bounds(parts + 1);
+        bounds[0] = begin;
+        for (size_t i = 1; i < parts; ++i) {
+            const char* p = std::max(begin + length * i / parts, bounds[i - 1]);
+            const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            bounds[i] = newline ? newline + 1 : end;
+        }
+        bounds[parts] = end;
+
+        std::vector<ChunkResult> results;
+        results.reserve(parts);
+        for (size_t i = 0; i < parts; ++i) {
+            results.emplace_back(block_size, encoding);
+        }
+        std::vector<std::exception_ptr> failures(parts);
+        auto work = [&](size_t i) {
+            TRACE_SPAN("parse chunk", "load");
+            try {
+                parseRange(bounds[i], bounds[i + 1], results[i]);
+            } catch (...) {
+                failures[i] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < parts; ++i) {
+            workers.emplace_back(work, i);
+        }
+        work(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        // 스레드 순서대로 병합 (입력 순서 유지)
+        TRACE_SPAN("merge chunks", "load");
+        for (size_t i = 0; i < parts; ++i) {
+            if (failures[i]) {
+                std::rethrow_exception(failures[i]);
+            }
+            record_count += appendResult(results[i], block, builder, writer);
+        }
+
+        carry = filled - process_end;
+        if (carry > 0) {
+            std::memmove(buffer.data(), buffer.data() + process_end, carry);
+        }
+        if (at_eof) {
+            break;
+        }
+    }
+
+    // 마지막 블록 쓰기
+    if (!block.isEmpty()) {
+        writer.writeBlock(&block);
+    }
+
+    return record_count;
+}
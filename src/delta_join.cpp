@@ -0,0 +1,485 @@
+#include "delta_join.h"
+#include "memory_tracker.h"
+#include "phase_timer.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include "table_stats.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <fstream>
+#include <iostream>
+
+// ============================================================================
+// 워터마크 사이드카
+// ============================================================================
+
+static void writeMark(std::ofstream& file, const TableWatermark& mark) {
+    file.write(reinterpret_cast<const char*>(&mark.block_count), sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(&mark.record_count), sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(&mark.tail_records), sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(&mark.write_id), sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(&mark.fingerprint), sizeof(uint64_t));
+}
+
+static void readMark(std::ifstream& file, TableWatermark& mark) {
+    file.read(reinterpret_cast<char*>(&mark.block_count), sizeof(uint64_t));
+    file.read(reinterpret_cast<char*>(&mark.record_count), sizeof(uint64_t));
+    file.read(reinterpret_cast<char*>(&mark.tail_records), sizeof(uint64_t));
+    file.read(reinterpret_cast<char*>(&mark.write_id), sizeof(uint64_t));
+    file.read(reinterpret_cast<char*>(&mark.fingerprint), sizeof(uint64_t));
+}
+
+void JoinWatermark::save(const std::string& output_file) const {
+    std::string path = sidecarPath(output_file);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open watermark file: " + path);
+    }
+
+    uint32_t magic = JOIN_WATERMARK_MAGIC;
+    uint32_t version = JOIN_WATERMARK_VERSION;
+    file.write(reinterpret_cast<const char*>(&magic), sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
+    writeMark(file, part);
+    writeMark(file, partsupp);
+    file.write(reinterpret_cast<const char*>(&output_records), sizeof(uint64_t));
+
+    if (!file.good()) {
+        throw std::runtime_error("Failed to write watermark file: " + path);
+    }
+}
+
+bool JoinWatermark::loadIfExists(const std::string& output_file, JoinWatermark& watermark) {
+    std::ifstream file(sidecarPath(output_file), std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    uint32_t magic = 0, version = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(uint32_t));
+    file.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
+    if (!file || magic != JOIN_WATERMARK_MAGIC || version != JOIN_WATERMARK_VERSION) {
+        return false;
+    }
+
+    readMark(file, watermark.part);
+    readMark(file, watermark.partsupp);
+    file.read(reinterpret_cast<char*>(&watermark.output_records), sizeof(uint64_t));
+    return static_cast<bool>(file);
+}
+
+// ============================================================================
+// 헬퍼
+// ============================================================================
+
+// 블록 키 범위에 keys(정렬됨) 중 하나라도 들어가는지
+static bool overlapsAny(const ZoneEntry& entry, const std::vector<int_t>& keys) {
+    if (entry.record_count == 0) {
+        return false;
+    }
+    auto it = std::lower_bound(keys.begin(), keys.end(), entry.min_key);
+    return it != keys.end() && *it <= entry.max_key;
+}
+
+static int_t recordKey(const Record& record) {
+    return std::stoi(record.getField(0));
+}
+
+// 입력 파일 헤더의 write_id (헤더가 없으면 0)
+static uint64_t readWriteId(const std::string& table_file) {
+    FileHeader header;
+    return readFileHeader(table_file, header) ? header.write_id : 0;
+}
+
+static void sortUnique(std::vector<int_t>& keys) {
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
+
+// 워터마크 이후의 레코드를 파일 순서대로 방문하고 끝 위치를 반환
+// (워터마크의 마지막 블록은 추가 쓰기로 채워졌을 수 있어 다시 읽고 앞부분만 건너뜀)
+template <typename Visit>
+static TableWatermark scanAfter(TableReader& reader, Block& block, const TableWatermark& from,
+                                Statistics* stats, Visit visit) {
+    TRACE_SPAN("delta scan", "join");
+    size_t start = from.block_count > 0 ? static_cast<size_t>(from.block_count - 1) : 0;
+    uint64_t skip = from.block_count > 0 ? from.tail_records : 0;
+
+    TableWatermark to;
+    to.block_count = start;
+    to.record_count = from.record_count - skip;
+
+    reader.seekBlock(start);
+    while (reader.readBlock(&block)) {
+        RecordReader rec_reader(&block);
+        uint64_t count = 0;
+        while (rec_reader.hasNext()) {
+            Record record;
+            {
+                PHASE_TIMER(stats, TimerPhase::DECODE);
+                record = rec_reader.readNext();
+            }
+            if (count++ >= skip) {
+                visit(record);
+            }
+        }
+        skip = 0;
+
+        to.block_count++;
+        to.record_count += count;
+        to.tail_records = count;
+        block.clear();
+    }
+
+    if (to.record_count < from.record_count) {
+        throw std::runtime_error("Input table shrank below the delta join watermark");
+    }
+    return to;
+}
+
+// ============================================================================
+// DeltaJoin 구현
+// ============================================================================
+
+DeltaJoin::DeltaJoin(
+    const std::string& part_file,
+    const std::string& partsupp_file,
+    const std::string& out_file,
+    size_t blk_size)
+    : part_table_file(part_file),
+      partsupp_table_file(partsupp_file),
+      output_file(out_file),
+      block_size(blk_size),
+      table_bytes(0),
+      full_recompute(false),
+      delta_records(0) {
+}
+
+bool DeltaJoin::canApplyDelta(const JoinWatermark& watermark, std::string& reason) {
+    FileHeader output_header;
+    if (!readFileHeader(output_file, output_header) || !output_header.isComplete()) {
+        reason = "previous result missing or incomplete";
+        return false;
+    }
+    if (output_header.record_count != watermark.output_records) {
+        reason = "previous result does not match its watermark";
+        return false;
+    }
+
+    // 입력은 추가만 되었어야 함
+    const std::pair<const std::string*, const TableWatermark*> inputs[] = {
+        {&part_table_file, &watermark.part},
+        {&partsupp_table_file, &watermark.partsupp}
+    };
+    for (const auto& input : inputs) {
+        FileHeader header;
+        bool has_header = readFileHeader(*input.first, header);
+        if (has_header && header.isComplete() &&
+            (header.record_count < input.second->record_count ||
+             header.block_count < input.second->block_count)) {
+            reason = *input.first + " has fewer rows than at the last run";
+            return false;
+        }
+        if ((has_header ? header.write_id : 0) != input.second->write_id ||
+            fingerprint(*input.first, *input.second) != input.second->fingerprint) {
+            reason = *input.first + " was rewritten since the last run";
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t DeltaJoin::fingerprint(const std::string& table_file, const TableWatermark& mark) {
+    if (mark.block_count == 0) {
+        return 0;
+    }
+
+    TableReader reader(table_file, block_size, &stats);
+    Block block(block_size);
+    uint64_t hash = mark.block_count;
+    uint64_t last = mark.block_count - 1;
+    std::vector<uint64_t> indices(1, 0);
+    if (mark.write_id == 0) {
+        // write_id가 없으면 가운데 블록만 바뀐 경우도 잡도록 전부 해시
+        for (uint64_t i = 1; i <= last; ++i) {
+            indices.push_back(i);
+        }
+    } else if (last > 0) {
+        indices.push_back(last);
+    }
+
+    for (uint64_t i : indices) {
+        reader.seekBlock(static_cast<size_t>(i));
+        if (!reader.readBlock(&block)) {
+            return hash ^ 1;  // 처리한 블록이 없어짐
+        }
+
+        // 마지막 블록은 추가 쓰기로 뒤가 채워질 수 있어 처리한 레코드까지만
+        uint64_t limit = (i == last) ? mark.tail_records : UINT64_MAX;
+        RecordReader rec_reader(&block);
+        for (uint64_t n = 0; n < limit && rec_reader.hasNext(); ++n) {
+            std::vector<char> bytes = rec_reader.readNext().serialize();
+            hash = hashBytes(bytes.data(), bytes.size(), hash);
+        }
+        block.clear();
+    }
+    return hash;
+}
+
+bool DeltaJoin::matchesProcessedRows(const std::vector<int_t>& part_keys,
+                                     const TableWatermark& partsupp_mark) {
+    if (partsupp_mark.block_count == 0) {
+        return false;
+    }
+
+    TableReader reader(partsupp_table_file, block_size, &stats);
+    const ZoneMap* zone_map = reader.getZoneMap();
+    Block block(block_size);
+
+    for (size_t i = 0; i < partsupp_mark.block_count; ++i) {
+        if (zone_map && i < zone_map->size() && !overlapsAny(zone_map->get(i), part_keys)) {
+            stats.blocks_skipped++;
+            continue;
+        }
+
+        reader.seekBlock(i);
+        if (!reader.readBlock(&block)) {
+            break;
+        }
+
+        // 워터마크의 마지막 블록은 처리한 앞부분만 확인
+        uint64_t limit = (i + 1 == partsupp_mark.block_count) ? partsupp_mark.tail_records
+                                                               : UINT64_MAX;
+        RecordReader rec_reader(&block);
+        for (uint64_t n = 0; n < limit && rec_reader.hasNext(); ++n) {
+            Record record = rec_reader.readNext();
+            if (std::binary_search(part_keys.begin(), part_keys.end(), recordKey(record))) {
+                return true;
+            }
+        }
+        block.clear();
+    }
+    return false;
+}
+
+void DeltaJoin::loadParts(const std::vector<int_t>& keys) {
+    MemoryPhaseScope build_phase(MemoryPhase::BUILD);
+    TraceSpan build_span("hash build", "join");
+    build_span.setArg("keys", keys.size());
+    std::unordered_map<int_t, std::vector<PartRecord>>().swap(part_table);
+    grant->unuse(table_bytes);
+    table_bytes = 0;
+    if (keys.empty()) {
+        return;
+    }
+
+    TableReader reader(part_table_file, block_size, &stats);
+    const ZoneMap* zone_map = reader.getZoneMap();
+    Block block(block_size);
+    size_t index = 0;
+
+    // 키 검색과 해시 삽입 시간 = 루프 시간 - 안에서 잰 read/decode 시간
+    PHASE_TIMER_REST(&stats, TimerPhase::COMPARE);
+    while (true) {
+        // 새 키를 포함하지 않는 블록은 읽지 않음
+        if (zone_map) {
+            while (index < zone_map->size() && !overlapsAny(zone_map->get(index), keys)) {
+                index++;
+                stats.blocks_skipped++;
+            }
+            if (index >= zone_map->size()) {
+                break;
+            }
+            reader.seekBlock(index);
+        }
+        if (!reader.readBlock(&block)) {
+            break;
+        }
+        index++;
+
+        RecordReader rec_reader(&block);
+        while (rec_reader.hasNext()) {
+            Record record;
+            int_t key;
+            {
+                PHASE_TIMER(&stats, TimerPhase::DECODE);
+                record = rec_reader.readNext();
+                key = recordKey(record);
+            }
+            if (std::binary_search(keys.begin(), keys.end(), key)) {
+                PartRecord part;
+                {
+                    PHASE_TIMER(&stats, TimerPhase::DECODE);
+                    part = PartRecord::fromRecord(record, part_dict.get());
+                }
+                size_t bytes = hashInsertBytes(part_table, key) + part.heapBytes();
+                if (!grant->use(bytes)) {
+                    throw std::runtime_error("Delta join: PART lookup table exceeds the memory limit (" +
+                                             std::to_string(grant->getUsed()) + " bytes in use)");
+                }
+                table_bytes += bytes;
+                part_table[key].push_back(std::move(part));
+            }
+        }
+        block.clear();
+    }
+}
+
+JoinWatermark DeltaJoin::run(const JoinWatermark& from, bool append) {
+    JoinWatermark to;
+    Block block(block_size);
+
+    // ========== 단계 1: 새 PART 행 확인 ==========
+    std::vector<int_t> part_keys;
+    {
+        TableReader reader(part_table_file, block_size, &stats);
+        to.part = scanAfter(reader, block, from.part, &stats, [&](const Record& record) {
+            part_keys.push_back(recordKey(record));
+        });
+    }
+    sortUnique(part_keys);
+
+    if (append && !part_keys.empty() && matchesProcessedRows(part_keys, from.partsupp)) {
+        // 새 PART 행의 결과가 기존 결과 중간에 들어가야 함
+        std::cout << "New PART rows match already joined PARTSUPP rows; recomputing" << std::endl;
+        return run(JoinWatermark(), false);
+    }
+    full_recompute = !append;
+
+    // ========== 단계 2: 새 PARTSUPP 행의 키 수집 ==========
+    TableReader partsupp_reader(partsupp_table_file, block_size, &stats);
+    std::vector<int_t> partsupp_keys;
+    to.partsupp = scanAfter(partsupp_reader, block, from.partsupp, &stats, [&](const Record& record) {
+        partsupp_keys.push_back(recordKey(record));
+    });
+    delta_records = to.partsupp.record_count - from.partsupp.record_count;
+    sortUnique(partsupp_keys);
+
+    // ========== 단계 3: 필요한 PART 행만 로드 ==========
+    loadParts(partsupp_keys);
+    std::cout << "Delta: " << (to.part.record_count - from.part.record_count) << " PART rows, "
+              << delta_records << " PARTSUPP rows (" << part_table.size()
+              << " matching PART keys)" << std::endl;
+
+    // ========== 단계 4: 새 PARTSUPP 행 probe 후 결과에 추가 ==========
+    MemoryPhaseScope output_phase(MemoryPhase::OUTPUT);
+    TableWriter writer(output_file, &stats, false, append);
+    if (!append) {
+        writer.setTableType("JOIN");
+    }
+
+    Block output_block(block_size);
+    writer.takeTail(output_block);
+    RecordBuilder output_builder(&output_block);
+    uint64_t output_records = 0;
+    MemoryPhaseScope probe_phase(MemoryPhase::PROBE);
+
+    {
+        TRACE_SPAN("probe batch", "join");
+        // 해시 조회 시간 = probe 스캔 시간 - 안에서 잰 read/decode/encode/write 시간
+        PHASE_TIMER_REST(&stats, TimerPhase::COMPARE);
+        scanAfter(partsupp_reader, block, from.partsupp, &stats, [&](const Record& record) {
+            PartSuppRecord partsupp;
+            {
+                PHASE_TIMER(&stats, TimerPhase::DECODE);
+                partsupp = PartSuppRecord::fromRecord(record);
+            }
+            auto it = part_table.find(partsupp.partkey);
+            if (it == part_table.end()) {
+                return;
+            }
+
+            for (const auto& part : it->second) {
+                bool encoded;
+                {
+                    PHASE_TIMER(&stats, TimerPhase::ENCODE);
+                    encoded = JoinResultRecord::encode(output_builder, part, partsupp);
+                }
+                if (!encoded) {
+                    MemoryPhaseScope output_phase(MemoryPhase::OUTPUT);
+                    TRACE_SPAN("flush", "join");
+                    writer.writeBlock(&output_block);
+                    output_block.clear();
+
+                    PHASE_TIMER(&stats, TimerPhase::ENCODE);
+                    if (!JoinResultRecord::encode(output_builder, part, partsupp)) {
+                        throw std::runtime_error("Result record too large");
+                    }
+                }
+                output_records++;
+            }
+        });
+    }
+
+    MemoryPhaseScope flush_phase(MemoryPhase::OUTPUT);
+    if (!output_block.isEmpty()) {
+        TRACE_SPAN("flush", "join");
+        writer.writeBlock(&output_block);
+    }
+    writer.close();
+
+    stats.output_records += output_records;
+    to.output_records = from.output_records + output_records;
+
+    // 다음 실행에서 입력이 다시 쓰였는지 확인할 write_id와 지문
+    to.part.write_id = readWriteId(part_table_file);
+    to.partsupp.write_id = readWriteId(partsupp_table_file);
+    to.part.fingerprint = fingerprint(part_table_file, to.part);
+    to.partsupp.fingerprint = fingerprint(partsupp_table_file, to.partsupp);
+    return to;
+}
+
+void DeltaJoin::execute() {
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    // 이 스레드의 할당을 델타 조인 계정에 단계별로 기록
+    OperatorMemoryScope memory_scope("Delta join");
+    OperatorPerfScope perf_scope;
+
+    part_dict = PartDictionary::loadIfExists(part_table_file);
+
+    // 입력 블록 2개 + 출력 블록 예약
+    grant.reset(new MemoryGrant("Delta join"));
+    grant->acquire(3 * block_size, 3 * block_size);
+    table_bytes = 0;
+
+    // 이전 결과와 워터마크가 맞으면 이어서, 아니면 처음부터
+    JoinWatermark previous;
+    std::string reason = "no watermark";
+    bool append = JoinWatermark::loadIfExists(output_file, previous) &&
+                  canApplyDelta(previous, reason);
+    if (!append) {
+        std::cout << "Full recompute (" << reason << ")" << std::endl;
+        previous = JoinWatermark();
+    }
+
+    JoinWatermark current = run(previous, append);
+    current.save(output_file);
+    perf_scope.finish(stats);
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end_time - start_time;
+    stats.elapsed_time = elapsed.count();
+
+    // 메모리 사용량 (예약 안에서 쓴 최대 크기: 조회용 해시 테이블 + 블록)
+    stats.memory_usage = grant->getPeakUsed();
+    stats.tracked_memory_peak = static_cast<size_t>(MemoryTracker::operatorUsage(memory_scope.id()).peak);
+    grant.reset();
+
+    std::cout << "\n=== Delta Join Statistics ===" << std::endl;
+    std::cout << "Mode: " << (full_recompute ? "full recompute" : "delta") << std::endl;
+    std::cout << "Delta Rows: " << delta_records << std::endl;
+    std::cout << "Block Reads: " << stats.block_reads << std::endl;
+    std::cout << "Block Writes: " << stats.block_writes << std::endl;
+    std::cout << "Physical Reads: " << stats.physical_block_reads << std::endl;
+    std::cout << "Physical Writes: " << stats.physical_block_writes << std::endl;
+    std::cout << "Blocks Skipped: " << stats.blocks_skipped << std::endl;
+    std::cout << "Output Records: " << stats.output_records
+              << " (total " << current.output_records << ")" << std::endl;
+    std::cout << "Elapsed Time: " << stats.elapsed_time << " seconds" << std::endl;
+    std::cout << "Memory Usage: " << (stats.memory_usage / 1024.0 / 1024.0) << " MB" << std::endl;
+    printPhaseBreakdown(std::cout, stats);
+    printPerfCounters(std::cout, perf_scope, stats.output_records);
+    printTrackedMemory(std::cout, memory_scope.id());
+}
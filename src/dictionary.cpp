@@ -0,0 +1,236 @@
+#include "dictionary.h"
+#include "file_header.h"
+#include "memory_governor.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+// ============================================================================
+// ColumnDictionary 구현
+// ============================================================================
+
+uint16_t ColumnDictionary::encode(const std::string& value) {
+    auto it = codes.find(value);
+    if (it != codes.end()) {
+        return it->second;
+    }
+    if (values.size() >= UINT16_MAX) {
+        throw std::runtime_error("Dictionary overflow: too many distinct values");
+    }
+
+    uint16_t code = static_cast<uint16_t>(values.size());
+    values.push_back(value);
+    codes[value] = code;
+    return code;
+}
+
+bool ColumnDictionary::lookup(const std::string& value, uint16_t& code) const {
+    auto it = codes.find(value);
+    if (it == codes.end()) {
+        return false;
+    }
+    code = it->second;
+    return true;
+}
+
+const std::string& ColumnDictionary::decode(uint16_t code) const {
+    if (code >= values.size()) {
+        throw std::runtime_error("Invalid dictionary code: " + std::to_string(code));
+    }
+    return values[code];
+}
+
+size_t ColumnDictionary::memoryBytes() const {
+    // 값마다 배열의 문자열 하나와 해시 테이블 노드 하나 (키 문자열 사본 포함)
+    size_t bytes = values.capacity() * sizeof(std::string) +
+                   codes.bucket_count() * sizeof(void*);
+    for (const auto& value : values) {
+        bytes += 2 * stringHeapBytes(value) + sizeof(void*) +
+                 sizeof(std::pair<const std::string, uint16_t>) + sizeof(size_t);
+    }
+    return bytes;
+}
+
+// ============================================================================
+// PartDictionary 구현
+// ============================================================================
+
+// PART 필드 인덱스: mfgr(2), brand(3), type(4), container(6)
+static const size_t PART_DICT_COLUMNS[] = { 2, 3, 4, 6 };
+
+PartDictionary::PartDictionary() {
+    for (size_t col : PART_DICT_COLUMNS) {
+        columns[col] = ColumnDictionary();
+    }
+}
+
+bool PartDictionary::isEncodedColumn(size_t col) {
+    for (size_t encoded : PART_DICT_COLUMNS) {
+        if (encoded == col) return true;
+    }
+    return false;
+}
+
+ColumnDictionary& PartDictionary::getColumn(size_t col) {
+    auto it = columns.find(col);
+    if (it == columns.end()) {
+        throw std::runtime_error("Column is not dictionary-encoded: " + std::to_string(col));
+    }
+    return it->second;
+}
+
+const ColumnDictionary& PartDictionary::getColumn(size_t col) const {
+    auto it = columns.find(col);
+    if (it == columns.end()) {
+        throw std::runtime_error("Column is not dictionary-encoded: " + std::to_string(col));
+    }
+    return it->second;
+}
+
+size_t PartDictionary::memoryBytes() const {
+    size_t bytes = 0;
+    for (const auto& entry : columns) {
+        bytes += sizeof(entry) + entry.second.memoryBytes();
+    }
+    return bytes;
+}
+
+std::string PartDictionary::codeToField(uint16_t code) {
+    char bytes[sizeof(uint16_t)];
+    std::memcpy(bytes, &code, sizeof(uint16_t));
+    return std::string(bytes, sizeof(uint16_t));
+}
+
+uint16_t PartDictionary::fieldToCode(const char* data, size_t size) {
+    if (size != sizeof(uint16_t)) {
+        throw std::runtime_error("Invalid dictionary-encoded field size: " + std::to_string(size));
+    }
+    uint16_t code;
+    std::memcpy(&code, data, sizeof(uint16_t));
+    return code;
+}
+
+void PartDictionary::save(const std::string& block_file) const {
+    std::string path = sidecarPath(block_file);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open dictionary file: " + path);
+    }
+
+    uint32_t magic = DICTIONARY_MAGIC;
+    uint16_t column_count = static_cast<uint16_t>(columns.size());
+    file.write(reinterpret_cast<const char*>(&magic), sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(&column_count), sizeof(uint16_t));
+
+    for (size_t col : PART_DICT_COLUMNS) {
+        const ColumnDictionary& dict = getColumn(col);
+        uint16_t col_index = static_cast<uint16_t>(col);
+        uint16_t value_count = static_cast<uint16_t>(dict.size());
+        file.write(reinterpret_cast<const char*>(&col_index), sizeof(uint16_t));
+        file.write(reinterpret_cast<const char*>(&value_count), sizeof(uint16_t));
+
+        for (const auto& value : dict.getValues()) {
+            uint16_t len = static_cast<uint16_t>(value.size());
+            file.write(reinterpret_cast<const char*>(&len), sizeof(uint16_t));
+            file.write(value.data(), len);
+        }
+    }
+
+    if (!file.good()) {
+        throw std::runtime_error("Failed to write dictionary file: " + path);
+    }
+}
+
+std::unique_ptr<PartDictionary> PartDictionary::load(const std::string& block_file) {
+    std::string path = sidecarPath(block_file);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open dictionary file: " + path);
+    }
+
+    uint32_t magic = 0;
+    uint16_t column_count = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(uint32_t));
+    file.read(reinterpret_cast<char*>(&column_count), sizeof(uint16_t));
+    if (!file || magic != DICTIONARY_MAGIC) {
+        throw std::runtime_error("Invalid dictionary file: " + path);
+    }
+
+    std::unique_ptr<PartDictionary> dict(new PartDictionary());
+
+    for (uint16_t c = 0; c < column_count; ++c) {
+        uint16_t col_index = 0, value_count = 0;
+        file.read(reinterpret_cast<char*>(&col_index), sizeof(uint16_t));
+        file.read(reinterpret_cast<char*>(&value_count), sizeof(uint16_t));
+
+        ColumnDictionary& column = dict->getColumn(col_index);
+        for (uint16_t v = 0; v < value_count; ++v) {
+            uint16_t len = 0;
+            file.read(reinterpret_cast<char*>(&len), sizeof(uint16_t));
+            std::string value(len, '\0');
+            file.read(&value[0], len);
+            column.encode(value);
+        }
+
+        if (!file) {
+            throw std::runtime_error("Truncated dictionary file: " + path);
+        }
+    }
+
+    return dict;
+}
+
+std::unique_ptr<PartDictionary> PartDictionary::loadIfExists(const std::string& block_file) {
+    FileHeader header;
+    if (!readFileHeader(block_file, header) || !header.hasFlag(FILE_FLAG_DICTIONARY)) {
+        return nullptr;
+    }
+
+    std::ifstream probe(sidecarPath(block_file), std::ios::binary);
+    if (!probe.is_open()) {
+        return nullptr;
+    }
+    probe.close();
+    return load(block_file);
+}
+
+void PartDictionary::remove(const std::string& block_file) {
+    std::remove(sidecarPath(block_file).c_str());
+}
+
+// ============================================================================
+// EqualsPredicate 구현
+// ============================================================================
+
+EqualsPredicate::EqualsPredicate(const std::string& table_type,
+                                 const std::string& column_name,
+                                 const std::string& val,
+                                 const PartDictionary* dict)
+    : column(getColumnIndex(table_type, column_name)), value(val),
+      use_code(false), never_matches(false) {
+    code_bytes[0] = code_bytes[1] = 0;
+
+    if (dict && table_type == "PART" && PartDictionary::isEncodedColumn(column)) {
+        use_code = true;
+
+        // 값을 코드로 한 번만 변환
+        uint16_t code;
+        if (dict->getColumn(column).lookup(value, code)) {
+            std::memcpy(code_bytes, &code, sizeof(uint16_t));
+        } else {
+            never_matches = true;
+        }
+    }
+}
+
+bool EqualsPredicate::matchesField(const FieldRef& field) const {
+    if (never_matches) {
+        return false;
+    }
+
+    if (use_code) {
+        return field.size == sizeof(uint16_t) &&
+               field.data[0] == code_bytes[0] && field.data[1] == code_bytes[1];
+    }
+    return field.equals(value);
+}
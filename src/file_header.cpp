@@ -0,0 +1,97 @@
+#include "file_header.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+// 헤더 필드 위치
+static const size_t OFF_MAGIC = 0;
+static const size_t OFF_VERSION = 4;
+static const size_t OFF_HEADER_SIZE = 6;
+static const size_t OFF_BLOCK_SIZE = 8;
+static const size_t OFF_FLAGS = 12;
+static const size_t OFF_RECORD_COUNT = 16;
+static const size_t OFF_BLOCK_COUNT = 24;
+static const size_t OFF_ENCODING = 32;
+static const size_t OFF_TABLE_TYPE = 36;
+static const size_t OFF_WRITE_ID = 52;
+static const size_t OFF_LAST_BLOCK = 56;
+
+void FileHeader::serialize(char* buf) const {
+    std::memset(buf, 0, FILE_HEADER_SIZE);
+
+    uint32_t magic = FILE_HEADER_MAGIC;
+    uint16_t header_size = FILE_HEADER_SIZE;
+    std::memcpy(buf + OFF_MAGIC, &magic, sizeof(uint32_t));
+    std::memcpy(buf + OFF_VERSION, &format_version, sizeof(uint16_t));
+    std::memcpy(buf + OFF_HEADER_SIZE, &header_size, sizeof(uint16_t));
+    std::memcpy(buf + OFF_BLOCK_SIZE, &block_size, sizeof(uint32_t));
+    std::memcpy(buf + OFF_FLAGS, &flags, sizeof(uint32_t));
+    std::memcpy(buf + OFF_RECORD_COUNT, &record_count, sizeof(uint64_t));
+    std::memcpy(buf + OFF_BLOCK_COUNT, &block_count, sizeof(uint64_t));
+    buf[OFF_ENCODING] = static_cast<char>(record_encoding);
+
+    size_t type_len = std::min(table_type.size(), static_cast<size_t>(FILE_HEADER_TYPE_SIZE - 1));
+    std::memcpy(buf + OFF_TABLE_TYPE, table_type.data(), type_len);
+    std::memcpy(buf + OFF_WRITE_ID, &write_id, sizeof(uint32_t));
+    std::memcpy(buf + OFF_LAST_BLOCK, &last_block_offset, sizeof(uint64_t));
+}
+
+bool FileHeader::deserialize(const char* buf, size_t size, FileHeader& header) {
+    if (size < FILE_HEADER_SIZE) {
+        return false;
+    }
+
+    uint32_t magic;
+    uint16_t header_size;
+    std::memcpy(&magic, buf + OFF_MAGIC, sizeof(uint32_t));
+    std::memcpy(&header_size, buf + OFF_HEADER_SIZE, sizeof(uint16_t));
+    if (magic != FILE_HEADER_MAGIC || header_size != FILE_HEADER_SIZE) {
+        return false;
+    }
+
+    std::memcpy(&header.format_version, buf + OFF_VERSION, sizeof(uint16_t));
+    std::memcpy(&header.block_size, buf + OFF_BLOCK_SIZE, sizeof(uint32_t));
+    std::memcpy(&header.flags, buf + OFF_FLAGS, sizeof(uint32_t));
+    std::memcpy(&header.record_count, buf + OFF_RECORD_COUNT, sizeof(uint64_t));
+    std::memcpy(&header.block_count, buf + OFF_BLOCK_COUNT, sizeof(uint64_t));
+    header.record_encoding = static_cast<uint8_t>(buf[OFF_ENCODING]);
+
+    const char* type = buf + OFF_TABLE_TYPE;
+    header.table_type.assign(type, strnlen(type, FILE_HEADER_TYPE_SIZE));
+    std::memcpy(&header.write_id, buf + OFF_WRITE_ID, sizeof(uint32_t));
+    std::memcpy(&header.last_block_offset, buf + OFF_LAST_BLOCK, sizeof(uint64_t));
+    return true;
+}
+
+uint32_t newWriteId() {
+    // random_device가 결정적인 구현도 있어 시간과 섞음
+    std::random_device device;
+    uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^
+        static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    std::mt19937_64 rng(seed);
+
+    uint32_t id = 0;
+    while (id == 0) {
+        id = static_cast<uint32_t>(rng());
+    }
+    return id;
+}
+
+bool readFileHeader(std::istream& in, FileHeader& header) {
+    char buf[FILE_HEADER_SIZE];
+    in.read(buf, FILE_HEADER_SIZE);
+    if (in.gcount() != FILE_HEADER_SIZE) {
+        return false;
+    }
+    return FileHeader::deserialize(buf, FILE_HEADER_SIZE, header);
+}
+
+bool readFileHeader(const std::string& filename, FileHeader& header) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    return readFileHeader(file, header);
+}
@@ -1,4 +1,7 @@
 #include "file_manager.h"
+#include "dictionary.h"
+#include "csv_loader.h"
+#include "pax.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -22,60 +25,12 @@ size_t FileManager::convertCSV(const std::string& csv_file,
                                const std::string& block_file,
                                const std::string& table_type) {
     try {
-        // 기존 convertCSVToBlocks 함수 활용
-        std::ifstream input(csv_file);
-        if (!input.is_open()) {
-            throw std::runtime_error("Failed to open CSV file: " + csv_file);
-        }
-
+        // 기존 convertCSVToBlocks와 같은 멀티스레드 로더 사용
         TableWriter writer(block_file, &stats);
-        Block block(block_size);
-        RecordWriter rec_writer(&block);
-
-        std::string line;
-        size_t record_count = 0;
-
-        while (std::getline(input, line)) {
-            if (line.empty()) continue;
-
-            try {
-                Record record;
-
-                if (table_type == "PART") {
-                    PartRecord part = PartRecord::fromCSV(line);
-                    record = part.toRecord();
-                } else if (table_type == "PARTSUPP") {
-                    PartSuppRecord partsupp = PartSuppRecord::fromCSV(line);
-                    record = partsupp.toRecord();
-                } else {
-                    throw std::runtime_error("Unknown table type: " + table_type);
-                }
-
-                // 블록에 레코드 쓰기
-                if (!rec_writer.writeRecord(record)) {
-                    // 블록이 가득 차면 디스크에 쓰고 새 블록 시작
-                    writer.writeBlock(&block);
-                    block.clear();
-
-                    // 새 블록에 레코드 쓰기
-                    if (!rec_writer.writeRecord(record)) {
-                        throw std::runtime_error("Record too large for block");
-                    }
-                }
-
-                record_count++;
-            } catch (const std::exception& e) {
-                std::cerr << "Warning: Error parsing line: " << e.what() << std::endl;
-            }
-        }
-
-        // 마지막 블록 쓰기
-        if (!block.isEmpty()) {
-            writer.writeBlock(&block);
-        }
+        writer.setTableType(table_type);
 
-        input.close();
-        return record_count;
+        CsvLoader loader(table_type, block_size);
+        return loader.load(csv_file, writer);
 
     } catch (const std::exception& e) {
         throw std::runtime_error("convertCSV failed: " + std::string(e.what()));
@@ -119,9 +74,11 @@ size_t FileManager::readBlockFile(const std::string& block_file,
 
 size_t FileManager::readPartRecords(const std::string& block_file,
                                     std::function<void(const PartRecord&)> callback) {
-    return readBlockFile(block_file, [&callback](const Record& record) {
+    std::unique_ptr<PartDictionary> dict = PartDictionary::loadIfExists(block_file);
+
+    return readBlockFile(block_file, [&callback, &dict](const Record& record) {
         try {
-            PartRecord part = PartRecord::fromRecord(record);
+            PartRecord part = PartRecord::fromRecord(record, dict.get());
             callback(part);
         } catch (const std::exception& e) {
             std::cerr << "Warning: Failed to parse PART record: " << e.what() << std::endl;
@@ -149,26 +106,25 @@ size_t FileManager::writePartRecords(const std::string& block_file,
                                      const std::vector<PartRecord>& records) {
     try {
         TableWriter writer(block_file, &stats);
+        writer.setTableType("PART");
 
         if (!writer.isOpen()) {
             throw std::runtime_error("Failed to open file: " + block_file);
         }
 
         Block block(block_size);
-        RecordWriter rec_writer(&block);
+        RecordBuilder builder(&block);
         size_t written_count = 0;
 
         for (const auto& part : records) {
-            Record record = part.toRecord();
-
             // 블록에 레코드 쓰기
-            if (!rec_writer.writeRecord(record)) {
+            if (!part.writeTo(builder)) {
                 // 블록이 가득 차면 디스크에 쓰기
                 writer.writeBlock(&block);
                 block.clear();
 
                 // 새 블록에 레코드 쓰기
-                if (!rec_writer.writeRecord(record)) {
+                if (!part.writeTo(builder)) {
                     throw std::runtime_error("Record too large for block");
                 }
             }
@@ -192,26 +148,25 @@ size_t FileManager::writePartSuppRecords(const std::string& block_file,
                                          const std::vector<PartSuppRecord>& records) {
     try {
         TableWriter writer(block_file, &stats);
+        writer.setTableType("PARTSUPP");
 
         if (!writer.isOpen()) {
             throw std::runtime_error("Failed to open file: " + block_file);
         }
 
         Block block(block_size);
-        RecordWriter rec_writer(&block);
+        RecordBuilder builder(&block);
         size_t written_count = 0;
 
         for (const auto& partsupp : records) {
-            Record record = partsupp.toRecord();
-
             // 블록에 레코드 쓰기
-            if (!rec_writer.writeRecord(record)) {
+            if (!partsupp.writeTo(builder)) {
                 // 블록이 가득 차면 디스크에 쓰기
                 writer.writeBlock(&block);
                 block.clear();
 
                 // 새 블록에 레코드 쓰기
-                if (!rec_writer.writeRecord(record)) {
+                if (!partsupp.writeTo(builder)) {
                     throw std::runtime_error("Record too large for block");
                 }
             }
@@ -270,6 +225,11 @@ void FileManager::printStatistics() const {
     std::cout << "\n=== FileManager Statistics ===" << std::endl;
     std::cout << std::setw(20) << "Block Reads: " << stats.block_reads << std::endl;
     std::cout << std::setw(20) << "Block Writes: " << stats.block_writes << std::endl;
+    std::cout << std::setw(20) << "Physical Reads: " << stats.physical_block_reads << std::endl;
+    std::cout << std::setw(20) << "Physical Writes: " << stats.physical_block_writes << std::endl;
+    std::cout << std::setw(20) << "Blocks Skipped: " << stats.blocks_skipped << std::endl;
+    std::cout << std::setw(20) << "Buffer Hits: " << stats.buffer_hits << std::endl;
+    std::cout << std::setw(20) << "Buffer Misses: " << stats.buffer_misses << std::endl;
     std::cout << std::setw(20) << "Output Records: " << stats.output_records << std::endl;
     std::cout << std::setw(20) << "Elapsed Time: " << std::fixed << std::setprecision(3)
               << stats.elapsed_time << " seconds" << std::endl;
@@ -289,6 +249,12 @@ size_t FileManager::getMemoryUsage() const {
 // ============================================================================
 
 size_t FileManager::countRecords(const std::string& block_file) {
+    // 헤더에 저장된 개수가 있으면 스캔하지 않음
+    FileHeader header;
+    if (readFileHeader(block_file, header) && header.isComplete()) {
+        return static_cast<size_t>(header.record_count);
+    }
+
     size_t count = 0;
 
     readBlockFile(block_file, [&count](const Record&) {
@@ -300,6 +266,11 @@ size_t FileManager::countRecords(const std::string& block_file) {
 
 size_t FileManager::countBlocks(const std::string& block_file) {
     try {
+        FileHeader header;
+        if (readFileHeader(block_file, header) && header.isComplete()) {
+            return static_cast<size_t>(header.block_count);
+        }
+
         Statistics local_stats;
         TableReader reader(block_file, block_size, &local_stats);
 
@@ -321,28 +292,113 @@ size_t FileManager::countBlocks(const std::string& block_file) {
     }
 }
 
+size_t FileManager::countMatching(const std::string& block_file,
+                                  const std::string& table_type,
+                                  const std::string& column,
+                                  const std::string& value) {
+    try {
+        std::unique_ptr<PartDictionary> dict = PartDictionary::loadIfExists(block_file);
+        EqualsPredicate predicate(table_type, column, value, dict.get());
+
+        TableReader reader(block_file, block_size, &stats);
+        Block block(block_size);
+        size_t match_count = 0;
+
+        // partkey 동등 조건이면 존 맵으로 해당 키가 없는 블록 건너뛰기
+        if (predicate.getColumn() == 0) {
+            try {
+                int_t key = std::stoi(value);
+                if (std::to_string(key) == value) {
+                    reader.setKeyRange(key, key);
+                }
+            } catch (const std::exception&) {
+                // 정수가 아니면 전체 스캔
+            }
+        }
+
+        std::string scratch;
+        while (reader.readBlock(&block)) {
+            // PAX 페이지는 술어 컬럼의 미니페이지만 읽음
+            if (PaxPage::isPaxPage(&block)) {
+                PaxPage page(&block);
+                for (size_t row = 0; row < page.getRecordCount(); ++row) {
+                    if (predicate.matchesField(page.getFieldText(predicate.getColumn(), row, scratch))) {
+                        match_count++;
+                    }
+                }
+                continue;
+            }
+
+            RecordReader rec_reader(&block);
+
+            // 뷰로 읽어 술어 컬럼만 확인
+            while (rec_reader.hasNext()) {
+                if (predicate.matches(rec_reader.readNextView())) {
+                    match_count++;
+                }
+            }
+        }
+
+        return match_count;
+
+    } catch (const std::exception& e) {
+        throw std::runtime_error("countMatching failed: " + std::string(e.what()));
+    }
+}
+
 void FileManager::printFileInfo(const std::string& block_file) {
     try {
         std::cout << "\n=== File Information ===" << std::endl;
         std::cout << "File: " << block_file << std::endl;
 
-        // 파일 크기 확인
-        std::ifstream file(block_file, std::ios::binary | std::ios::ate);
+        // 헤더와 파일 크기만 확인
+        std::ifstream file(block_file, std::ios::binary);
         if (!file.is_open()) {
             throw std::runtime_error("Failed to open file: " + block_file);
         }
 
+        FileHeader header;
+        bool has_header = readFileHeader(file, header) && header.isComplete();
+
+        file.clear();
+        file.seekg(0, std::ios::end);
         std::streamsize file_size = file.tellg();
         file.close();
 
-        // 블록 및 레코드 개수 카운트
-        size_t num_blocks = countBlocks(block_file);
-        size_t num_records = countRecords(block_file);
+        size_t num_blocks, num_records;
+        size_t file_block_size = block_size;
+
+        if (has_header) {
+            num_blocks = static_cast<size_t>(header.block_count);
+            num_records = static_cast<size_t>(header.record_count);
+            if (header.block_size != 0) {
+                file_block_size = header.block_size;
+            }
+        } else {
+            // 헤더가 없는 이전 형식 파일은 전체 스캔
+            num_blocks = countBlocks(block_file);
+            num_records = countRecords(block_file);
+        }
 
         // 정보 출력
+        if (has_header) {
+            std::cout << std::setw(20) << "Table Type: " << header.table_type << std::endl;
+            std::cout << std::setw(20) << "Format Version: " << header.format_version << std::endl;
+            std::cout << std::setw(20) << "Record Format: "
+                      << (header.record_encoding == static_cast<uint8_t>(RecordEncoding::OFFSET_INDEXED)
+                          ? "indexed" : "row") << std::endl;
+            std::cout << std::setw(20) << "Layout: "
+                      << (header.hasFlag(FILE_FLAG_PAX) ? "pax" : "row") << std::endl;
+            std::cout << std::setw(20) << "Compressed: "
+                      << (header.hasFlag(FILE_FLAG_COMPRESSED) ? "yes" : "no") << std::endl;
+            std::cout << std::setw(20) << "Dictionary: "
+                      << (header.hasFlag(FILE_FLAG_DICTIONARY) ? "yes" : "no") << std::endl;
+            std::cout << std::setw(20) << "Sorted: "
+                      << (header.hasFlag(FILE_FLAG_SORTED) ? "yes" : "no") << std::endl;
+        }
         std::cout << std::setw(20) << "File Size: "
                   << (file_size / 1024.0 / 1024.0) << " MB" << std::endl;
-        std::cout << std::setw(20) << "Block Size: " << block_size << " bytes" << std::endl;
+        std::cout << std::setw(20) << "Block Size: " << file_block_size << " bytes" << std::endl;
         std::cout << std::setw(20) << "Total Blocks: " << num_blocks << std::endl;
         std::cout << std::setw(20) << "Total Records: " << num_records << std::endl;
         std::cout << std::setw(20) << "Avg Records/Block: "
@@ -351,7 +407,7 @@ void FileManager::printFileInfo(const std::string& block_file) {
                   << std::endl;
         std::cout << std::setw(20) << "Storage Efficiency: "
                   << std::fixed << std::setprecision(1)
-                  << (file_size > 0 ? (num_blocks * block_size * 100.0) / file_size : 0.0)
+                  << (file_size > 0 ? (num_blocks * file_block_size * 100.0) / file_size : 0.0)
                   << "%" << std::endl;
 
     } catch (const std::exception& e) {
@@ -1,7 +1,14 @@
 #include "join.h"
+#include "memory_governor.h"
+#include "memory_tracker.h"
+#include "phase_timer.h"
+#include "perf_counters.h"
+#include "trace.h"
 #include <iostream>
 #include <chrono>
 #include <vector>
+#include <algorithm>
+#include <utility>
 
 /**
  * ============================================================================
@@ -19,12 +26,134 @@
  *   - R 읽기: |R| 블록
  *   - S 읽기: (|R| / (B-1)) × |S| 블록 (R의 각 청크마다 S를 전체 스캔)
  *
+ * 교과서 방식보다 줄인 부분:
+ *   - S가 B-1 블록 이하이면 S를 버퍼에 한 번만 올림: |R| + |S|
+ *   - 아니면 S 스캔 방향을 정방향/역방향으로 번갈아 바꿔, 직전 스캔의 마지막
+ *     블록(버퍼에 남아 있음)을 다시 읽지 않음: 스캔마다 1블록 절약
+ *     (역방향 스캔에서는 청크 안의 결과 순서가 inner 블록 역순이 됨, 결과 집합은 동일)
+ *
  * 메모리 사용: B × block_size (기본: 10 × 4KB = 40KB)
  *   - Outer 버퍼: B-1 블록
  *   - Inner 버퍼: 1 블록
  *   - Output 버퍼: 별도 관리
  */
 
+// ============================================================================
+// 계획 수립: 버퍼 분할과 예상 I/O
+// ============================================================================
+BnljPlan planBlockNestedLoops(size_t outer_blocks, size_t inner_blocks, size_t buffer_size,
+                              size_t inner_buffers, bool output_in_budget) {
+    // outer + inner에 쓸 수 있는 버퍼
+    size_t usable = output_in_budget ? buffer_size - 1 : buffer_size;
+    if (buffer_size == 0 || usable < 2) {
+        throw std::runtime_error("Buffer size too small for join plan");
+    }
+
+    BnljPlan plan;
+    plan.outer_blocks = outer_blocks;
+    plan.inner_blocks = inner_blocks;
+    plan.output_in_budget = output_in_budget;
+
+    // Inner가 버퍼에 들어가면 각 테이블을 한 번씩만 읽음
+    if (inner_blocks > 0 && inner_blocks < usable) {
+        plan.inner_cached = true;
+        plan.inner_buffers = inner_blocks;
+        plan.outer_buffers = usable - inner_blocks;
+        plan.outer_chunks = (outer_blocks + plan.outer_buffers - 1) / plan.outer_buffers;
+        plan.predicted_reads = outer_blocks + inner_blocks;
+        plan.predicted_seeks = plan.outer_chunks + 1;
+        return plan;
+    }
+
+    auto evaluate = [&](size_t k) {
+        BnljPlan p = plan;
+        p.inner_cached = false;
+        p.inner_buffers = k;
+        p.outer_buffers = usable - k;
+        p.outer_chunks = (outer_blocks + p.outer_buffers - 1) / p.outer_buffers;
+
+        // 청크마다 inner 전체를 k블록 구간씩 읽되, 방향을 바꾼 스캔은
+        // 직전 스캔의 마지막 k블록(버퍼에 남음)을 다시 읽지 않음
+        // (마지막 구간이 k보다 짧아도 나머지 버퍼에 바로 앞 구간의 끝 블록이 남아 있음)
+        size_t groups = (inner_blocks + k - 1) / k;
+        size_t reused = std::min(k, inner_blocks);
+        p.predicted_reads = outer_blocks;
+        p.predicted_seeks = p.outer_chunks;
+        if (p.outer_chunks > 0 && groups > 0) {
+            p.predicted_reads += p.outer_chunks * inner_blocks - (p.outer_chunks - 1) * reused;
+            p.predicted_seeks += groups + (p.outer_chunks - 1) * (groups - 1);
+        }
+        return p;
+    };
+
+    if (inner_buffers > 0) {
+        return evaluate(std::min(inner_buffers, usable - 1));
+    }
+
+    // inner 연속 읽기 블록 수 선택: 블록 읽기 + 탐색 비용이 가장 작은 값
+    BnljPlan best = evaluate(1);
+    for (size_t k = 2; k < usable; ++k) {
+        BnljPlan candidate = evaluate(k);
+        if (candidate.cost() < best.cost()) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+bool fitBnljToMemory(size_t budget_bytes, size_t frame_bytes, bool output_in_budget,
+                     size_t& buffer_size, size_t& cache_blocks) {
+    if (budget_bytes == 0) {
+        return false;
+    }
+
+    // 출력 블록을 버퍼에 포함하면 outer + inner + 출력 = 3개, 아니면 outer + inner 2개 + 출력 1개
+    size_t extra = output_in_budget ? 0 : 1;
+    size_t min_buffers = output_in_budget ? 3 : 2;
+    size_t total = budget_bytes / frame_bytes;
+    if (total >= buffer_size + cache_blocks + extra) {
+        return false;
+    }
+    if (total < min_buffers + extra) {
+        throw std::runtime_error("Memory limit too small for block nested loops join (needs " +
+                                 std::to_string((min_buffers + extra) * frame_bytes) + " bytes)");
+    }
+
+    if (total >= buffer_size + extra) {
+        cache_blocks = total - buffer_size - extra;
+    } else {
+        cache_blocks = 0;
+        buffer_size = total - extra;
+    }
+    return true;
+}
+
+size_t bnljFrameBudget(size_t available_bytes) {
+    if (available_bytes == SIZE_MAX) {
+        return available_bytes;
+    }
+    return available_bytes / (1 + BNLJ_DECODED_BLOCK_RATIO);
+}
+
+size_t countTableBlocks(const std::string& block_file, size_t block_size) {
+    FileHeader header;
+    if (readFileHeader(block_file, header) && header.isComplete()) {
+        return static_cast<size_t>(header.block_count);
+    }
+
+    // 헤더가 없는 이전 형식: 존 맵, 없으면 스캔
+    TableReader reader(block_file, block_size);
+    if (reader.getZoneMap()) {
+        return reader.getZoneMap()->size();
+    }
+    Block block(block_size);
+    size_t count = 0;
+    while (reader.readBlock(&block)) {
+        count++;
+    }
+    return count;
+}
+
 // ============================================================================
 // 생성자: 조인 파라미터 초기화 및 검증
 // ============================================================================
@@ -42,7 +171,13 @@ BlockNestedLoopsJoin::BlockNestedLoopsJoin(
       outer_table_type(outer_type),
       inner_table_type(inner_type),
       buffer_size(buf_size),
-      block_size(blk_size) {
+      block_size(blk_size),
+      cache_blocks(0),
+      replacement(ReplacementPolicy::MRU),
+      auto_plan(false),
+      auto_outer(true),
+      sink_mode(SinkMode::FILE),
+      plan() {
 
     // 버퍼 크기 검증: 최소 2개 필요 (outer 1개 + inner 1개)
     if (buffer_size < 2) {
@@ -50,6 +185,62 @@ BlockNestedLoopsJoin::BlockNestedLoopsJoin(
     }
 }
 
+// 레코드 벡터 배열을 capacity개로 늘리는 만큼 예약 (재할당하는 동안은 옛 배열과 새 배열이
+// 함께 존재하므로 새 배열을 먼저 받고 옛 배열 크기는 반납)
+template <typename T>
+static bool reserveRecords(MemoryGrant& grant, std::vector<T>& records, size_t capacity) {
+    if (capacity <= records.capacity()) {
+        return true;
+    }
+    if (!grant.use(capacity * sizeof(T))) {
+        return false;
+    }
+    size_t old_bytes = records.capacity() * sizeof(T);
+    records.reserve(capacity);
+    grant.unuse(old_bytes);
+    return true;
+}
+
+// 레코드 하나를 더 넣을 자리 확보 (가득 차면 두 배로)
+template <typename T>
+static bool reserveRecordSlot(MemoryGrant& grant, std::vector<T>& records) {
+    if (records.size() < records.capacity()) {
+        return true;
+    }
+    return reserveRecords(grant, records, std::max<size_t>(records.capacity() * 2, 16));
+}
+
+// 파일 헤더의 레코드 수로 어림한 blocks개 블록의 레코드 수 (여유 1/8, 헤더가 없으면 0)
+static size_t estimateRecords(const TableReader& reader, size_t blocks) {
+    const FileHeader* header = reader.getHeader();
+    if (!header || header->block_count == 0) {
+        return 0;
+    }
+    size_t per_block = static_cast<size_t>(
+        (header->record_count + header->block_count - 1) / header->block_count);
+    size_t records = per_block * blocks;
+    return records + records / 8;
+}
+
+// from번째부터 레코드를 지우고 문자열 힙 예약 반납 (벡터 배열은 다시 쓰도록 유지)
+template <typename T>
+static void eraseRecords(MemoryGrant& grant, std::vector<T>& records, size_t from = 0) {
+    size_t bytes = 0;
+    for (size_t i = from; i < records.size(); ++i) {
+        bytes += records[i].heapBytes();
+    }
+    records.erase(records.begin() + from, records.end());
+    grant.unuse(bytes);
+}
+
+// 레코드와 벡터 배열의 예약을 모두 반납
+template <typename T>
+static void releaseRecords(MemoryGrant& grant, std::vector<T>& records) {
+    eraseRecords(grant, records);
+    grant.unuse(records.capacity() * sizeof(T));
+    std::vector<T>().swap(records);
+}
+
 // ============================================================================
 // 조인 실행 메인 함수: 시간 측정 및 통계 출력
 // ============================================================================
@@ -58,7 +249,11 @@ void BlockNestedLoopsJoin::execute() {
     auto start_time = std::chrono::high_resolution_clock::now();
 
     // ========== 단계 2: 실제 조인 수행 ==========
+    // 이 스레드의 할당을 BNLJ 계정에 단계별로 기록
+    OperatorMemoryScope memory_scope("BNLJ");
+    OperatorPerfScope perf_scope;
     performJoin();
+    perf_scope.finish(stats);
 
     // ========== 단계 3: 종료 시간 기록 및 경과 시간 계산 ==========
     auto end_time = std::chrono::high_resolution_clock::now();
@@ -66,40 +261,117 @@ void BlockNestedLoopsJoin::execute() {
     stats.elapsed_time = elapsed.count();
 
     // ========== 단계 4: 메모리 사용량 계산 ==========
-    // 총 메모리 = 버퍼 개수 × 블록 크기
-    stats.memory_usage = buffer_size * block_size;
+    // 예약 안에서 쓴 최대 크기 (리더 + 버퍼/캐시 프레임 + 디코딩한 레코드)
+    stats.memory_usage = grant->getPeakUsed();
+    stats.tracked_memory_peak = static_cast<size_t>(MemoryTracker::operatorUsage(memory_scope.id()).peak);
+    grant.reset();
 
     // ========== 단계 5: 성능 통계 출력 ==========
     std::cout << "\n=== Join Statistics ===" << std::endl;
     std::cout << "Block Reads: " << stats.block_reads << std::endl;
+    std::cout << "Predicted Block Reads: " << plan.predicted_reads
+              << (stats.blocks_skipped > 0 ? " (before zone map skipping)" : "") << std::endl;
     std::cout << "Block Writes: " << stats.block_writes << std::endl;
+    std::cout << "Physical Reads: " << stats.physical_block_reads << std::endl;
+    std::cout << "Physical Writes: " << stats.physical_block_writes << std::endl;
+    std::cout << "Blocks Skipped: " << stats.blocks_skipped << std::endl;
+    if (cache_blocks > 0) {
+        std::cout << "Buffer Hits: " << stats.buffer_hits << std::endl;
+        std::cout << "Buffer Misses: " << stats.buffer_misses << std::endl;
+    }
     std::cout << "Output Records: " << stats.output_records << std::endl;
     std::cout << "Elapsed Time: " << stats.elapsed_time << " seconds" << std::endl;
     std::cout << "Memory Usage: " << stats.memory_usage << " bytes ("
               << (stats.memory_usage / 1024.0 / 1024.0) << " MB)" << std::endl;
+    printPhaseBreakdown(std::cout, stats);
+    printPerfCounters(std::cout, perf_scope, stats.output_records);
+    printTrackedMemory(std::cout, memory_scope.id());
 }
 
 // ============================================================================
 // 조인 수행 함수: 테이블 리더/라이터 초기화 및 조인 타입 분기
 // ============================================================================
 void BlockNestedLoopsJoin::performJoin() {
-    // ========== 단계 1: 파일 리더/라이터 생성 ==========
+    // ========== 단계 0: 블록 수로 outer 선택 ==========
+    size_t outer_blocks = countTableBlocks(outer_table_file, block_size);
+    size_t inner_blocks = countTableBlocks(inner_table_file, block_size);
+
+    if (auto_plan && auto_outer && inner_blocks < outer_blocks) {
+        // 작은 테이블을 outer로: 청크 수(= inner 스캔 횟수)가 줄어듦
+        std::swap(outer_table_file, inner_table_file);
+        std::swap(outer_table_type, inner_table_type);
+        std::swap(outer_blocks, inner_blocks);
+        std::cout << "Auto plan: using " << outer_table_file << " (" << outer_table_type
+                  << ") as outer" << std::endl;
+    }
+
+    // ========== 단계 1: 파일 리더/결과 출력 대상 생성 ==========
     // 통계 객체를 전달하여 I/O 카운트 자동 추적
     TableReader outer_reader(outer_table_file, block_size, &stats);
     TableReader inner_reader(inner_table_file, block_size, &stats);
-    TableWriter writer(output_file, &stats);
+    ResultSink sink(sink_mode, output_file, &stats);
+
+    bool supported = (outer_table_type == "PART" && inner_table_type == "PARTSUPP") ||
+                     (outer_table_type == "PARTSUPP" && inner_table_type == "PART");
+    bool part_is_outer = (outer_table_type == "PART");
+    if (supported) {
+        // PART 파일의 딕셔너리 사이드카가 있으면 로드
+        part_dict = PartDictionary::loadIfExists(part_is_outer ? outer_table_file
+                                                               : inner_table_file);
+    }
+
+    // ========== 메모리 예약 ==========
+    // 리더, 딕셔너리, 레코드 디코딩 작업 공간, 출력 라이터를 먼저 예약
+    grant.reset(new MemoryGrant("BNLJ"));
+    size_t fixed_bytes = outer_reader.memoryBytes() + inner_reader.memoryBytes() +
+                         (part_dict ? part_dict->memoryBytes() : 0) +
+                         RECORD_DECODE_SCRATCH_BYTES;
+    grant->acquire(fixed_bytes, fixed_bytes);
+    sink.setMemoryGrant(grant.get());
+
+    // 버퍼 + 캐시 + (자동 모드가 아니면) 출력 블록. 한도가 있으면 남은 예산의 일부만
+    // 프레임에 쓰고 나머지는 디코딩한 레코드에 남김. 한도 때문에 다 받지 못하면
+    // 캐시, 버퍼 순으로 줄여 받은 만큼으로 실행
+    size_t extra = auto_plan ? 0 : 1;
+    size_t min_buffers = auto_plan ? 3 : 2;
+    size_t requested_buffers = buffer_size, requested_cache = cache_blocks;
+    size_t frame_bytes = BufferManager::frameBytes(block_size);
+    size_t frame_budget = std::max(bnljFrameBudget(MemoryGovernor::instance().getAvailable()),
+                                   (min_buffers + extra) * frame_bytes);
+    bool fitted = fitBnljToMemory(frame_budget, frame_bytes, auto_plan, buffer_size, cache_blocks);
+    size_t desired = (buffer_size + cache_blocks + extra) * frame_bytes;
+    size_t granted = grant->acquire(desired, std::min(desired, (min_buffers + extra) * frame_bytes));
+    fitted = fitBnljToMemory(granted, frame_bytes, auto_plan, buffer_size, cache_blocks) || fitted;
+    if (fitted) {
+        std::cout << "Memory limit: buffer " << requested_buffers << " -> " << buffer_size
+                  << " blocks, cache " << requested_cache << " -> " << cache_blocks
+                  << " blocks" << std::endl;
+    }
+
+    // ========== 블록 수로 계획 수립 ==========
+    plan = planBlockNestedLoops(outer_blocks, inner_blocks, buffer_size,
+                                auto_plan ? 0 : 1, auto_plan);
+
+    std::cout << "Plan: outer " << plan.outer_blocks << " blocks x " << plan.outer_buffers
+              << " buffers (" << plan.outer_chunks << " chunks), inner " << plan.inner_blocks
+              << " blocks x " << plan.inner_buffers << " buffers"
+              << (plan.inner_cached ? " (cached)" : "")
+              << (plan.output_in_budget ? ", output 1 buffer" : "") << std::endl;
+    std::cout << "Predicted: " << plan.predicted_reads << " block reads, "
+              << plan.predicted_seeks << " seeks\n" << std::endl;
 
     // ========== 단계 2: 버퍼 풀 생성 ==========
-    // buffer_size 개의 블록을 사전 할당
-    BufferManager buffer_mgr(buffer_size, block_size);
+    // buffer_size 개의 작업 버퍼 + inner 페이지 캐시 프레임을 사전 할당
+    BufferManager buffer_mgr(buffer_size, block_size, cache_blocks, replacement);
+    if (cache_blocks > 0) {
+        inner_reader.setBufferPool(&buffer_mgr);
+    }
 
     // ========== 단계 3: 테이블 타입에 따라 조인 수행 ==========
     // PART와 PARTSUPP 조인만 지원
-    if ((outer_table_type == "PART" && inner_table_type == "PARTSUPP") ||
-        (outer_table_type == "PARTSUPP" && inner_table_type == "PART")) {
-
-        bool part_is_outer = (outer_table_type == "PART");
-        joinPartAndPartSupp(outer_reader, inner_reader, writer, buffer_mgr, part_is_outer);
+    if (supported) {
+        joinPartAndPartSupp(outer_reader, inner_reader, sink, buffer_mgr, part_is_outer);
+        sink.close();
     } else {
         throw std::runtime_error("Unsupported table types for join");
     }
@@ -111,25 +383,229 @@ void BlockNestedLoopsJoin::performJoin() {
 void BlockNestedLoopsJoin::joinPartAndPartSupp(
     TableReader& outer_reader,
     TableReader& inner_reader,
-    TableWriter& writer,
+    ResultSink& sink,
     BufferManager& buffer_mgr,
     bool part_is_outer) {
 
     // =========================================================================
-    // 버퍼 할당 전략
+    // 버퍼 할당 전략 (performJoin()에서 세운 계획)
     // =========================================================================
-    // 총 버퍼 B개를 다음과 같이 분할:
+    // 기본: 총 버퍼 B개를 다음과 같이 분할
     //   - Outer 테이블용: B-1 개 (한 번에 여러 블록 로드)
     //   - Inner 테이블용: 1 개 (한 번에 1개 블록만 로드)
     //
     // 이유: Outer 테이블을 많이 로드할수록 Inner 테이블 스캔 횟수 감소
+    //
+    // 단, Inner 테이블 전체가 B-1개 이하 블록이면 Inner를 버퍼에 한 번만 올려 두고
+    // 남은 버퍼를 Outer에 사용 (I/O: |R| + |S|)
+    //
+    // 자동 모드에서는 출력 블록도 B개 안에 포함하고, Inner를 여러 블록씩 연속으로 읽음
     // =========================================================================
-    size_t outer_buffer_count = buffer_size - 1;
+    size_t outer_buffer_count = plan.outer_buffers;
+    size_t inner_buffer_count = plan.inner_buffers;
+    size_t inner_block_count = plan.inner_blocks;
+    const ZoneMap* inner_zone_map = inner_reader.getZoneMap();
+
+    // ========== Inner 테이블이 버퍼에 들어가면 한 번만 읽기 ==========
+    std::vector<Block*> inner_cache;
+    std::unique_ptr<ScopedMemoryUse> inner_cache_memory;
+    if (plan.inner_cached) {
+        inner_cache_memory.reset(new ScopedMemoryUse(*grant, inner_block_count * sizeof(Block*)));
+        inner_cache.reserve(inner_block_count);
+        inner_reader.reset();
+        for (size_t i = 0; i < inner_block_count; ++i) {
+            Block* frame = buffer_mgr.getBuffer(outer_buffer_count + i);
+            if (!inner_reader.readBlock(frame)) {
+                break;
+            }
+            inner_cache.push_back(frame);
+        }
+
+        std::cout << "Inner table cached in " << inner_cache.size() << " buffer blocks ("
+                  << outer_buffer_count << " blocks left for outer)" << std::endl;
+    }
 
     // ========== 출력 블록 초기화 ==========
     // 조인 결과를 버퍼링하여 디스크 쓰기 횟수 최소화
-    Block output_block(block_size);
-    RecordWriter output_writer(&output_block);
+    // (자동 모드는 버퍼의 마지막 블록을 출력 블록으로 사용)
+    std::unique_ptr<Block> own_output_block;
+    Block* output_block;
+    if (plan.output_in_budget) {
+        output_block = buffer_mgr.getBuffer(buffer_size - 1);
+        output_block->clear();
+    } else {
+        MemoryPhaseScope output_phase(MemoryPhase::OUTPUT);
+        own_output_block.reset(new Block(block_size));
+        output_block = own_output_block.get();
+    }
+    RecordBuilder output_builder(output_block);
+
+    // 결과 하나를 출력 블록에 인코딩 (블록이 가득 차면 디스크에 플러시 후 다시 인코딩)
+    auto emitResult = [&](const PartRecord& part, const PartSuppRecord& partsupp) {
+        if (!sink.encodesRows()) {
+            stats.output_records++;
+            return;
+        }
+        bool encoded;
+        {
+            PHASE_TIMER(&stats, TimerPhase::ENCODE);
+            encoded = JoinResultRecord::encode(output_builder, part, partsupp);
+        }
+        if (!encoded) {
+            MemoryPhaseScope output_phase(MemoryPhase::OUTPUT);
+            TRACE_SPAN("flush", "join");
+            sink.writeBlock(output_block);
+            output_block->clear();
+
+            PHASE_TIMER(&stats, TimerPhase::ENCODE);
+            if (!JoinResultRecord::encode(output_builder, part, partsupp)) {
+                throw std::runtime_error("Result record too large");
+            }
+        }
+        stats.output_records++;
+    };
+
+    // 블록의 레코드를 PART 또는 PARTSUPP 레코드로 디코딩해 뒤에 추가
+    // (쌍마다가 아니라 블록마다 한 번 디코딩, 호출하는 쪽에서 DECODE 시간 측정)
+    // 디코딩한 레코드는 예약에 더하고, 블록 전체가 들어가지 않으면 이 블록 분을 되돌리고 false
+    auto decodeBlock = [&](const Block* block, bool as_part,
+                           std::vector<PartRecord>& parts,
+                           std::vector<PartSuppRecord>& partsupps) {
+        size_t parts_before = parts.size();
+        size_t partsupps_before = partsupps.size();
+        bool fits = true;
+        RecordReader reader(block);
+        while (fits && reader.hasNext()) {
+            Record record = reader.readNext();
+            try {
+                if (as_part) {
+                    PartRecord part = PartRecord::fromRecord(record, part_dict.get());
+                    fits = reserveRecordSlot(*grant, parts) && grant->use(part.heapBytes());
+                    if (fits) {
+                        parts.push_back(std::move(part));
+                    }
+                } else {
+                    PartSuppRecord partsupp = PartSuppRecord::fromRecord(record);
+                    fits = reserveRecordSlot(*grant, partsupps) && grant->use(partsupp.heapBytes());
+                    if (fits) {
+                        partsupps.push_back(std::move(partsupp));
+                    }
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Error during join: " << e.what() << std::endl;
+            }
+        }
+        if (!fits) {
+            eraseRecords(*grant, parts, parts_before);
+            eraseRecords(*grant, partsupps, partsupps_before);
+        }
+        return fits;
+    };
+
+    // 메모리의 Outer 레코드 (로드할 때 디코딩, part_is_outer에 따라 한쪽만 사용)
+    std::vector<PartRecord> outer_parts;
+    std::vector<PartSuppRecord> outer_partsupps;
+    std::vector<PartRecord> inner_parts;
+    std::vector<PartSuppRecord> inner_partsupps;
+
+    // 블록 하나를 디코딩한 레코드가 쓸 만한 크기 (청크를 채울 때 상대편 몫으로 남겨 둠)
+    const size_t decoded_block_bytes = block_size * BNLJ_DECODED_BLOCK_RATIO;
+
+    // 레코드 벡터는 예상 레코드 수만큼 미리 잡아 두 배씩 재할당하는 낭비를 피함
+    // (예약이 모자라면 디코딩하면서 늘림)
+    auto presize = [&](std::vector<PartRecord>& parts, std::vector<PartSuppRecord>& partsupps,
+                       bool as_part, size_t records) {
+        if (as_part) {
+            reserveRecords(*grant, parts, records);
+        } else {
+            reserveRecords(*grant, partsupps, records);
+        }
+    };
+    presize(outer_parts, outer_partsupps, part_is_outer,
+            estimateRecords(outer_reader, outer_buffer_count));
+
+    // 버퍼에 올린 Inner는 한 번만 디코딩해 두고 청크마다 다시 씀
+    // (outer 블록 하나를 디코딩할 자리를 남기지 못하면 청크마다 블록 단위로 디코딩)
+    bool inner_decoded = false;
+    if (!inner_cache.empty()) {
+        MemoryPhaseScope build_phase(MemoryPhase::BUILD);
+        PHASE_TIMER(&stats, TimerPhase::DECODE);
+        inner_decoded = grant->use(decoded_block_bytes);
+        presize(inner_parts, inner_partsupps, !part_is_outer,
+                estimateRecords(inner_reader, inner_cache.size()));
+        for (size_t i = 0; inner_decoded && i < inner_cache.size(); ++i) {
+            inner_decoded = decodeBlock(inner_cache[i], !part_is_outer, inner_parts, inner_partsupps);
+        }
+        if (inner_decoded) {
+            grant->unuse(decoded_block_bytes);
+            std::cout << "Inner table decoded once ("
+                      << (part_is_outer ? inner_partsupps.size() : inner_parts.size())
+                      << " records)" << std::endl;
+        } else {
+            releaseRecords(*grant, inner_parts);
+            releaseRecords(*grant, inner_partsupps);
+            grant->trim();
+            std::cout << "Decoded inner table exceeds memory grant; decoding cached blocks per chunk"
+                      << std::endl;
+        }
+    }
+    if (!inner_decoded) {
+        presize(inner_parts, inner_partsupps, !part_is_outer, estimateRecords(inner_reader, 1));
+    }
+
+    // 메모리의 Inner 레코드들과 Outer 레코드들을 조인
+    auto joinInnerRecords = [&]() {
+        // -----------------------------------------------------------------
+        // 조인 수행 (Nested Loop)
+        // -----------------------------------------------------------------
+        // Outer 레코드들 × Inner 레코드들 - 모든 쌍 비교
+        // 조인 조건: R.PARTKEY = S.PARTKEY
+        if (part_is_outer) {
+            // Case 1: PART (outer) × PARTSUPP (inner)
+            for (const auto& part : outer_parts) {
+                for (const auto& partsupp : inner_partsupps) {
+                    if (part.partkey == partsupp.partkey) {
+                        emitResult(part, partsupp);
+                    }
+                }
+            }
+        } else {
+            // Case 2: PARTSUPP (outer) × PART (inner)
+            for (const auto& partsupp : outer_partsupps) {
+                for (const auto& part : inner_parts) {
+                    if (part.partkey == partsupp.partkey) {
+                        emitResult(part, partsupp);
+                    }
+                }
+            }
+        }
+    };
+
+    // Inner 블록 하나와 메모리의 Outer 레코드들을 조인
+    auto joinInnerBlock = [&](const Block* inner_block) {
+        // 키 비교 시간 = 블록 처리 시간 - 안에서 잰 decode/encode/write 시간
+        PHASE_TIMER_REST(&stats, TimerPhase::COMPARE);
+
+        // Inner 블록에서 레코드 추출 (청크를 채울 때 남겨 둔 자리에 디코딩)
+        eraseRecords(*grant, inner_parts);
+        eraseRecords(*grant, inner_partsupps);
+        bool fits;
+        {
+            PHASE_TIMER(&stats, TimerPhase::DECODE);
+            fits = decodeBlock(inner_block, !part_is_outer, inner_parts, inner_partsupps);
+        }
+        if (!fits) {
+            throw std::runtime_error("Memory limit too small to decode an inner block for "
+                                     "block nested loops join");
+        }
+        joinInnerRecords();
+    };
+
+    // Inner 스캔용 버퍼 (outer 버퍼 뒤 inner_buffer_count개)와 각 버퍼에 남아 있는 블록 번호
+    // 블록 i는 항상 (i % inner_buffer_count)번째 inner 버퍼에 읽음
+    const size_t NO_BLOCK = static_cast<size_t>(-1);
+    std::vector<size_t> resident_blocks(inner_buffer_count, NO_BLOCK);
+    size_t inner_pass = 0;
 
     // =========================================================================
     // Block Nested Loops Join 메인 루프
@@ -142,8 +618,24 @@ void BlockNestedLoopsJoin::joinPartAndPartSupp(
         // =====================================================================
         // 단계 1: Outer 테이블 블록들을 버퍼에 로드
         // =====================================================================
-        std::vector<Record> outer_records;  // 메모리에 레코드 저장
+        MemoryPhaseScope build_phase(MemoryPhase::BUILD);
+        TraceSpan load_span("chunk load", "join");
+        eraseRecords(*grant, outer_parts);
+        eraseRecords(*grant, outer_partsupps);
         size_t loaded_blocks = 0;
+        bool chunk_cut = false;
+
+        // Inner 블록 하나를 디코딩할 자리를 남겨 두고 청크를 채움
+        size_t inner_room = 0;
+        if (!inner_decoded) {
+            eraseRecords(*grant, inner_parts);
+            eraseRecords(*grant, inner_partsupps);
+            inner_room = decoded_block_bytes;
+            if (!grant->use(inner_room)) {
+                throw std::runtime_error("Memory limit too small to decode an inner block for "
+                                         "block nested loops join");
+            }
+        }
 
         // (B-1)개 블록을 순차적으로 읽기
         for (size_t i = 0; i < outer_buffer_count; ++i) {
@@ -151,19 +643,30 @@ void BlockNestedLoopsJoin::joinPartAndPartSupp(
             outer_block->clear();  // 이전 데이터 제거
 
             // 디스크에서 블록 읽기
-            if (outer_reader.readBlock(outer_block)) {
-                loaded_blocks++;
+            if (!outer_reader.readBlock(outer_block)) {
+                // 더 이상 읽을 블록이 없으면 종료
+                break;
+            }
 
-                // 블록에서 모든 레코드를 추출하여 메모리에 저장
-                RecordReader reader(outer_block);
-                while (reader.hasNext()) {
-                    outer_records.push_back(reader.readNext());
+            // 블록에서 모든 레코드를 추출하여 메모리에 저장
+            bool fits;
+            {
+                PHASE_TIMER(&stats, TimerPhase::DECODE);
+                fits = decodeBlock(outer_block, part_is_outer, outer_parts, outer_partsupps);
+            }
+            if (!fits) {
+                // 디코딩한 레코드가 예약에 들어가지 않으면 이 블록부터 다음 청크로 미룸
+                if (loaded_blocks == 0) {
+                    throw std::runtime_error("Memory limit too small to decode an outer block for "
+                                             "block nested loops join");
                 }
-            } else {
-                // 더 이상 읽을 블록이 없으면 종료
+                outer_reader.seekBlock(outer_reader.getBlockIndex() - 1);
+                chunk_cut = true;
                 break;
             }
+            loaded_blocks++;
         }
+        grant->unuse(inner_room);
 
         // 읽은 블록이 없으면 outer 테이블 끝
         if (loaded_blocks == 0) {
@@ -171,121 +674,83 @@ void BlockNestedLoopsJoin::joinPartAndPartSupp(
             break;
         }
 
+        size_t outer_count = part_is_outer ? outer_parts.size() : outer_partsupps.size();
+        load_span.setArg("records", outer_count);
+        load_span.end();
+
         std::cout << "Loaded " << loaded_blocks << " outer blocks ("
-                  << outer_records.size() << " records)" << std::endl;
+                  << outer_count << " records"
+                  << (chunk_cut ? ", cut short by memory grant" : "") << ")" << std::endl;
+
+        // Outer 청크의 partkey 범위 - inner 존 맵과 겹치지 않는 블록은 읽지 않음
+        int_t chunk_min = 0, chunk_max = 0;
+        bool has_range = outer_count > 0;
+        for (size_t r = 0; r < outer_count; ++r) {
+            int_t key = part_is_outer ? outer_parts[r].partkey : outer_partsupps[r].partkey;
+            if (r == 0 || key < chunk_min) chunk_min = key;
+            if (r == 0 || key > chunk_max) chunk_max = key;
+        }
 
         // =====================================================================
-        // 단계 2: Inner 테이블을 처음부터 끝까지 스캔
+        // 단계 2: Inner 테이블 전체와 조인
         // =====================================================================
-        // 중요: Outer 블록 청크마다 Inner 테이블을 완전히 스캔해야 함
-        inner_reader.reset();  // 파일 포인터를 처음으로 되돌림
-
-        // Inner 테이블용 버퍼 (마지막 버퍼 사용)
-        Block* inner_block = buffer_mgr.getBuffer(buffer_size - 1);
-
+        MemoryPhaseScope probe_phase(MemoryPhase::PROBE);
+        TraceSpan scan_span("inner scan", "join");
         size_t inner_blocks_scanned = 0;
 
-        // Inner 테이블의 모든 블록 순회
-        while (inner_reader.readBlock(inner_block)) {
-            inner_blocks_scanned++;
-
-            // -----------------------------------------------------------------
-            // 단계 2.1: Inner 블록에서 레코드 추출
-            // -----------------------------------------------------------------
-            std::vector<Record> inner_records;
-            RecordReader inner_rec_reader(inner_block);
-
-            while (inner_rec_reader.hasNext()) {
-                inner_records.push_back(inner_rec_reader.readNext());
+        if (inner_decoded) {
+            // Inner를 디코딩해 두었으면 디스크도 디코딩도 다시 하지 않음
+            PHASE_TIMER_REST(&stats, TimerPhase::COMPARE);
+            joinInnerRecords();
+            inner_blocks_scanned += inner_cache.size();
+        } else if (!inner_cache.empty()) {
+            // Inner가 버퍼에 있으면 디스크를 다시 읽지 않음
+            for (const Block* cached : inner_cache) {
+                joinInnerBlock(cached);
+                inner_blocks_scanned++;
             }
+        } else {
+            // Inner를 inner_buffer_count개 블록 구간 단위로 연속해서 읽고,
+            // 구간 순서를 스캔마다 정방향/역방향으로 번갈아 바꿈
+            // → 지난 스캔에서 마지막에 읽어 버퍼에 남아 있는 구간부터 시작해 다시 읽지 않음
+            bool forward = (inner_pass % 2 == 0);
+            size_t group_count = (inner_block_count + inner_buffer_count - 1) / inner_buffer_count;
+            inner_reader.clearKeyRange();
+
+            for (size_t step = 0; step < group_count; ++step) {
+                size_t group = forward ? step : group_count - 1 - step;
+                size_t first = group * inner_buffer_count;
+                size_t last = std::min(first + inner_buffer_count, inner_block_count);
+
+                for (size_t index = first; index < last; ++index) {
+                    // 존 맵으로 청크 키 범위 밖 블록 건너뛰기
+                    if (has_range && inner_zone_map && index < inner_zone_map->size() &&
+                        !inner_zone_map->get(index).overlaps(chunk_min, chunk_max)) {
+                        stats.blocks_skipped++;
+                        continue;
+                    }
 
-            // -----------------------------------------------------------------
-            // 단계 2.2: 조인 수행 (Nested Loop)
-            // -----------------------------------------------------------------
-            // Outer 레코드들 × Inner 레코드들 - 모든 쌍 비교
-            for (const auto& outer_rec : outer_records) {
-                for (const auto& inner_rec : inner_records) {
-                    try {
-                        int_t outer_key, inner_key;
-
-                        // =============================================================
-                        // 조인 조건 검사 및 결과 생성
-                        // =============================================================
-                        if (part_is_outer) {
-                            // Case 1: PART (outer) × PARTSUPP (inner)
-                            PartRecord part = PartRecord::fromRecord(outer_rec);
-                            PartSuppRecord partsupp = PartSuppRecord::fromRecord(inner_rec);
-                            outer_key = part.partkey;
-                            inner_key = partsupp.partkey;
-
-                            // 조인 조건: R.PARTKEY = S.PARTKEY
-                            if (outer_key == inner_key) {
-                                // 조인 결과 레코드 생성
-                                JoinResultRecord result;
-                                result.part = part;
-                                result.partsupp = partsupp;
-
-                                Record result_rec = result.toRecord();
-
-                                // ---------------------------------------------
-                                // 출력 블록에 쓰기 (버퍼링)
-                                // ---------------------------------------------
-                                if (!output_writer.writeRecord(result_rec)) {
-                                    // 블록이 가득 차면 디스크에 플러시
-                                    writer.writeBlock(&output_block);
-                                    output_block.clear();
-
-                                    // 새 블록에 다시 쓰기
-                                    if (!output_writer.writeRecord(result_rec)) {
-                                        throw std::runtime_error("Result record too large");
-                                    }
-                                }
-
-                                stats.output_records++;
-                            }
-                        } else {
-                            // Case 2: PARTSUPP (outer) × PART (inner)
-                            PartSuppRecord partsupp = PartSuppRecord::fromRecord(outer_rec);
-                            PartRecord part = PartRecord::fromRecord(inner_rec);
-                            outer_key = partsupp.partkey;
-                            inner_key = part.partkey;
-
-                            // 조인 조건: R.PARTKEY = S.PARTKEY
-                            if (outer_key == inner_key) {
-                                // 조인 결과 레코드 생성
-                                JoinResultRecord result;
-                                result.part = part;
-                                result.partsupp = partsupp;
-
-                                Record result_rec = result.toRecord();
-
-                                // ---------------------------------------------
-                                // 출력 블록에 쓰기 (버퍼링)
-                                // ---------------------------------------------
-                                if (!output_writer.writeRecord(result_rec)) {
-                                    // 블록이 가득 차면 디스크에 플러시
-                                    writer.writeBlock(&output_block);
-                                    output_block.clear();
-
-                                    // 새 블록에 다시 쓰기
-                                    if (!output_writer.writeRecord(result_rec)) {
-                                        throw std::runtime_error("Result record too large");
-                                    }
-                                }
-
-                                stats.output_records++;
-                            }
+                    size_t slot = index - first;
+                    Block* inner_block = buffer_mgr.getBuffer(outer_buffer_count + slot);
+                    if (resident_blocks[slot] != index) {
+                        inner_reader.seekBlock(index);
+                        if (!inner_reader.readBlock(inner_block)) {
+                            resident_blocks[slot] = NO_BLOCK;
+                            continue;
                         }
-                    } catch (const std::exception& e) {
-                        std::cerr << "Error during join: " << e.what() << std::endl;
+                        resident_blocks[slot] = index;
                     }
+
+                    joinInnerBlock(inner_block);
+                    inner_blocks_scanned++;
                 }
             }
-
-            // Inner 블록 정리 (다음 블록 준비)
-            inner_block->clear();
+            inner_pass++;
         }
 
+        scan_span.setArg("blocks", inner_blocks_scanned);
+        scan_span.end();
+
         std::cout << "Scanned " << inner_blocks_scanned << " inner blocks" << std::endl;
     }
 
@@ -293,8 +758,10 @@ void BlockNestedLoopsJoin::joinPartAndPartSupp(
     // 단계 3: 마지막 출력 블록 플러시
     // =========================================================================
     // 버퍼에 남아있는 레코드들을 디스크에 쓰기
-    if (!output_block.isEmpty()) {
-        writer.writeBlock(&output_block);
+    if (!output_block->isEmpty()) {
+        MemoryPhaseScope output_phase(MemoryPhase::OUTPUT);
+        TRACE_SPAN("flush", "join");
+        sink.writeBlock(output_block);
     }
 
     std::cout << "\nJoin completed!" << std::endl;
@@ -0,0 +1,510 @@
+#include "join_planner.h"
+#include "file_header.h"
+#include "file_manager.h"
+#include "optimized_join.h"
+#include "memory_governor.h"
+#include "memory_tracker.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// ============================================================================
+// 테이블 메타데이터
+// ============================================================================
+TableProfile TableProfile::load(const std::string& file, const std::string& type,
+                                size_t block_size) {
+    TableProfile profile;
+    profile.file = file;
+    profile.type = type;
+
+    FileHeader header;
+    if (readFileHeader(file, header) && header.isComplete()) {
+        profile.blocks = header.block_count;
+        profile.records = header.record_count;
+        profile.sorted = header.hasFlag(FILE_FLAG_SORTED);
+    } else {
+        // 헤더가 없는 이전 형식: 스캔해서 셈
+        FileManager manager(block_size);
+        profile.blocks = countTableBlocks(file, block_size);
+        profile.records = manager.countRecords(file);
+    }
+
+    std::unique_ptr<ZoneMap> zone_map = ZoneMap::loadIfExists(file);
+    if (zone_map && zone_map->size() == profile.blocks) {
+        profile.has_zone_map = true;
+        profile.zones = zone_map->getEntries();
+        profile.has_key_range = zone_map->getKeyRange(profile.key_min, profile.key_max);
+        profile.sorted = profile.sorted || zone_map->isSorted();
+    }
+
+    // 통계는 블록/레코드 수가 파일과 같을 때만 사용 (추가 쓰기 후에는 다시 ANALYZE)
+    std::unique_ptr<TableStats> stats = TableStats::loadIfExists(file);
+    if (stats && stats->record_count == profile.records && stats->block_count == profile.blocks &&
+        !stats->columns.empty()) {
+        profile.stats = std::shared_ptr<TableStats>(stats.release());
+    }
+
+    // 고유 키 개수: 통계의 추정치, 없으면 키 범위 폭을 넘을 수 없음 (범위를 모르면 레코드 수)
+    profile.distinct_keys = profile.records;
+    if (profile.stats) {
+        profile.distinct_keys = std::max<uint64_t>(1, profile.stats->columns[0].distinct);
+    } else if (profile.has_key_range) {
+        uint64_t width = static_cast<uint64_t>(
+            static_cast<int64_t>(profile.key_max) - profile.key_min + 1);
+        profile.distinct_keys = std::min(profile.distinct_keys, width);
+    }
+    return profile;
+}
+
+double TableProfile::recordBytes(size_t block_size) const {
+    if (stats) {
+        return stats->averageRecordWidth();
+    }
+    return records > 0 ? double(blocks) * block_size / double(records) : 0.0;
+}
+
+const char* joinAlgorithmName(JoinAlgorithm algorithm) {
+    switch (algorithm) {
+        case JoinAlgorithm::BLOCK_NESTED_LOOPS: return "BNLJ";
+        case JoinAlgorithm::HASH: return "Hash Join";
+    }
+    return "unknown";
+}
+
+JoinAlgorithm parseJoinAlgorithm(const std::string& name, bool& auto_select) {
+    auto_select = false;
+    if (name == "bnlj") return JoinAlgorithm::BLOCK_NESTED_LOOPS;
+    if (name == "hash") return JoinAlgorithm::HASH;
+    if (name == "auto") {
+        auto_select = true;
+        return JoinAlgorithm::BLOCK_NESTED_LOOPS;
+    }
+    throw std::runtime_error("Unknown join algorithm: " + name + " (use bnlj, hash or auto)");
+}
+
+// ============================================================================
+// JoinPlanner 구현
+// ============================================================================
+JoinPlanner::JoinPlanner(const std::string& file_a, const std::string& type_a,
+                         const std::string& file_b, const std::string& type_b,
+                         const std::string& out_file,
+                         size_t buf_size, size_t blk_size)
+    : output_file(out_file), buffer_size(buf_size), block_size(blk_size),
+      cache_blocks(0), replacement(ReplacementPolicy::MRU), auto_split(false),
+      memory_budget(0), fixed_memory(0), sink_mode(SinkMode::FILE), est_output_records(0), est_output_blocks(0), executed(-1) {
+
+    if (!((type_a == "PART" && type_b == "PARTSUPP") ||
+          (type_a == "PARTSUPP" && type_b == "PART"))) {
+        throw std::runtime_error("Unsupported table types for join");
+    }
+
+    first = TableProfile::load(file_a, type_a, block_size);
+    second = TableProfile::load(file_b, type_b, block_size);
+
+    // 키 범위도 통계도 없는 쪽은 상대 키 집합에 포함된다고 가정
+    if (first.stats || second.stats) {
+        // 통계가 있는 쪽 추정치를 그대로 사용
+    } else if (!first.has_key_range && second.has_key_range) {
+        first.distinct_keys = std::min(first.distinct_keys, second.distinct_keys);
+    } else if (!second.has_key_range) {
+        second.distinct_keys = std::min(second.distinct_keys, first.distinct_keys);
+    }
+}
+
+size_t JoinPlanner::readerBytes(const TableProfile& table) const {
+    return TABLE_STREAM_BUFFER_BYTES + block_size + table.zones.size() * sizeof(ZoneEntry);
+}
+
+void JoinPlanner::overlappingBlocks(const TableProfile& table, int_t lo, int_t hi,
+                                    double& blocks, double& records) {
+    if (!table.has_zone_map) {
+        blocks = static_cast<double>(table.blocks);
+        records = static_cast<double>(table.records);
+        return;
+    }
+
+    blocks = 0;
+    records = 0;
+    for (const auto& zone : table.zones) {
+        if (zone.overlaps(lo, hi)) {
+            blocks += 1;
+            records += zone.record_count;
+        }
+    }
+}
+
+double JoinPlanner::passOverlapReads(const TableProfile& build, const TableProfile& probe,
+                                     size_t passes) {
+    if (!build.has_zone_map || build.zones.empty() || passes == 0) {
+        double blocks = static_cast<double>(probe.blocks), records = 0;
+        if (build.has_key_range) {
+            overlappingBlocks(probe, build.key_min, build.key_max, blocks, records);
+        }
+        return blocks * passes;
+    }
+
+    // build 블록을 passes개 연속 구간으로 나눠 구간마다 겹치는 probe 블록 수를 더함
+    double reads = 0;
+    size_t per_pass = (build.zones.size() + passes - 1) / passes;
+    for (size_t first_zone = 0; first_zone < build.zones.size(); first_zone += per_pass) {
+        size_t last_zone = std::min(first_zone + per_pass, build.zones.size());
+        int_t lo = 0, hi = 0;
+        bool found = false;
+        for (size_t z = first_zone; z < last_zone; ++z) {
+            const ZoneEntry& zone = build.zones[z];
+            if (zone.record_count == 0) continue;
+            if (!found || zone.min_key < lo) lo = zone.min_key;
+            if (!found || zone.max_key > hi) hi = zone.max_key;
+            found = true;
+        }
+        if (!found) continue;
+        double blocks = 0, records = 0;
+        overlappingBlocks(probe, lo, hi, blocks, records);
+        reads += blocks;
+    }
+    return reads;
+}
+
+void JoinPlanner::plan() {
+    // 메모리 예산: --memory-limit가 있으면 그 한도, 없으면 0 (무제한).
+    // BNLJ 버퍼 프레임 수는 BNLJ 계획에만 쓰고 해시 테이블 한도로 쓰지 않음.
+    // 고정 메모리(두 입력 리더, 레코드 디코딩 작업 공간, 출력 스트림)는 실행과 같은 계산이고,
+    // BNLJ 프레임은 한도에서 이를 뺀 나머지를 디코딩한 레코드와 나눠 씀 (bnljFrameBudget)
+    size_t limit = MemoryGovernor::instance().getLimit();
+    fixed_memory = readerBytes(first) + readerBytes(second) + RECORD_DECODE_SCRATCH_BYTES +
+                   (sink_mode == SinkMode::FILE ? TABLE_STREAM_BUFFER_BYTES : 0);
+    if (limit > 0) {
+        size_t frame_bytes = BufferManager::frameBytes(block_size);
+        size_t min_frames = 3 * frame_bytes;
+        size_t frame_budget = limit > fixed_memory ? bnljFrameBudget(limit - fixed_memory) : 0;
+        fitBnljToMemory(std::max(frame_budget, min_frames), frame_bytes, auto_split,
+                        buffer_size, cache_blocks);
+    }
+    memory_budget = limit;
+
+    // 결과 크기: 양쪽 통계가 있으면 빈발 값을 반영, 아니면 |R| × |S| / max(고유 키 수)
+    if (first.stats && second.stats) {
+        est_output_records = estimateJoinSize(*first.stats, 0, *second.stats, 0);
+    } else {
+        double distinct = static_cast<double>(std::max<uint64_t>(
+            1, std::max(first.distinct_keys, second.distinct_keys)));
+        est_output_records = double(first.records) * double(second.records) / distinct;
+    }
+
+    // 결과 레코드 크기: 통계가 있으면 필드 값 폭 + 필드 길이 접두 + 레코드 크기,
+    // 없으면 두 입력 파일의 레코드당 평균 크기 합
+    auto bytesPerRecord = [&](const TableProfile& t) {
+        if (t.stats) {
+            return t.recordBytes(block_size) + sizeof(uint16_t) * t.stats->columns.size();
+        }
+        return t.recordBytes(block_size);
+    };
+    double output_record = bytesPerRecord(first) + bytesPerRecord(second) + sizeof(uint32_t);
+    est_output_blocks = std::ceil(est_output_records * output_record / block_size);
+
+    candidates.clear();
+    candidates.push_back(planBnlj(first, second, true));
+    candidates.push_back(planBnlj(second, first, false));
+    candidates.push_back(planHash(first, second, true));
+    candidates.push_back(planHash(second, first, false));
+}
+
+JoinCandidate JoinPlanner::planBnlj(const TableProfile& outer, const TableProfile& inner,
+                                    bool first_is_outer) const {
+    JoinCandidate c;
+    c.algorithm = JoinAlgorithm::BLOCK_NESTED_LOOPS;
+    c.first_is_outer = first_is_outer;
+    c.bnlj = planBlockNestedLoops(outer.blocks, inner.blocks, buffer_size,
+                                  auto_split ? 0 : 1, auto_split);
+
+    double reads = static_cast<double>(c.bnlj.predicted_reads);
+    double pairs = 0;
+
+    if (c.bnlj.inner_cached) {
+        // inner를 버퍼에 한 번 올리고 청크마다 전부 비교
+        pairs = double(outer.records) * double(inner.records);
+    } else if (outer.has_zone_map && inner.has_zone_map) {
+        // outer 청크의 키 범위와 겹치는 inner 블록만 읽음 (BNLJ의 존 맵 건너뛰기)
+        double skipped_reads = static_cast<double>(outer.blocks);
+        for (size_t first_zone = 0; first_zone < outer.zones.size();
+             first_zone += c.bnlj.outer_buffers) {
+            size_t last_zone = std::min(first_zone + c.bnlj.outer_buffers, outer.zones.size());
+            int_t lo = 0, hi = 0;
+            double chunk_records = 0;
+            bool found = false;
+            for (size_t z = first_zone; z < last_zone; ++z) {
+                const ZoneEntry& zone = outer.zones[z];
+                if (zone.record_count == 0) continue;
+                if (!found || zone.min_key < lo) lo = zone.min_key;
+                if (!found || zone.max_key > hi) hi = zone.max_key;
+                chunk_records += zone.record_count;
+                found = true;
+            }
+            if (!found) continue;
+
+            double blocks = 0, records = 0;
+            overlappingBlocks(inner, lo, hi, blocks, records);
+            skipped_reads += blocks;
+            pairs += chunk_records * records;
+        }
+        // 건너뛰는 블록이 있으면 방향 전환으로 아끼는 읽기는 무시
+        reads = std::min(reads, skipped_reads);
+    } else {
+        pairs = double(outer.records) * double(inner.records);
+    }
+
+    c.est_reads = reads;
+    c.est_seeks = static_cast<double>(c.bnlj.predicted_seeks);
+    c.est_writes = est_output_blocks;
+    c.est_cpu_ops = pairs;
+    // 고정 메모리 + 버퍼/캐시 프레임 + 디코딩한 outer 청크와 inner 블록 (캐시면 inner 전체)
+    double decoded_blocks = double(c.bnlj.outer_buffers) +
+                            (c.bnlj.inner_cached ? double(inner.blocks) : 1.0);
+    c.est_memory = double(fixed_memory) +
+                   double(buffer_size + cache_blocks) * BufferManager::frameBytes(block_size) +
+                   decoded_blocks * block_size * BNLJ_DECODED_BLOCK_RATIO;
+    if (memory_budget > 0) {
+        c.est_memory = std::min(c.est_memory, double(memory_budget));
+    }
+    c.est_cost_us = c.est_reads * COST_BLOCK_READ_US + c.est_seeks * COST_SEEK_US +
+                    c.est_writes * COST_BLOCK_WRITE_US + pairs * COST_PAIR_US +
+                    est_output_records * COST_OUTPUT_US;
+
+    std::ostringstream note;
+    note << c.bnlj.outer_chunks << " chunks x " << c.bnlj.outer_buffers << " outer buffers, "
+         << c.bnlj.inner_buffers << " inner buffers" << (c.bnlj.inner_cached ? " (cached)" : "");
+    c.note = note.str();
+    return c;
+}
+
+JoinCandidate JoinPlanner::planHash(const TableProfile& build, const TableProfile& probe,
+                                    bool first_is_outer) const {
+    JoinCandidate c;
+    c.algorithm = JoinAlgorithm::HASH;
+    c.first_is_outer = first_is_outer;
+
+    // probe는 build 키 범위와 겹치는 블록만 읽음
+    double probe_blocks = static_cast<double>(probe.blocks);
+    double probe_records = static_cast<double>(probe.records);
+    if (build.has_key_range) {
+        overlappingBlocks(probe, build.key_min, build.key_max, probe_blocks, probe_records);
+    }
+
+    // 해시 테이블: 레코드 객체 + 문자열 내용 + 키별 오버헤드
+    double record_object = build.type == "PART" ? sizeof(PartRecord) : sizeof(PartSuppRecord);
+    double record_bytes = build.recordBytes(block_size);
+    double table_memory = double(build.records) * (record_object + record_bytes) +
+                          double(build.distinct_keys) * HASH_ENTRY_OVERHEAD;
+
+    c.est_reads = double(build.blocks) + probe_blocks;
+    c.est_seeks = 2;
+    c.est_writes = est_output_blocks;
+    c.est_cpu_ops = double(build.records) + probe_records;
+
+    // 입출력 블록 3개를 뺀 나머지가 해시 테이블 자리 (한도가 없으면 무제한). 넘치면 HashJoin처럼
+    // 파티션으로 나누고 (파티션마다 출력 블록 하나), 파티션도 넘치면 여러 번 나눠 채움
+    double io_memory = 3.0 * block_size + double(fixed_memory);
+    double room = memory_budget > 0 ? std::max(0.0, double(memory_budget) - io_memory)
+                                    : table_memory;
+    std::ostringstream note;
+    if (table_memory <= room) {
+        c.est_memory = table_memory + io_memory;
+        note << "probe " << static_cast<size_t>(probe_blocks) << " of " << probe.blocks
+             << " blocks";
+    } else if (room < block_size + HASH_PARTITION_WRITER_BYTES) {
+        c.feasible = false;
+        c.est_memory = table_memory + io_memory;
+        note << "memory budget " << memory_budget / 1024 << " KB leaves no room for a hash table";
+    } else {
+        c.est_memory = double(memory_budget);
+        size_t max_partitions = static_cast<size_t>(room / (block_size + HASH_PARTITION_WRITER_BYTES));
+        size_t partitions = static_cast<size_t>(std::ceil(1.25 * table_memory / room));
+        partitions = std::min(std::max<size_t>(partitions, 2), max_partitions);
+
+        // 넘칠 때까지 읽은 build 블록
+        double partial_reads = double(build.blocks) * room / table_memory;
+        if (partitions < 2) {
+            // 채우기마다 build를 파일 순서로 이어 읽으므로, 채운 구간의 키 범위와
+            // 겹치는 probe 블록만 읽음 (BNLJ 청크와 같은 존 맵 계산)
+            double passes = std::ceil(table_memory / room);
+            c.est_reads = partial_reads + double(build.blocks) +
+                          passOverlapReads(build, probe, static_cast<size_t>(passes));
+            c.est_seeks = 2 * passes;
+            note << "build in " << static_cast<size_t>(passes) << " passes";
+        } else {
+            // 두 입력을 파티션으로 한 번 쓰고 다시 읽음 (probe는 전체를 파티션으로 나눔)
+            double passes = std::ceil(table_memory / partitions / room);
+            c.est_reads = partial_reads + 2.0 * double(build.blocks) + double(probe.blocks) +
+                          passes * double(probe.blocks);
+            c.est_writes += double(build.blocks + probe.blocks) + 2.0 * partitions;
+            c.est_seeks = 2 + 2.0 * partitions * passes;
+            c.est_cpu_ops += double(build.records) + double(probe.records) * passes;
+            note << "spills to " << partitions << " partitions";
+            if (passes > 1) {
+                note << " x " << static_cast<size_t>(passes) << " passes";
+            }
+        }
+    }
+    c.est_cost_us = c.est_reads * COST_BLOCK_READ_US + c.est_seeks * COST_SEEK_US +
+                    c.est_writes * COST_BLOCK_WRITE_US +
+                    c.est_cpu_ops * (COST_PARSE_US + COST_HASH_US) +
+                    est_output_records * COST_OUTPUT_US;
+    c.note = note.str();
+    return c;
+}
+
+size_t JoinPlanner::chooseBest() const {
+    bool found = false;
+    size_t best = 0;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (!candidates[i].feasible) continue;
+        if (!found || candidates[i].est_cost_us < candidates[best].est_cost_us) {
+            best = i;
+            found = true;
+        }
+    }
+    if (!found) {
+        throw std::runtime_error("No feasible join plan");
+    }
+    return best;
+}
+
+size_t JoinPlanner::chooseBest(JoinAlgorithm only_algorithm) const {
+    // 실행 가능한 후보 우선, 같으면 비용 순 (지정한 알고리즘은 예산을 넘어도 실행)
+    bool found = false;
+    size_t best = 0;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const JoinCandidate& c = candidates[i];
+        if (c.algorithm != only_algorithm) continue;
+        bool better = !found ||
+                      (c.feasible && !candidates[best].feasible) ||
+                      (c.feasible == candidates[best].feasible &&
+                       c.est_cost_us < candidates[best].est_cost_us);
+        if (better) {
+            best = i;
+            found = true;
+        }
+    }
+    if (!found) {
+        throw std::runtime_error("Join plan not found");
+    }
+    return best;
+}
+
+size_t JoinPlanner::findCandidate(JoinAlgorithm algorithm, bool first_is_outer) const {
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (candidates[i].algorithm == algorithm &&
+            candidates[i].first_is_outer == first_is_outer) {
+            return i;
+        }
+    }
+    throw std::runtime_error("Join plan not found");
+}
+
+void JoinPlanner::execute(size_t index) {
+    const JoinCandidate& c = candidates.at(index);
+    if (!c.feasible) {
+        std::cerr << "Warning: " << joinAlgorithmName(c.algorithm) << " plan exceeds the memory budget ("
+                  << c.note << "), running it as requested" << std::endl;
+    }
+
+    const TableProfile& left = c.first_is_outer ? first : second;
+    const TableProfile& right = c.first_is_outer ? second : first;
+
+    if (c.algorithm == JoinAlgorithm::BLOCK_NESTED_LOOPS) {
+        BlockNestedLoopsJoin join(left.file, right.file, output_file,
+                                  left.type, right.type, buffer_size, block_size);
+        join.setInnerCache(cache_blocks, replacement);
+        join.setAutoPlan(auto_split, false);
+        join.setSink(sink_mode);
+        join.execute();
+        actual = join.getStatistics();
+    } else {
+        HashJoin join(left.file, right.file, output_file, left.type, right.type, block_size);
+        join.setMemoryBudget(memory_budget);
+        join.setSink(sink_mode);
+        join.execute();
+        actual = join.getStatistics();
+    }
+    executed = static_cast<int>(index);
+}
+
+// ============================================================================
+// EXPLAIN 출력
+// ============================================================================
+void JoinPlanner::printExplain(std::ostream& out) const {
+    auto describe = [&](const char* label, const TableProfile& t) {
+        out << "  [" << label << "] " << t.file << " (" << t.type << "): "
+            << t.blocks << " blocks, " << t.records << " records";
+        if (t.has_key_range) {
+            out << ", keys " << t.key_min << ".." << t.key_max;
+        }
+        out << ", ~" << t.distinct_keys << " distinct"
+            << (t.sorted ? ", sorted" : "")
+            << (t.has_zone_map ? ", zone map" : "")
+            << (t.stats ? ", statistics" : "") << std::endl;
+    };
+
+    out << "\n=== Join Plan (EXPLAIN) ===" << std::endl;
+    out << "Tables:" << std::endl;
+    describe("1", first);
+    describe("2", second);
+    if (memory_budget > 0) {
+        out << "Memory Budget: " << memory_budget / 1024 << " KB (--memory-limit)";
+    } else {
+        out << "Memory Budget: unlimited";
+    }
+    out << ", BNLJ " << buffer_size << " buffers + " << cache_blocks << " cache blocks" << std::endl;
+    out << "Estimated Output: " << static_cast<size_t>(est_output_records) << " records, "
+        << static_cast<size_t>(est_output_blocks) << " blocks\n" << std::endl;
+
+    out << "  " << std::left << std::setw(11) << "Algorithm"
+        << std::setw(12) << "Outer/Build"
+        << std::right << std::setw(10) << "Reads"
+        << std::setw(8) << "Seeks"
+        << std::setw(14) << "CPU Ops"
+        << std::setw(12) << "Memory(KB)"
+        << std::setw(14) << "Est. Time(ms)" << "  Notes" << std::endl;
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const JoinCandidate& c = candidates[i];
+        const TableProfile& left = c.first_is_outer ? first : second;
+        out << (static_cast<int>(i) == executed ? "* " : "  ")
+            << std::left << std::setw(11) << joinAlgorithmName(c.algorithm)
+            << std::setw(12) << left.type
+            << std::right << std::setw(10) << static_cast<size_t>(c.est_reads)
+            << std::setw(8) << static_cast<size_t>(c.est_seeks)
+            << std::setw(14) << static_cast<size_t>(c.est_cpu_ops)
+            << std::setw(12) << static_cast<size_t>(c.est_memory / 1024)
+            << std::setw(14) << std::fixed << std::setprecision(1) << c.est_cost_us / 1000.0
+            << "  " << (c.feasible ? "" : "infeasible: ") << c.note << std::endl;
+        out.unsetf(std::ios::fixed);
+        out << std::setprecision(6);
+    }
+
+    if (executed < 0) {
+        return;
+    }
+
+    const JoinCandidate& c = candidates[executed];
+    const TableProfile& left = c.first_is_outer ? first : second;
+    out << "\nEstimated vs Actual (" << joinAlgorithmName(c.algorithm) << ", "
+        << (c.algorithm == JoinAlgorithm::HASH ? "build " : "outer ") << left.type << "):"
+        << std::endl;
+    out << "  Block Reads:    " << static_cast<size_t>(c.est_reads)
+        << " / " << actual.block_reads << std::endl;
+    out << "  Block Writes:   " << static_cast<size_t>(c.est_writes)
+        << " / " << actual.block_writes << std::endl;
+    out << "  Output Records: " << static_cast<size_t>(est_output_records)
+        << " / " << actual.output_records << std::endl;
+    out << "  Memory (KB):    " << static_cast<size_t>(c.est_memory / 1024)
+        << " / " << actual.tracked_memory_peak / 1024
+        << (DBSYS_TRACK_ALLOC ? " (tracked peak)" : " (allocation tracking disabled)") << std::endl;
+    out << "  Elapsed (ms):   " << std::fixed << std::setprecision(1)
+        << c.est_cost_us / 1000.0 << " / " << actual.elapsed_time * 1000.0 << std::endl;
+    out.unsetf(std::ios::fixed);
+    out << std::setprecision(6);
+}
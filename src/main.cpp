@@ -4,9 +4,45 @@
 #include "table.h"
 #include "buffer.h"
 #include "join.h"
+#include "join_planner.h"
+#include "benchmark.h"
+#include "table_stats.h"
+#include "delta_join.h"
+#include "memory_governor.h"
+#include "phase_timer.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include "pax.h"
+#include "file_manager.h"
+#include "tpch_gen.h"
 #include <iostream>
+#include <chrono>
 #include <cstring>
 #include <cstdlib>
+#include <utility>
+
+// --sink checksum 결과 출력
+static void printResultChecksum(const Statistics& stats) {
+    if (stats.has_checksum) {
+        std::cout << "Result Checksum: " << checksumString(stats.result_checksum) << " ("
+                  << stats.output_records << " rows)" << std::endl;
+    }
+}
+
+// 파일 헤더로 테이블 타입과 블록 크기 채우기 (명시한 값이 우선)
+static void applyFileHeader(const std::string& block_file, std::string& table_type,
+                            size_t& block_size, bool block_size_given) {
+    FileHeader header;
+    if (block_file.empty() || !readFileHeader(block_file, header)) {
+        return;
+    }
+    if (table_type.empty()) {
+        table_type = header.table_type;
+    }
+    if (!block_size_given && header.block_size != 0) {
+        block_size = header.block_size;
+    }
+}
 
 void printUsage(const char* program_name) {
     std::cout << "Usage: " << program_name << " [OPTION]...\n\n";
@@ -15,15 +51,79 @@ void printUsage(const char* program_name) {
     std::cout << "      --csv-file FILE      Input CSV file path\n";
     std::cout << "      --block-file FILE    Output block file path\n";
     std::cout << "      --table-type TYPE    Table type (PART or PARTSUPP)\n";
-    std::cout << "      --block-size SIZE    Block size in bytes (default: 4096)\n\n";
+    std::cout << "      --block-size SIZE    Block size in bytes (default: 4096)\n";
+    std::cout << "      --record-format FMT  Record encoding: row or indexed (default: row)\n";
+    std::cout << "      --dict-encode        Dictionary-encode PART mfgr/brand/type/container\n";
+    std::cout << "      --compress           Compress each block (LZ/RLE/delta, chosen per page)\n";
+    std::cout << "      --threads NUM        Parser threads (default: hardware threads)\n";
+    std::cout << "      --append             Append to an existing block file (keeps its format)\n\n";
+    std::cout << "  --generate           Generate TPC-H data directly into a block file\n";
+    std::cout << "      --table TYPE         Table to generate (PART or PARTSUPP)\n";
+    std::cout << "      --scale-factor SF    TPC-H scale factor (PART = SF x 200,000 rows)\n";
+    std::cout << "      --block-file FILE    Output block file path\n";
+    std::cout << "      --seed NUM           Random seed (same seed = same file)\n";
+    std::cout << "      --threads NUM        Generator threads (default: hardware threads)\n";
+    std::cout << "      (also --block-size, --record-format, --dict-encode, --compress)\n\n";
+    std::cout << "  --info               Print file metadata from the block file header\n";
+    std::cout << "      --block-file FILE    Block file path\n\n";
+    std::cout << "  --analyze            Compute column statistics into FILE.stats (used by the join planner)\n";
+    std::cout << "      --block-file FILE    Block file path\n";
+    std::cout << "      --table-type TYPE    Table type (default: from file header)\n";
+    std::cout << "      --threads NUM        Scan threads (default: hardware threads)\n";
+    std::cout << "      --block-size SIZE    Block size in bytes (default: from file header)\n\n";
+    std::cout << "  --scan               Count records matching an equality filter\n";
+    std::cout << "      --block-file FILE    Block file path\n";
+    std::cout << "      --table-type TYPE    Table type (default: from file header)\n";
+    std::cout << "      --filter COL=VALUE   Equality predicate (e.g. brand=Brand#23)\n";
+    std::cout << "      --block-size SIZE    Block size in bytes (default: from file header)\n\n";
+    std::cout << "  --convert-layout     Convert a block file between row and PAX layouts\n";
+    std::cout << "      --block-file FILE    Input block file path\n";
+    std::cout << "      --output FILE        Output block file path\n";
+    std::cout << "      --table-type TYPE    Table type (default: from file header)\n";
+    std::cout << "      --layout LAYOUT      Target layout: row or pax\n";
+    std::cout << "      --compress           Compress each block of the output file\n";
+    std::cout << "      --block-size SIZE    Block size in bytes (default: from file header)\n\n";
     std::cout << "  --join               Perform Block Nested Loops Join\n";
     std::cout << "      --outer-table FILE   Outer table file (block format)\n";
     std::cout << "      --inner-table FILE   Inner table file (block format)\n";
-    std::cout << "      --outer-type TYPE    Outer table type (PART or PARTSUPP)\n";
-    std::cout << "      --inner-type TYPE    Inner table type (PART or PARTSUPP)\n";
+    std::cout << "      --outer-type TYPE    Outer table type (default: from file header)\n";
+    std::cout << "      --inner-type TYPE    Inner table type (default: from file header)\n";
     std::cout << "      --output FILE        Output file path\n";
     std::cout << "      --buffer-size NUM    Number of buffer blocks (default: 10)\n";
-    std::cout << "      --block-size SIZE    Block size in bytes (default: 4096)\n\n";
+    std::cout << "      --cache-size NUM     Extra buffer pool frames caching inner pages (default: 0)\n";
+    std::cout << "      --replacement POL    Cache replacement: clock, lru-k or mru (default: mru)\n";
+    std::cout << "      --auto               Pick outer/inner and the buffer split (output block in budget)\n";
+    std::cout << "      --algorithm ALG      Join algorithm: bnlj, hash or auto (cheapest estimated plan)\n";
+    std::cout << "      --explain            Print estimated costs of every plan and the actual cost\n";
+    std::cout << "      --memory-limit SIZE  Process-wide memory budget, e.g. 256K or 64M (default: unlimited)\n";
+    std::cout << "      --sink MODE          Result sink: file, null (encode and discard), count or\n";
+    std::cout << "                           checksum (order-independent hash of the rows) (default: file)\n";
+    std::cout << "      --stats-json FILE    Write join statistics and phase times as JSON (- = stdout)\n";
+    std::cout << "      --perf-counters      Count cycles, instructions and cache/branch/TLB misses per phase\n";
+    std::cout << "      --block-size SIZE    Block size in bytes (default: from file header)\n\n";
+    std::cout << "  --delta-join         Update a PART x PARTSUPP result with rows appended since the last run\n";
+    std::cout << "      --outer-table FILE   PART or PARTSUPP table file (block format)\n";
+    std::cout << "      --inner-table FILE   The other table file (block format)\n";
+    std::cout << "      --output FILE        Result file (watermark kept in FILE.wm)\n";
+    std::cout << "      --memory-limit SIZE  Process-wide memory budget (default: unlimited)\n";
+    std::cout << "      --stats-json FILE    Write join statistics and phase times as JSON (- = stdout)\n";
+    std::cout << "      --perf-counters      Count hardware events per phase (Linux perf_event_open)\n";
+    std::cout << "      --block-size SIZE    Block size in bytes (default: from file header)\n\n";
+    std::cout << "  --benchmark          Time every combination of the comma-separated options below\n";
+    std::cout << "      --outer-table FILE   Outer table file (or --scale-factor SF to generate the input)\n";
+    std::cout << "      --inner-table FILE   Inner table file\n";
+    std::cout << "      --output FILE        Join output path, overwritten by every run\n";
+    std::cout << "      --algorithm LIST     bnlj, hash and/or auto (default: bnlj,hash)\n";
+    std::cout << "      --buffer-size LIST   Buffer blocks, e.g. 5,10,20 (default: 10)\n";
+    std::cout << "      --block-size LIST    Block sizes, more than one needs --scale-factor\n";
+    std::cout << "      --warmup NUM         Unmeasured runs per combination (default: 1)\n";
+    std::cout << "      --repetitions NUM    Measured runs per combination (default: 5)\n";
+    std::cout << "      --drop-caches        Drop the page cache before every run (Linux)\n";
+    std::cout << "      --sink MODE          Result sink for every run (default: file)\n";
+    std::cout << "      --bench-csv FILE     Write one CSV row per combination (- = stdout)\n";
+    std::cout << "      --bench-json FILE    Write the configuration and results as JSON (- = stdout)\n\n";
+    std::cout << "Any mode:\n";
+    std::cout << "  --trace FILE         Write a Chrome/Perfetto trace-event timeline of the run to FILE\n\n";
     std::cout << "Examples:\n";
     std::cout << "  # Convert PART CSV to block format\n";
     std::cout << "  " << program_name << " --convert-csv --csv-file data/part.tbl \\\n";
@@ -46,7 +146,30 @@ int main(int argc, char* argv[]) {
         std::string csv_file, block_file, table_type;
         std::string outer_table, inner_table, outer_type, inner_type, output_file;
         size_t buffer_size = 10;
+        size_t cache_size = 0;
+        ReplacementPolicy replacement = ReplacementPolicy::MRU;
         size_t block_size = DEFAULT_BLOCK_SIZE;
+        bool block_size_given = false;
+        RecordEncoding record_format = RecordEncoding::LENGTH_PREFIXED;
+        std::string layout;
+        std::string filter;
+        bool dict_encode = false;
+        bool compress = false;
+        bool append = false;
+        bool auto_plan = false;
+        std::string algorithm;
+        bool explain = false;
+        std::string stats_json;
+        SinkMode sink = SinkMode::FILE;
+        size_t num_threads = 0;
+        double scale_factor = 0;
+        uint64_t seed = TPCH_DEFAULT_SEED;
+
+        // --benchmark: 쉼표로 구분한 목록을 받는 옵션은 원문도 보관
+        std::string buffer_size_list, block_size_list, threads_list;
+        size_t warmups = 1, repetitions = 5;
+        bool drop_caches = false;
+        std::string bench_csv, bench_json;
 
         // 인자 파싱
         for (int i = 1; i < argc; ++i) {
@@ -54,14 +177,32 @@ int main(int argc, char* argv[]) {
 
             if (arg == "--convert-csv") {
                 mode = "convert";
+            } else if (arg == "--generate") {
+                mode = "generate";
+            } else if ((arg == "--table" || arg == "--table-type") && i + 1 < argc) {
+                table_type = argv[++i];
+            } else if (arg == "--scale-factor" && i + 1 < argc) {
+                scale_factor = std::atof(argv[++i]);
+            } else if (arg == "--seed" && i + 1 < argc) {
+                seed = std::strtoull(argv[++i], nullptr, 10);
+            } else if (arg == "--info") {
+                mode = "info";
+            } else if (arg == "--analyze") {
+                mode = "analyze";
+            } else if (arg == "--scan") {
+                mode = "scan";
+            } else if (arg == "--convert-layout") {
+                mode = "convert-layout";
             } else if (arg == "--join") {
                 mode = "join";
+            } else if (arg == "--delta-join") {
+                mode = "delta-join";
+            } else if (arg == "--benchmark") {
+                mode = "benchmark";
             } else if (arg == "--csv-file" && i + 1 < argc) {
                 csv_file = argv[++i];
             } else if (arg == "--block-file" && i + 1 < argc) {
                 block_file = argv[++i];
-            } else if (arg == "--table-type" && i + 1 < argc) {
-                table_type = argv[++i];
             } else if (arg == "--outer-table" && i + 1 < argc) {
                 outer_table = argv[++i];
             } else if (arg == "--inner-table" && i + 1 < argc) {
@@ -73,9 +214,57 @@ int main(int argc, char* argv[]) {
             } else if (arg == "--output" && i + 1 < argc) {
                 output_file = argv[++i];
             } else if (arg == "--buffer-size" && i + 1 < argc) {
-                buffer_size = std::atoi(argv[++i]);
+                buffer_size_list = argv[++i];
+                buffer_size = std::atoi(buffer_size_list.c_str());
+            } else if (arg == "--cache-size" && i + 1 < argc) {
+                cache_size = std::atoi(argv[++i]);
+            } else if (arg == "--replacement" && i + 1 < argc) {
+                replacement = parseReplacementPolicy(argv[++i]);
             } else if (arg == "--block-size" && i + 1 < argc) {
-                block_size = std::atoi(argv[++i]);
+                block_size_list = argv[++i];
+                block_size = std::atoi(block_size_list.c_str());
+                block_size_given = true;
+            } else if (arg == "--record-format" && i + 1 < argc) {
+                record_format = parseRecordEncoding(argv[++i]);
+            } else if (arg == "--dict-encode") {
+                dict_encode = true;
+            } else if (arg == "--compress") {
+                compress = true;
+            } else if (arg == "--auto") {
+                auto_plan = true;
+            } else if (arg == "--algorithm" && i + 1 < argc) {
+                algorithm = argv[++i];
+            } else if (arg == "--explain") {
+                explain = true;
+            } else if (arg == "--memory-limit" && i + 1 < argc) {
+                MemoryGovernor::instance().setLimit(parseMemorySize(argv[++i]));
+            } else if (arg == "--sink" && i + 1 < argc) {
+                sink = parseSinkMode(argv[++i]);
+            } else if (arg == "--stats-json" && i + 1 < argc) {
+                stats_json = argv[++i];
+            } else if (arg == "--trace" && i + 1 < argc) {
+                Trace::start(argv[++i]);
+            } else if (arg == "--perf-counters") {
+                PerfCounters::setEnabled(true);
+            } else if (arg == "--warmup" && i + 1 < argc) {
+                warmups = std::atoi(argv[++i]);
+            } else if (arg == "--repetitions" && i + 1 < argc) {
+                repetitions = std::atoi(argv[++i]);
+            } else if (arg == "--drop-caches") {
+                drop_caches = true;
+            } else if (arg == "--bench-csv" && i + 1 < argc) {
+                bench_csv = argv[++i];
+            } else if (arg == "--bench-json" && i + 1 < argc) {
+                bench_json = argv[++i];
+            } else if (arg == "--append") {
+                append = true;
+            } else if (arg == "--threads" && i + 1 < argc) {
+                threads_list = argv[++i];
+                num_threads = std::atoi(threads_list.c_str());
+            } else if (arg == "--filter" && i + 1 < argc) {
+                filter = argv[++i];
+            } else if (arg == "--layout" && i + 1 < argc) {
+                layout = argv[++i];
             } else if (arg == "--help" || arg == "-h") {
                 printUsage(argv[0]);
                 return 0;
@@ -94,44 +283,315 @@ int main(int argc, char* argv[]) {
                 return 1;
             }
 
-            std::cout << "Converting CSV to block format...\n";
+            std::cout << (append ? "Appending CSV to block file...\n"
+                                 : "Converting CSV to block format...\n");
             std::cout << "Input: " << csv_file << "\n";
             std::cout << "Output: " << block_file << "\n";
             std::cout << "Table Type: " << table_type << "\n";
-            std::cout << "Block Size: " << block_size << " bytes\n\n";
+            if (!append) {
+                std::cout << "Block Size: " << block_size << " bytes\n";
+                std::cout << "Record Format: "
+                          << (record_format == RecordEncoding::OFFSET_INDEXED ? "indexed" : "row")
+                          << "\n";
+            }
+            std::cout << "\n";
+
+            convertCSVToBlocks(csv_file, block_file, table_type, block_size, record_format,
+                               dict_encode, compress, num_threads, append);
+
+            std::cout << "Conversion completed successfully!\n";
+        }
+        // 데이터 생성 모드
+        else if (mode == "generate") {
+            if (block_file.empty() || table_type.empty() || scale_factor <= 0) {
+                std::cerr << "Error: Missing required arguments for data generation\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+
+            auto start_time = std::chrono::high_resolution_clock::now();
+            generateTpchTable(block_file, table_type, scale_factor, seed, block_size,
+                              record_format, dict_encode, compress, num_threads);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> elapsed = end_time - start_time;
+
+            std::cout << "Elapsed Time: " << elapsed.count() << " seconds" << std::endl;
+        }
+        // 파일 정보 모드
+        else if (mode == "info") {
+            if (block_file.empty()) {
+                std::cerr << "Error: Missing required arguments for info\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+
+            FileManager fm(block_size, 1);
+            fm.printFileInfo(block_file);
+        }
+        // 통계 수집 모드
+        else if (mode == "analyze") {
+            applyFileHeader(block_file, table_type, block_size, block_size_given);
+            if (block_file.empty() || table_type.empty()) {
+                std::cerr << "Error: Missing required arguments for analyze\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+
+            auto start_time = std::chrono::high_resolution_clock::now();
+            Statistics io_stats;
+            TableStats stats = TableStats::analyze(block_file, table_type, block_size,
+                                                   num_threads, &io_stats);
+            stats.save(block_file);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> elapsed = end_time - start_time;
+
+            stats.print(std::cout);
+            std::cout << "\nStatistics File: " << TableStats::sidecarPath(block_file) << std::endl;
+            std::cout << "Block Reads: " << io_stats.block_reads << std::endl;
+            std::cout << "Elapsed Time: " << elapsed.count() << " seconds" << std::endl;
+        }
+        // 필터 스캔 모드
+        else if (mode == "scan") {
+            applyFileHeader(block_file, table_type, block_size, block_size_given);
+            size_t eq_pos = filter.find('=');
+            if (block_file.empty() || table_type.empty() || eq_pos == std::string::npos) {
+                std::cerr << "Error: Missing required arguments for scan\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+
+            std::string column = filter.substr(0, eq_pos);
+            std::string value = filter.substr(eq_pos + 1);
+
+            auto start_time = std::chrono::high_resolution_clock::now();
+            FileManager fm(block_size, 1);
+            size_t matches = fm.countMatching(block_file, table_type, column, value);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> elapsed = end_time - start_time;
+
+            std::cout << "Filter: " << column << " = '" << value << "'" << std::endl;
+            std::cout << "Matching Records: " << matches << std::endl;
+            std::cout << "Block Reads: " << fm.getStatistics().block_reads << std::endl;
+            std::cout << "Physical Reads: " << fm.getStatistics().physical_block_reads << std::endl;
+            std::cout << "Blocks Skipped: " << fm.getStatistics().blocks_skipped << std::endl;
+            std::cout << "Elapsed Time: " << elapsed.count() << " seconds" << std::endl;
+        }
+        // 레이아웃 변환 모드
+        else if (mode == "convert-layout") {
+            applyFileHeader(block_file, table_type, block_size, block_size_given);
+            if (block_file.empty() || output_file.empty() ||
+                table_type.empty() || layout.empty()) {
+                std::cerr << "Error: Missing required arguments for layout conversion\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+
+            std::cout << "Converting block layout...\n";
+            std::cout << "Input: " << block_file << "\n";
+            std::cout << "Output: " << output_file << "\n";
+            std::cout << "Table Type: " << table_type << "\n";
+            std::cout << "Layout: " << layout << "\n\n";
 
-            convertCSVToBlocks(csv_file, block_file, table_type, block_size);
+            convertBlockLayout(block_file, output_file, table_type,
+                               parseBlockLayout(layout), block_size, compress);
 
             std::cout << "Conversion completed successfully!\n";
         }
         // Join 모드
         else if (mode == "join") {
+            applyFileHeader(outer_table, outer_type, block_size, block_size_given);
+            applyFileHeader(inner_table, inner_type, block_size, true);
             if (outer_table.empty() || inner_table.empty() ||
-                outer_type.empty() || inner_type.empty() || output_file.empty()) {
+                outer_type.empty() || inner_type.empty() ||
+                (sink == SinkMode::FILE && output_file.empty())) {
                 std::cerr << "Error: Missing required arguments for join\n";
                 printUsage(argv[0]);
                 return 1;
             }
 
-            std::cout << "=== Block Nested Loops Join ===" << std::endl;
+            bool use_planner = explain || !algorithm.empty();
+            std::cout << (use_planner ? "=== Cost-Based Join ===" : "=== Block Nested Loops Join ===")
+                      << std::endl;
             std::cout << "Outer Table: " << outer_table << " (" << outer_type << ")" << std::endl;
             std::cout << "Inner Table: " << inner_table << " (" << inner_type << ")" << std::endl;
-            std::cout << "Output File: " << output_file << std::endl;
+            if (sink == SinkMode::FILE) {
+                std::cout << "Output File: " << output_file << std::endl;
+            } else {
+                std::cout << "Result Sink: " << sinkModeName(sink) << " (no output file)" << std::endl;
+            }
             std::cout << "Buffer Size: " << buffer_size << " blocks" << std::endl;
             std::cout << "Block Size: " << block_size << " bytes" << std::endl;
-            std::cout << "Total Memory: " << (buffer_size * block_size / 1024.0 / 1024.0)
+            if (cache_size > 0) {
+                std::cout << "Inner Cache: " << cache_size << " blocks ("
+                          << replacementPolicyName(replacement) << ")" << std::endl;
+            }
+            std::cout << "Total Memory: "
+                      << ((buffer_size + cache_size) * block_size / 1024.0 / 1024.0)
                       << " MB" << std::endl;
+            if (MemoryGovernor::instance().getLimit() > 0) {
+                std::cout << "Memory Limit: " << MemoryGovernor::instance().getLimit() / 1024
+                          << " KB" << std::endl;
+            }
             std::cout << "\nExecuting join...\n" << std::endl;
 
-            BlockNestedLoopsJoin join(outer_table, inner_table, output_file,
-                                     outer_type, inner_type,
-                                     buffer_size, block_size);
-            join.execute();
+            if (use_planner) {
+                // 계획기: 후보 비용을 계산하고 선택한 계획 실행
+                bool auto_select = false;
+                JoinAlgorithm chosen_algorithm =
+                    parseJoinAlgorithm(algorithm.empty() ? "bnlj" : algorithm, auto_select);
+
+                JoinPlanner planner(outer_table, outer_type, inner_table, inner_type,
+                                    output_file, buffer_size, block_size);
+                planner.setInnerCache(cache_size, replacement);
+                planner.setAutoSplit(auto_plan);
+                planner.setSink(sink);
+                planner.plan();
+
+                // auto: 가장 싼 계획, 알고리즘 지정 + --auto: 그 알고리즘의 싼 방향,
+                // 그 외: 지정한 outer(build) 테이블 그대로
+                size_t choice = auto_select ? planner.chooseBest()
+                              : auto_plan ? planner.chooseBest(chosen_algorithm)
+                              : planner.findCandidate(chosen_algorithm, true);
+                const JoinCandidate& candidate = planner.getCandidates()[choice];
+                std::cout << "Chosen Plan: " << joinAlgorithmName(candidate.algorithm) << " ("
+                          << (candidate.algorithm == JoinAlgorithm::HASH ? "build " : "outer ")
+                          << (candidate.first_is_outer ? outer_type : inner_type) << ")\n"
+                          << std::endl;
+
+                planner.execute(choice);
+                printResultChecksum(planner.getStatistics());
+                if (explain) {
+                    planner.printExplain(std::cout);
+                }
+                if (!stats_json.empty()) {
+                    writeStatisticsJson(stats_json,
+                                        candidate.algorithm == JoinAlgorithm::HASH ? "hash" : "bnlj",
+                                        planner.getStatistics());
+                }
+            } else {
+                BlockNestedLoopsJoin join(outer_table, inner_table, output_file,
+                                         outer_type, inner_type,
+                                         buffer_size, block_size);
+                join.setInnerCache(cache_size, replacement);
+                join.setAutoPlan(auto_plan);
+                join.setSink(sink);
+                join.execute();
+                printResultChecksum(join.getStatistics());
+                if (!stats_json.empty()) {
+                    writeStatisticsJson(stats_json, "bnlj", join.getStatistics());
+                }
+            }
 
             std::cout << "\nJoin completed successfully!\n";
         }
+        // 증분 조인 모드
+        else if (mode == "delta-join") {
+            applyFileHeader(outer_table, outer_type, block_size, block_size_given);
+            applyFileHeader(inner_table, inner_type, block_size, true);
+            if (outer_table.empty() || inner_table.empty() || output_file.empty()) {
+                std::cerr << "Error: Missing required arguments for delta join\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+
+            // 입력 순서와 관계없이 PART / PARTSUPP 구분
+            std::string part_table = outer_table, partsupp_table = inner_table;
+            if (outer_type == "PARTSUPP" && inner_type == "PART") {
+                std::swap(part_table, partsupp_table);
+            } else if (outer_type != "PART" || inner_type != "PARTSUPP") {
+                throw std::runtime_error("Delta join requires a PART and a PARTSUPP table");
+            }
+            if (sink != SinkMode::FILE) {
+                throw std::runtime_error("Delta join appends to its result file and supports only --sink file");
+            }
+
+            std::cout << "=== Delta Join ===" << std::endl;
+            std::cout << "PART Table: " << part_table << std::endl;
+            std::cout << "PARTSUPP Table: " << partsupp_table << std::endl;
+            std::cout << "Output File: " << output_file << std::endl;
+            std::cout << "Watermark: " << JoinWatermark::sidecarPath(output_file) << std::endl;
+            if (MemoryGovernor::instance().getLimit() > 0) {
+                std::cout << "Memory Limit: " << MemoryGovernor::instance().getLimit() / 1024
+                          << " KB" << std::endl;
+            }
+            std::cout << std::endl;
+
+            DeltaJoin join(part_table, partsupp_table, output_file, block_size);
+            join.execute();
+            if (!stats_json.empty()) {
+                writeStatisticsJson(stats_json, "delta", join.getStatistics());
+            }
+
+            std::cout << "\nDelta join completed successfully!\n";
+        }
+        // 벤치마크 모드
+        else if (mode == "benchmark") {
+            if (!threads_list.empty()) {
+                // 병렬 조인이 없어 스레드 수를 바꿔도 측정값이 같음
+                std::cerr << "Error: --threads is not supported by --benchmark "
+                          << "(the multithreaded join still runs single-threaded)\n";
+                return 1;
+            }
+
+            BenchmarkConfig config;
+            config.scale_factor = scale_factor;
+            config.seed = seed;
+            config.output_file = output_file;
+            config.sink = sink;
+            if (scale_factor <= 0) {
+                applyFileHeader(outer_table, outer_type, block_size, block_size_given);
+                applyFileHeader(inner_table, inner_type, block_size, true);
+                config.outer_table = outer_table;
+                config.outer_type = outer_type;
+                config.inner_table = inner_table;
+                config.inner_type = inner_type;
+            }
+            if ((output_file.empty() && (sink == SinkMode::FILE || scale_factor > 0)) ||
+                (scale_factor <= 0 &&
+                (outer_table.empty() || inner_table.empty() ||
+                 outer_type.empty() || inner_type.empty()))) {
+                std::cerr << "Error: Missing required arguments for benchmark\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+
+            config.algorithms = splitList(algorithm.empty() ? "bnlj,hash" : algorithm);
+            config.buffer_sizes = buffer_size_list.empty() ? std::vector<size_t>(1, buffer_size)
+                                                           : parseSizeList(buffer_size_list);
+            config.block_sizes = block_size_list.empty() ? std::vector<size_t>(1, block_size)
+                                                         : parseSizeList(block_size_list);
+            config.warmups = warmups;
+            config.repetitions = repetitions;
+            config.drop_caches = drop_caches;
+
+            std::cout << "=== Join Benchmark ===" << std::endl;
+            if (scale_factor > 0) {
+                std::cout << "Input: generated PART x PARTSUPP, SF " << scale_factor
+                          << ", seed " << seed << std::endl;
+            } else {
+                std::cout << "Input: " << outer_table << " (" << outer_type << ") x "
+                          << inner_table << " (" << inner_type << ")" << std::endl;
+            }
+            if (sink == SinkMode::FILE) {
+                std::cout << "Output File: " << output_file << std::endl;
+            } else {
+                std::cout << "Result Sink: " << sinkModeName(sink) << std::endl;
+            }
+            std::cout << "Runs: " << warmups << " warmup + " << repetitions
+                      << " measured per configuration\n" << std::endl;
+
+            BenchmarkRunner runner(config);
+            runner.run(std::cout);
+            runner.print(std::cout);
+            if (!bench_csv.empty()) {
+                runner.writeCsv(bench_csv);
+            }
+            if (!bench_json.empty()) {
+                runner.writeJson(bench_json);
+            }
+        }
         else {
-            std::cerr << "Error: Please specify either --convert-csv or --join\n";
+            std::cerr << "Error: Please specify --convert-csv, --generate, --convert-layout, --info, --analyze, --scan, --join, --delta-join or --benchmark\n";
             printUsage(argv[0]);
             return 1;
         }
@@ -0,0 +1,176 @@
+#include "memory_governor.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+
+// ============================================================================
+// MemoryGovernor 구현
+// ============================================================================
+MemoryGovernor& MemoryGovernor::instance() {
+    static MemoryGovernor governor;
+    return governor;
+}
+
+void MemoryGovernor::setLimit(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    limit = bytes;
+}
+
+size_t MemoryGovernor::getLimit() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return limit;
+}
+
+size_t MemoryGovernor::getReserved() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return reserved;
+}
+
+size_t MemoryGovernor::getPeakReserved() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return peak_reserved;
+}
+
+size_t MemoryGovernor::getAvailable() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (limit == 0) {
+        return SIZE_MAX;
+    }
+    return reserved < limit ? limit - reserved : 0;
+}
+
+bool MemoryGovernor::tryReserve(size_t bytes) {
+    return reserveUpTo(bytes, bytes) == bytes;
+}
+
+size_t MemoryGovernor::reserveUpTo(size_t desired, size_t minimum) {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t amount = desired;
+    if (limit > 0) {
+        size_t available = reserved < limit ? limit - reserved : 0;
+        amount = std::min(desired, available);
+        if (amount < minimum) {
+            return 0;
+        }
+    }
+    reserved += amount;
+    peak_reserved = std::max(peak_reserved, reserved);
+    return amount;
+}
+
+void MemoryGovernor::release(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    reserved -= std::min(bytes, reserved);
+}
+
+// ============================================================================
+// MemoryGrant 구현
+// ============================================================================
+size_t MemoryGrant::acquire(size_t desired, size_t minimum) {
+    if (cap > 0) {
+        size_t room = granted < cap ? cap - granted : 0;
+        desired = std::min(desired, room);
+    }
+    size_t amount = desired >= minimum ? MemoryGovernor::instance().reserveUpTo(desired, minimum) : 0;
+    if (amount == 0 && minimum > 0) {
+        size_t available = MemoryGovernor::instance().getAvailable();
+        if (cap > 0) {
+            available = std::min(available, granted < cap ? cap - granted : 0);
+        }
+        throw std::runtime_error(owner + ": memory limit too small (needs at least " +
+                                 std::to_string(minimum) + " bytes, " +
+                                 std::to_string(available) + " available)");
+    }
+    granted += amount;
+    used += amount;
+    peak_used = std::max(peak_used, used);
+    return amount;
+}
+
+bool MemoryGrant::use(size_t bytes) {
+    if (used + bytes > granted) {
+        size_t shortfall = used + bytes - granted;
+        size_t step = std::max<size_t>(shortfall, MEMORY_GRANT_STEP);
+        if (cap > 0) {
+            if (used + bytes > cap) {
+                return false;
+            }
+            step = std::min(step, cap - granted);
+        }
+        // 한 단계를 못 받으면 모자란 만큼만 다시 시도
+        MemoryGovernor& governor = MemoryGovernor::instance();
+        if (!governor.tryReserve(step)) {
+            if (step == shortfall || !governor.tryReserve(shortfall)) {
+                return false;
+            }
+            step = shortfall;
+        }
+        granted += step;
+    }
+    used += bytes;
+    peak_used = std::max(peak_used, used);
+    return true;
+}
+
+void MemoryGrant::unuse(size_t bytes) {
+    used -= std::min(bytes, used);
+}
+
+void MemoryGrant::trim() {
+    if (used < granted) {
+        MemoryGovernor::instance().release(granted - used);
+        granted = used;
+    }
+}
+
+void MemoryGrant::releaseAll() {
+    MemoryGovernor::instance().release(granted);
+    granted = 0;
+    used = 0;
+}
+
+size_t stringHeapBytes(const std::string& value) {
+    const char* self = reinterpret_cast<const char*>(&value);
+    if (value.data() >= self && value.data() < self + sizeof(std::string)) {
+        return 0;
+    }
+    return value.capacity() + 1;
+}
+
+size_t parseMemorySize(const std::string& text) {
+    // stoull은 앞의 공백과 '-'를 받아 음수를 큰 값으로 바꾸므로 숫자로 시작해야 함
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        throw std::runtime_error("Invalid memory size: " + text);
+    }
+
+    size_t pos = 0;
+    unsigned long long value = 0;
+    try {
+        value = std::stoull(text, &pos);
+    } catch (const std::exception&) {
+        throw std::runtime_error("Invalid memory size: " + text);
+    }
+
+    std::string suffix = text.substr(pos);
+    if (!suffix.empty() && (suffix.back() == 'B' || suffix.back() == 'b')) {
+        suffix.pop_back();
+    }
+    if (suffix.size() > 1) {
+        throw std::runtime_error("Invalid memory size: " + text);
+    }
+
+    unsigned long long scale = 1;
+    if (!suffix.empty()) {
+        switch (std::toupper(static_cast<unsigned char>(suffix[0]))) {
+            case 'K': scale = 1024ULL; break;
+            case 'M': scale = 1024ULL * 1024; break;
+            case 'G': scale = 1024ULL * 1024 * 1024; break;
+            default: throw std::runtime_error("Invalid memory size: " + text);
+        }
+    }
+    if (value > std::numeric_limits<size_t>::max() / scale) {
+        throw std::runtime_error("Memory size too large: " + text);
+    }
+    return static_cast<size_t>(value * scale);
+}
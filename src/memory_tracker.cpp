@@ -0,0 +1,321 @@
+#include "memory_tracker.h"
+#include "perf_counters.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <new>
+
+// ============================================================================
+// 계정 (정적 저장소라 operator new가 정적 초기화 중에 불려도 0으로 시작)
+// ============================================================================
+namespace {
+
+struct Account {
+    std::atomic<int64_t> live;
+    std::atomic<int64_t> peak;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> allocated;    // 할당한 바이트 누적 (해제해도 줄지 않음)
+};
+
+const int PHASE_COUNT = static_cast<int>(MemoryPhase::COUNT);
+const uint32_t UNTRACKED = 0xFFFFFFFFu;
+const uint32_t HEADER_MAGIC = 0x4D454D54u;   // 'T','M','E','M'
+
+// 계정 번호의 아래 16비트는 (연산자 × 단계 수 + 단계), 위 16비트는 연산자 계정의 세대
+const uint32_t ACCOUNT_SLOT_MASK = 0xFFFFu;
+const int ACCOUNT_GENERATION_SHIFT = 16;
+static_assert(MEMORY_TRACKER_MAX_OPERATORS * static_cast<int>(MemoryPhase::COUNT) <= 0xFFFF,
+              "account slot does not fit in 16 bits");
+
+// 할당 앞에 붙는 헤더 (사용자 영역 정렬을 유지하도록 16바이트)
+struct AllocationHeader {
+    uint64_t size;
+    uint32_t account;
+    uint32_t magic;
+};
+const size_t HEADER_SIZE = 16;
+static_assert(sizeof(AllocationHeader) <= HEADER_SIZE, "allocation header too large");
+static_assert(HEADER_SIZE % alignof(std::max_align_t) == 0, "allocation header breaks alignment");
+
+Account g_phase_accounts[MEMORY_TRACKER_MAX_OPERATORS * PHASE_COUNT];
+Account g_operator_accounts[MEMORY_TRACKER_MAX_OPERATORS];
+Account g_process_account;
+std::atomic<uint32_t> g_generations[MEMORY_TRACKER_MAX_OPERATORS];   // 계정을 다시 쓸 때마다 증가
+
+std::mutex g_names_mutex;
+char g_names[MEMORY_TRACKER_MAX_OPERATORS][48];
+int g_next_operator = 0;
+
+// 이 스레드의 현재 연산자 (-1이면 없음)와 단계
+thread_local int t_operator = -1;
+thread_local int t_phase = 0;
+
+MemoryUsage snapshot(const Account& account) {
+    MemoryUsage usage;
+    usage.live = account.live.load(std::memory_order_relaxed);
+    usage.peak = account.peak.load(std::memory_order_relaxed);
+    usage.allocations = account.allocations.load(std::memory_order_relaxed);
+    usage.allocated = account.allocated.load(std::memory_order_relaxed);
+    return usage;
+}
+
+void resetAccount(Account& account) {
+    account.live.store(0, std::memory_order_relaxed);
+    account.peak.store(0, std::memory_order_relaxed);
+    account.allocations.store(0, std::memory_order_relaxed);
+    account.allocated.store(0, std::memory_order_relaxed);
+}
+
+#if DBSYS_TRACK_ALLOC
+void addUsage(Account& account, int64_t delta) {
+    int64_t now = account.live.fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (delta <= 0) {
+        return;
+    }
+    account.allocations.fetch_add(1, std::memory_order_relaxed);
+    account.allocated.fetch_add(static_cast<uint64_t>(delta), std::memory_order_relaxed);
+    int64_t peak = account.peak.load(std::memory_order_relaxed);
+    while (now > peak &&
+           !account.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+// 계정을 다시 쓴 뒤에 해제된 이전 연산자의 할당은 프로세스 합계에서만 뺌
+void recordUsage(uint32_t account, int64_t delta) {
+    addUsage(g_process_account, delta);
+    if (account == UNTRACKED) {
+        return;
+    }
+    uint32_t slot = account & ACCOUNT_SLOT_MASK;
+    int op = static_cast<int>(slot) / PHASE_COUNT;
+    uint32_t generation = account >> ACCOUNT_GENERATION_SHIFT;
+    if (generation != (g_generations[op].load(std::memory_order_relaxed) & ACCOUNT_SLOT_MASK)) {
+        return;
+    }
+    addUsage(g_phase_accounts[slot], delta);
+    addUsage(g_operator_accounts[op], delta);
+}
+
+void* trackedAllocate(size_t size) {
+    void* raw = std::malloc(size + HEADER_SIZE);
+    if (!raw) {
+        return nullptr;
+    }
+    AllocationHeader* header = static_cast<AllocationHeader*>(raw);
+    header->size = size;
+    if (t_operator < 0) {
+        header->account = UNTRACKED;
+    } else {
+        uint32_t generation = g_generations[t_operator].load(std::memory_order_relaxed);
+        header->account = (generation << ACCOUNT_GENERATION_SHIFT) |
+                          static_cast<uint32_t>(t_operator * PHASE_COUNT + t_phase);
+    }
+    header->magic = HEADER_MAGIC;
+    recordUsage(header->account, static_cast<int64_t>(size));
+    return static_cast<char*>(raw) + HEADER_SIZE;
+}
+
+void* allocateOrThrow(size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        void* ptr = trackedAllocate(size);
+        if (ptr) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void trackedFree(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    AllocationHeader* header =
+        reinterpret_cast<AllocationHeader*>(static_cast<char*>(ptr) - HEADER_SIZE);
+    recordUsage(header->account, -static_cast<int64_t>(header->size));
+    std::free(header);
+}
+
+double toKB(int64_t bytes) {
+    return bytes / 1024.0;
+}
+#endif // DBSYS_TRACK_ALLOC
+
+} // namespace
+
+// ============================================================================
+// 전역 operator new/delete 교체
+// ============================================================================
+#if DBSYS_TRACK_ALLOC
+void* operator new(size_t size) { return allocateOrThrow(size); }
+void* operator new[](size_t size) { return allocateOrThrow(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocateOrThrow(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocateOrThrow(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+#endif // DBSYS_TRACK_ALLOC
+
+// ============================================================================
+// MemoryTracker 구현
+// ============================================================================
+const char* memoryPhaseName(MemoryPhase phase) {
+    switch (phase) {
+        case MemoryPhase::SETUP: return "setup";
+        case MemoryPhase::BUILD: return "build";
+        case MemoryPhase::PROBE: return "probe";
+        case MemoryPhase::OUTPUT: return "output";
+        case MemoryPhase::PARTITION: return "partition";
+        default: return "unknown";
+    }
+}
+
+int MemoryTracker::beginOperator(const std::string& name) {
+    std::lock_guard<std::mutex> lock(g_names_mutex);
+    // 계정이 모자라면 가장 오래된 것부터 다시 씀 (세대를 올려 이전 할당의 해제를 무시)
+    int op = g_next_operator++ % MEMORY_TRACKER_MAX_OPERATORS;
+    std::strncpy(g_names[op], name.c_str(), sizeof(g_names[op]) - 1);
+    g_names[op][sizeof(g_names[op]) - 1] = '\0';
+
+    g_generations[op].fetch_add(1, std::memory_order_relaxed);
+    resetAccount(g_operator_accounts[op]);
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        resetAccount(g_phase_accounts[op * PHASE_COUNT + phase]);
+    }
+    return op;
+}
+
+std::string MemoryTracker::operatorName(int op) {
+    std::lock_guard<std::mutex> lock(g_names_mutex);
+    return g_names[op];
+}
+
+MemoryUsage MemoryTracker::phaseUsage(int op, MemoryPhase phase) {
+    return snapshot(g_phase_accounts[op * PHASE_COUNT + static_cast<int>(phase)]);
+}
+
+MemoryUsage MemoryTracker::operatorUsage(int op) {
+    return snapshot(g_operator_accounts[op]);
+}
+
+MemoryUsage MemoryTracker::processUsage() {
+    return snapshot(g_process_account);
+}
+
+bool MemoryTracker::readResidentSet(size_t& rss, size_t& peak_rss) {
+    std::ifstream status("/proc/self/status");
+    if (!status) {
+        return false;
+    }
+
+    bool found_rss = false, found_peak = false;
+    std::string line;
+    while (std::getline(status, line)) {
+        // "VmRSS:      1234 kB"
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            rss = std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+            found_rss = true;
+        } else if (line.compare(0, 6, "VmHWM:") == 0) {
+            peak_rss = std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+            found_peak = true;
+        }
+    }
+    return found_rss && found_peak;
+}
+
+// ============================================================================
+// 범위 객체
+// ============================================================================
+OperatorMemoryScope::OperatorMemoryScope(const std::string& name)
+    : op(MemoryTracker::beginOperator(name)), saved_op(t_operator), saved_phase(t_phase) {
+    t_operator = op;
+    t_phase = static_cast<int>(MemoryPhase::SETUP);
+}
+
+OperatorMemoryScope::~OperatorMemoryScope() {
+    t_operator = saved_op;
+    t_phase = saved_phase;
+}
+
+MemoryPhaseScope::MemoryPhaseScope(MemoryPhase phase) : saved_phase(t_phase) {
+    t_phase = static_cast<int>(phase);
+    if (OperatorPerfScope* perf = OperatorPerfScope::current()) {
+        perf->switchPhase(phase);
+    }
+}
+
+MemoryPhaseScope::~MemoryPhaseScope() {
+    t_phase = saved_phase;
+    if (OperatorPerfScope* perf = OperatorPerfScope::current()) {
+        perf->switchPhase(static_cast<MemoryPhase>(saved_phase));
+    }
+}
+
+// ============================================================================
+// 출력
+// ============================================================================
+void printTrackedMemory(std::ostream& out, int op) {
+#if DBSYS_TRACK_ALLOC
+    out << "Tracked Memory (peak / live KB):" << std::fixed << std::setprecision(1) << std::endl;
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        MemoryUsage usage = MemoryTracker::phaseUsage(op, static_cast<MemoryPhase>(phase));
+        if (usage.allocations == 0 && usage.live == 0) {
+            continue;
+        }
+        out << "  " << std::left << std::setw(10) << memoryPhaseName(static_cast<MemoryPhase>(phase))
+            << std::right << std::setw(10) << toKB(usage.peak) << " / "
+            << std::setw(8) << toKB(usage.live) << "  (" << usage.allocations
+            << " allocations)" << std::endl;
+    }
+    MemoryUsage total = MemoryTracker::operatorUsage(op);
+    out << "  " << std::left << std::setw(10) << "total"
+        << std::right << std::setw(10) << toKB(total.peak) << " / "
+        << std::setw(8) << toKB(total.live) << "  (" << total.allocations
+        << " allocations)" << std::endl;
+
+    // 추적한 전체 힙과 RSS (RSS에는 코드, 스택, 추적하지 않는 할당이 더 들어감)
+    MemoryUsage process = MemoryTracker::processUsage();
+    out << "Process Heap (tracked): " << toKB(process.live) << " KB live, "
+        << toKB(process.peak) << " KB peak" << std::endl;
+#else
+    (void)op;
+    out << "Tracked Memory: disabled (built with DBSYS_TRACK_ALLOC=0)" << std::fixed
+        << std::setprecision(1) << std::endl;
+#endif
+    size_t rss = 0, peak_rss = 0;
+    if (MemoryTracker::readResidentSet(rss, peak_rss)) {
+        out << "Process RSS: " << rss / 1024.0 / 1024.0 << " MB ("
+            << peak_rss / 1024.0 / 1024.0 << " MB peak)" << std::endl;
+    }
+    out.unsetf(std::ios::fixed);
+    out << std::setprecision(6);
+}
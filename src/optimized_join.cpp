@@ -1,7 +1,15 @@
 #include "optimized_join.h"
+#include "table_stats.h"
+#include "memory_tracker.h"
+#include "phase_timer.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include "pax.h"
 #include <iostream>
 #include <chrono>
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
 
 // ============================================================================
 // 1. 해시 조인 구현
@@ -19,121 +27,521 @@ HashJoin::HashJoin(
       output_file(out_file),
       build_table_type(build_type),
       probe_table_type(probe_type),
-      block_size(blk_size) {
+      block_size(blk_size),
+      sink_mode(SinkMode::FILE),
+      memory_budget(0),
+      table_bytes(0),
+      spill_partitions(0),
+      build_passes(0) {
 }
 
-void HashJoin::buildHashTable() {
-    std::cout << "Building hash table from " << build_table_file << "..." << std::endl;
-
-    TableReader reader(build_table_file, block_size, &stats);
-    Block block(block_size);
+// 파티션 번호 (연속 키가 고르게 퍼지도록 섞은 뒤 나머지)
+static size_t partitionOf(int_t key, size_t partitions) {
+    uint64_t x = static_cast<uint64_t>(static_cast<uint32_t>(key));
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return static_cast<size_t>(x % partitions);
+}
 
-    size_t records_loaded = 0;
+// 필드 바이트를 그대로 블록에 레코드 하나로 인코딩 (공간이 없으면 false, 블록은 그대로)
+static bool appendFields(Block& block, const std::vector<FieldRef>& fields) {
+    RecordBuilder builder(&block);
+    builder.begin(fields.size());
+    for (const auto& field : fields) {
+        builder.addString(field.data, field.size);
+    }
+    return builder.commit();
+}
 
-    // Build 테이블의 모든 레코드를 읽어 해시 테이블 구축
-    while (reader.readBlock(&block)) {
-        RecordReader rec_reader(&block);
+// 임시 파티션 파일과 존 맵 사이드카 삭제
+static void removeSpillFile(const std::string& path) {
+    std::remove(path.c_str());
+    std::remove(ZoneMap::sidecarPath(path).c_str());
+}
 
-        while (rec_reader.hasNext()) {
-            Record record = rec_reader.readNext();
+template <typename T>
+bool HashJoin::insertBuild(std::unordered_map<int_t, std::vector<T>>& table, T&& value) {
+    size_t bucket_before = table.bucket_count();
+    size_t bytes = hashInsertBytes(table, value.partkey) + value.heapBytes();
+    if (!grant->use(bytes)) {
+        return false;
+    }
+    table_bytes += bytes;
+
+    int_t key = value.partkey;
+    table[key].push_back(std::move(value));
+
+    // 재해싱했으면 추정한 새 버킷 배열 대신 실제 크기로 맞춤 (기존 배열은 해제됨)
+    if (table.bucket_count() != bucket_before) {
+        size_t estimated = std::max<size_t>(bucket_before * 2, 16) * sizeof(void*);
+        size_t actual = table.bucket_count() * sizeof(void*);
+        size_t released = estimated + (bucket_before > 1 ? bucket_before * sizeof(void*) : 0);
+        if (actual > released) {
+            grant->use(actual - released);
+            table_bytes += actual - released;
+        } else {
+            grant->unuse(released - actual);
+            table_bytes -= released - actual;
+        }
+    }
+    return true;
+}
 
-            if (build_table_type == "PART") {
-                PartRecord part = PartRecord::fromRecord(record);
-                hash_table[part.partkey].push_back(part);
-                records_loaded++;
-            }
+bool HashJoin::insertBuildRecord(const Record& record) {
+    if (build_table_type == "PART") {
+        PartRecord part;
+        {
+            PHASE_TIMER(&stats, TimerPhase::DECODE);
+            part = PartRecord::fromRecord(record, part_dict.get());
         }
+        return insertBuild(hash_table, std::move(part));
+    }
+    PartSuppRecord partsupp;
+    {
+        PHASE_TIMER(&stats, TimerPhase::DECODE);
+        partsupp = PartSuppRecord::fromRecord(record);
+    }
+    return insertBuild(partsupp_table, std::move(partsupp));
+}
+
+void HashJoin::presizeFromStatistics() {
+    MemoryPhaseScope build_phase(MemoryPhase::BUILD);
+
+    // 통계가 있으면 고유 키 수만큼 버킷을 미리 확보
+    std::unique_ptr<TableStats> build_stats = TableStats::loadIfExists(build_table_file);
+    if (!build_stats || build_stats->columns.empty()) {
+        return;
+    }
 
-        block.clear();
+    size_t keys = static_cast<size_t>(build_stats->columns[0].distinct);
+    size_t bytes = keys * sizeof(void*);
+    if (!grant->use(bytes)) {
+        std::cout << "Skipped presizing hash table for " << keys
+                  << " keys (exceeds memory grant)" << std::endl;
+        return;
+    }
+    if (build_table_type == "PART") {
+        hash_table.reserve(keys);
+    } else {
+        partsupp_table.reserve(keys);
     }
 
-    std::cout << "Hash table built: " << records_loaded << " records, "
-              << hash_table.size() << " unique keys" << std::endl;
+    // 실제 버킷 수는 keys보다 큰 소수
+    size_t actual = (hash_table.bucket_count() + partsupp_table.bucket_count()) * sizeof(void*);
+    if (actual > bytes) {
+        grant->use(actual - bytes);
+    } else {
+        grant->unuse(bytes - actual);
+    }
+    table_bytes += actual;
+    std::cout << "Presized hash table for " << keys << " keys (from statistics)" << std::endl;
 }
 
-void HashJoin::probeAndJoin(TableWriter& writer) {
-    std::cout << "Probing " << probe_table_file << "..." << std::endl;
+void HashJoin::clearTable() {
+    // clear()는 버킷 배열을 남기므로 빈 테이블과 교환해 메모리까지 반납
+    std::unordered_map<int_t, std::vector<PartRecord>>().swap(hash_table);
+    std::unordered_map<int_t, std::vector<PartSuppRecord>>().swap(partsupp_table);
+    grant->unuse(table_bytes);
+    grant->trim();
+    table_bytes = 0;
+}
 
-    TableReader reader(probe_table_file, block_size, &stats);
-    Block input_block(block_size);
-    Block output_block(block_size);
-    RecordWriter output_writer(&output_block);
+bool HashJoin::getBuildKeyRange(int_t& lo, int_t& hi) const {
+    bool found = false;
+    auto observe = [&](int_t key) {
+        if (!found || key < lo) lo = key;
+        if (!found || key > hi) hi = key;
+        found = true;
+    };
+    for (const auto& entry : hash_table) observe(entry.first);
+    for (const auto& entry : partsupp_table) observe(entry.first);
+    return found;
+}
 
-    size_t probed_records = 0;
+void HashJoin::emitResult(const PartRecord& part, const PartSuppRecord& partsupp,
+                          ResultSink& sink, Block& output_block, RecordBuilder& output_builder) {
+    if (!sink.encodesRows()) {
+        stats.output_records++;
+        return;
+    }
+    bool encoded;
+    {
+        PHASE_TIMER(&stats, TimerPhase::ENCODE);
+        encoded = JoinResultRecord::encode(output_builder, part, partsupp);
+    }
+    if (!encoded) {
+        MemoryPhaseScope output_phase(MemoryPhase::OUTPUT);
+        TRACE_SPAN("flush", "join");
+        sink.writeBlock(&output_block);
+        output_block.clear();
+
+        PHASE_TIMER(&stats, TimerPhase::ENCODE);
+        if (!JoinResultRecord::encode(output_builder, part, partsupp)) {
+            throw std::runtime_error("Result record too large");
+        }
+    }
+    stats.output_records++;
+}
 
-    // Probe 테이블을 스캔하며 해시 테이블에서 매칭
-    while (reader.readBlock(&input_block)) {
-        RecordReader rec_reader(&input_block);
+void HashJoin::probeRecord(const Record& record, ResultSink& sink,
+                           Block& output_block, RecordBuilder& output_builder) {
+    if (probe_table_type == "PARTSUPP") {
+        PartSuppRecord partsupp;
+        {
+            PHASE_TIMER(&stats, TimerPhase::DECODE);
+            partsupp = PartSuppRecord::fromRecord(record);
+        }
+
+        // 해시 테이블에서 매칭되는 PART 레코드 찾기
+        auto it = hash_table.find(partsupp.partkey);
+
+        if (it != hash_table.end()) {
+            // 매칭되는 모든 PART 레코드와 조인
+            for (const auto& part : it->second) {
+                emitResult(part, partsupp, sink, output_block, output_builder);
+            }
+        }
+    } else if (probe_table_type == "PART") {
+        PartRecord part;
+        {
+            PHASE_TIMER(&stats, TimerPhase::DECODE);
+            part = PartRecord::fromRecord(record, part_dict.get());
+        }
 
-        while (rec_reader.hasNext()) {
-            Record record = rec_reader.readNext();
-            probed_records++;
+        // 해시 테이블에서 매칭되는 PARTSUPP 레코드 찾기
+        auto it = partsupp_table.find(part.partkey);
 
-            if (probe_table_type == "PARTSUPP") {
-                PartSuppRecord partsupp = PartSuppRecord::fromRecord(record);
+        if (it != partsupp_table.end()) {
+            for (const auto& partsupp : it->second) {
+                emitResult(part, partsupp, sink, output_block, output_builder);
+            }
+        }
+    }
+}
 
-                // 해시 테이블에서 매칭되는 PART 레코드 찾기
-                auto it = hash_table.find(partsupp.partkey);
+bool HashJoin::joinFiles(const std::string& build_file, const std::string& probe_file,
+                         bool allow_spill, ResultSink& sink,
+                         Block& output_block, RecordBuilder& output_builder,
+                         size_t& loaded_blocks) {
+    // 두 리더는 해시 테이블이 예약을 채우기 전에 예약 (probe 리더는 채우기마다 처음부터 다시 읽음)
+    TableReader build_reader(build_file, block_size, &stats);
+    TableReader probe_reader(probe_file, block_size, &stats);
+    ScopedMemoryUse reader_memory(*grant, build_reader.memoryBytes() + probe_reader.memoryBytes());
+    Block build_block(block_size);
+    std::unique_ptr<RecordReader> cursor;
+
+    // 예약이 모자라 넣지 못한 레코드 (다음 채우기의 첫 레코드)
+    Record pending;
+    bool has_pending = false;
+    bool exhausted = false;
+
+    while (!exhausted) {
+        // ---------- Build: 예약이 허락하는 만큼 해시 테이블 채우기 ----------
+        if (allow_spill) {
+            std::cout << "Building hash table from " << build_file << "..." << std::endl;
+        }
+        size_t records_loaded = 0;
+        MemoryPhaseScope build_phase(MemoryPhase::BUILD);
+        TraceSpan build_span("hash build", "join");
+        {
+            // 해시 삽입 시간 = build 루프 시간 - 안에서 잰 read/decode 시간
+            PHASE_TIMER_REST(&stats, TimerPhase::COMPARE);
+            while (true) {
+                Record record;
+                if (has_pending) {
+                    record = std::move(pending);
+                    has_pending = false;
+                } else if (cursor && cursor->hasNext()) {
+                    PHASE_TIMER(&stats, TimerPhase::DECODE);
+                    record = cursor->readNext();
+                } else {
+                    cursor.reset();
+                    build_block.clear();
+                    if (!build_reader.readBlock(&build_block)) {
+                        exhausted = true;
+                        break;
+                    }
+                    cursor.reset(new RecordReader(&build_block));
+                    continue;
+                }
 
-                if (it != hash_table.end()) {
-                    // 매칭되는 모든 PART 레코드와 조인
-                    for (const auto& part : it->second) {
-                        JoinResultRecord result;
-                        result.part = part;
-                        result.partsupp = partsupp;
+                if (!insertBuildRecord(record)) {
+                    pending = std::move(record);
+                    has_pending = true;
+                    break;
+                }
+                records_loaded++;
+            }
+        }
+        build_span.setArg("records", records_loaded);
+        build_span.end();
 
-                        Record result_rec = result.toRecord();
+        if (!exhausted) {
+            if (records_loaded == 0) {
+                throw std::runtime_error("Hash join: memory limit too small for a single build record");
+            }
+            if (allow_spill) {
+                loaded_blocks = build_reader.getBlockIndex();
+                clearTable();
+                return false;
+            }
+        }
+        build_passes++;
 
-                        if (!output_writer.writeRecord(result_rec)) {
-                            writer.writeBlock(&output_block);
-                            output_block.clear();
+        if (allow_spill) {
+            std::cout << "Hash table built: " << records_loaded << " records, "
+                      << (hash_table.size() + partsupp_table.size()) << " unique keys ("
+                      << table_bytes / 1024 << " KB)" << std::endl;
+            std::cout << "Probing " << probe_file << "..." << std::endl;
+        }
 
-                            if (!output_writer.writeRecord(result_rec)) {
-                                throw std::runtime_error("Result record too large");
-                            }
-                        }
+        // ---------- Probe: 해시 테이블 키 범위 밖의 블록은 존 맵으로 건너뜀 ----------
+        MemoryPhaseScope probe_phase(MemoryPhase::PROBE);
+        Block input_block(block_size);
+        int_t lo = 0, hi = 0;
+        probe_reader.reset();
+        probe_reader.clearKeyRange();
+        if (getBuildKeyRange(lo, hi)) {
+            probe_reader.setKeyRange(lo, hi);
+        }
 
-                        stats.output_records++;
+        size_t probed_records = 0;
+        TraceSpan probe_span("probe batch", "join");
+        {
+            // 해시 조회 시간 = probe 루프 시간 - 안에서 잰 read/decode/encode/write 시간
+            PHASE_TIMER_REST(&stats, TimerPhase::COMPARE);
+            while (probe_reader.readBlock(&input_block)) {
+                RecordReader rec_reader(&input_block);
+                while (rec_reader.hasNext()) {
+                    Record record;
+                    {
+                        PHASE_TIMER(&stats, TimerPhase::DECODE);
+                        record = rec_reader.readNext();
                     }
+                    probeRecord(record, sink, output_block, output_builder);
+                    probed_records++;
                 }
+                input_block.clear();
             }
         }
 
+        probe_span.setArg("records", probed_records);
+        probe_span.end();
+
+        if (allow_spill) {
+            std::cout << "Probed " << probed_records << " records" << std::endl;
+        }
+        clearTable();
+    }
+    return true;
+}
+
+std::vector<std::string> HashJoin::partitionFile(const std::string& input_file,
+                                                 const std::string& table_type,
+                                                 const std::string& prefix, size_t partitions) {
+    MemoryPhaseScope partition_phase(MemoryPhase::PARTITION);
+    TraceSpan spill_span("spill", "join");
+    spill_span.setArg("partitions", partitions);
+    std::vector<std::string> paths;
+    std::vector<std::unique_ptr<TableWriter>> writers;
+    std::vector<std::unique_ptr<Block>> blocks;
+    for (size_t i = 0; i < partitions; ++i) {
+        paths.push_back(prefix + std::to_string(i));
+        writers.emplace_back(new TableWriter(paths.back(), &stats));
+        writers.back()->setTableType(table_type);
+        blocks.emplace_back(new Block(block_size));
+    }
+
+    // 필드는 원래 바이트 그대로 (딕셔너리 코드도 그대로) 파티션 블록에 바로 인코딩
+    TableReader reader(input_file, block_size, &stats);
+    Block input_block(block_size);
+    std::vector<FieldRef> fields;
+    std::vector<std::string> pax_text;  // PAX 숫자 컬럼의 텍스트 (컬럼마다 하나)
+    while (reader.readBlock(&input_block)) {
+        // PAX 페이지는 행을 복원하지 않고 컬럼 접근자로 읽음
+        std::unique_ptr<PaxPage> page;
+        if (PaxPage::isPaxPage(&input_block)) {
+            page.reset(new PaxPage(&input_block));
+            pax_text.resize(page->getColumnCount());
+        }
+        RecordReader rec_reader(&input_block);
+        size_t row = 0;
+
+        while (page ? row < page->getRecordCount() : rec_reader.hasNext()) {
+            int_t key;
+            {
+                PHASE_TIMER(&stats, TimerPhase::DECODE);
+                fields.clear();
+                if (page) {
+                    for (size_t col = 0; col < page->getColumnCount(); ++col) {
+                        fields.push_back(page->getFieldText(col, row, pax_text[col]));
+                    }
+                    row++;
+                } else {
+                    RecordView view = rec_reader.readNextView();
+                    for (size_t i = 0; i < view.getFieldCount(); ++i) {
+                        fields.push_back(view.getField(i));
+                    }
+                }
+                key = std::stoi(fields.at(0).toString());
+            }
+            size_t p = partitionOf(key, partitions);
+
+            if (!appendFields(*blocks[p], fields)) {
+                writers[p]->writeBlock(blocks[p].get());
+                blocks[p]->clear();
+                if (!appendFields(*blocks[p], fields)) {
+                    throw std::runtime_error("Record too large for partition block");
+                }
+            }
+        }
         input_block.clear();
     }
 
-    // 마지막 출력 블록 플러시
-    if (!output_block.isEmpty()) {
-        writer.writeBlock(&output_block);
+    for (size_t i = 0; i < partitions; ++i) {
+        if (!blocks[i]->isEmpty()) {
+            writers[i]->writeBlock(blocks[i].get());
+        }
+        writers[i]->close();
+    }
+    return paths;
+}
+
+void HashJoin::joinPartitioned(size_t loaded_blocks, ResultSink& sink,
+                               Block& output_block, RecordBuilder& output_builder) {
+    // 넘치기 전까지 읽은 비율로 파티션 수 추정 (여유 25%)
+    size_t total_blocks = countTableBlocks(build_table_file, block_size);
+    size_t wanted = static_cast<size_t>(
+        std::ceil(1.25 * total_blocks / std::max<size_t>(loaded_blocks, 1)));
+    size_t partitions = std::max<size_t>(wanted, 2);
+
+    // 나누는 동안 입력 리더 하나 (두 입력 중 큰 쪽) - 파티션 쓰기 버퍼보다 먼저 예약
+    size_t reader_bytes = std::max(TableReader(build_table_file, block_size).memoryBytes(),
+                                   TableReader(probe_table_file, block_size).memoryBytes());
+    std::unique_ptr<ScopedMemoryUse> reader_memory(new ScopedMemoryUse(*grant, reader_bytes));
+
+    // 파티션마다 출력 블록 하나와 파일 쓰기 버퍼 (예약이 모자라면 파티션 수를 줄임)
+    size_t partition_bytes = block_size + HASH_PARTITION_WRITER_BYTES;
+    while (partitions > 2 && !grant->use(partitions * partition_bytes)) {
+        partitions = std::max<size_t>(2, partitions * 3 / 4);
     }
+    if (partitions == 2 && !grant->use(partitions * partition_bytes)) {
+        std::cout << "Memory grant too small to partition; joining in multiple build passes"
+                  << std::endl;
+        reader_memory.reset();
+        joinFiles(build_table_file, probe_table_file, false, sink,
+                  output_block, output_builder, loaded_blocks);
+        return;
+    }
+
+    std::cout << "Hash table exceeds memory grant after " << loaded_blocks << " of "
+              << total_blocks << " build blocks; spilling to " << partitions
+              << " partitions" << std::endl;
+    spill_partitions = partitions;
 
-    std::cout << "Probed " << probed_records << " records" << std::endl;
+    std::vector<std::string> build_parts, probe_parts;
+    try {
+        build_parts = partitionFile(build_table_file, build_table_type,
+                                    output_file + ".spill.build.", partitions);
+        probe_parts = partitionFile(probe_table_file, probe_table_type,
+                                    output_file + ".spill.probe.", partitions);
+        grant->unuse(partitions * partition_bytes);
+        reader_memory.reset();
+        grant->trim();
+
+        // 파티션 쌍마다 조인 (여전히 넘치면 여러 번 나눠 채움)
+        for (size_t i = 0; i < partitions; ++i) {
+            size_t passes_before = build_passes;
+            joinFiles(build_parts[i], probe_parts[i], false, sink,
+                      output_block, output_builder, loaded_blocks);
+            if (build_passes - passes_before > 1) {
+                std::cout << "Partition " << i << " joined in "
+                          << (build_passes - passes_before) << " build passes" << std::endl;
+            }
+            removeSpillFile(build_parts[i]);
+            removeSpillFile(probe_parts[i]);
+        }
+    } catch (...) {
+        for (const auto& path : build_parts) removeSpillFile(path);
+        for (const auto& path : probe_parts) removeSpillFile(path);
+        throw;
+    }
 }
 
 void HashJoin::execute() {
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    // Build Phase
-    buildHashTable();
+    if (build_table_type != "PART" && build_table_type != "PARTSUPP") {
+        throw std::runtime_error("Unsupported build table type: " + build_table_type);
+    }
+
+    // 이 스레드의 할당을 해시 조인 계정에 단계별로 기록
+    OperatorMemoryScope memory_scope("Hash join");
+    OperatorPerfScope perf_scope;
+
+    part_dict = PartDictionary::loadIfExists(build_table_type == "PART" ? build_table_file
+                                                                         : probe_table_file);
+
+    MemoryPhaseScope output_phase(MemoryPhase::OUTPUT);
+    ResultSink sink(sink_mode, output_file, &stats);
+
+    // build 입력, probe 입력, 출력 블록, 딕셔너리, 레코드 디코딩 작업 공간, 출력 라이터 예약
+    // (입력 리더는 열 때마다 따로 더함)
+    size_t fixed_bytes = 3 * block_size +
+                         (part_dict ? part_dict->memoryBytes() : 0) + RECORD_DECODE_SCRATCH_BYTES;
+    grant.reset(new MemoryGrant("Hash join", memory_budget));
+    grant->acquire(fixed_bytes, fixed_bytes);
+    sink.setMemoryGrant(grant.get());
+    table_bytes = 0;
+    spill_partitions = 0;
+    build_passes = 0;
+
+    Block output_block(block_size);
+    RecordBuilder output_builder(&output_block);
+    MemoryPhaseScope setup_phase(MemoryPhase::SETUP);
+
+    // Build/Probe (예약을 넘으면 파티션으로 나눠 조인)
+    presizeFromStatistics();
+    size_t loaded_blocks = 0;
+    if (!joinFiles(build_table_file, probe_table_file, true, sink,
+                   output_block, output_builder, loaded_blocks)) {
+        joinPartitioned(loaded_blocks, sink, output_block, output_builder);
+    }
 
-    // Probe Phase
-    TableWriter writer(output_file, &stats);
-    probeAndJoin(writer);
+    // 마지막 출력 블록 플러시
+    if (!output_block.isEmpty()) {
+        TRACE_SPAN("flush", "join");
+        sink.writeBlock(&output_block);
+    }
+    sink.close();
+    perf_scope.finish(stats);
 
     auto end_time = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = end_time - start_time;
     stats.elapsed_time = elapsed.count();
 
-    // 메모리 사용량 (해시 테이블 + 블록)
-    stats.memory_usage = hash_table.size() * sizeof(std::pair<int_t, std::vector<PartRecord>>)
-                        + 2 * block_size;
+    // 메모리 사용량 (예약 안에서 쓴 최대 크기: 해시 테이블 + 블록)
+    stats.memory_usage = grant->getPeakUsed();
+    stats.tracked_memory_peak = static_cast<size_t>(MemoryTracker::operatorUsage(memory_scope.id()).peak);
+    grant.reset();
 
     std::cout << "\n=== Hash Join Statistics ===" << std::endl;
     std::cout << "Block Reads: " << stats.block_reads << std::endl;
     std::cout << "Block Writes: " << stats.block_writes << std::endl;
+    std::cout << "Physical Reads: " << stats.physical_block_reads << std::endl;
+    std::cout << "Physical Writes: " << stats.physical_block_writes << std::endl;
+    std::cout << "Blocks Skipped: " << stats.blocks_skipped << std::endl;
+    if (spill_partitions > 0 || build_passes > 1) {
+        std::cout << "Spill Partitions: " << spill_partitions << std::endl;
+        std::cout << "Build Passes: " << build_passes << std::endl;
+    }
     std::cout << "Output Records: " << stats.output_records << std::endl;
     std::cout << "Elapsed Time: " << stats.elapsed_time << " seconds" << std::endl;
     std::cout << "Memory Usage: " << (stats.memory_usage / 1024.0 / 1024.0) << " MB" << std::endl;
+    printPhaseBreakdown(std::cout, stats);
+    printPerfCounters(std::cout, perf_scope, stats.output_records);
+    printTrackedMemory(std::cout, memory_scope.id());
 }
 
 // ============================================================================
@@ -157,6 +565,7 @@ MultithreadedJoin::MultithreadedJoin(
       buffer_size(buf_size),
       block_size(blk_size),
       num_threads(threads),
+      sink_mode(SinkMode::FILE),
       done_reading(false) {
 }
 
@@ -168,6 +577,7 @@ void MultithreadedJoin::execute() {
     BlockNestedLoopsJoin join(outer_table_file, inner_table_file, output_file,
                              outer_table_type, inner_table_type,
                              buffer_size, block_size);
+    join.setSink(sink_mode);
     join.execute();
     stats = join.getStatistics();
 }
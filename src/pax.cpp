@@ -0,0 +1,426 @@
+#include "pax.h"
+#include "dictionary.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+// 헤더: magic(4) + record_count(2) + column_count(2)
+static const size_t PAX_HEADER_SIZE = sizeof(uint32_t) + 2 * sizeof(uint16_t);
+// 컬럼 디스크립터: minipage_offset(4) + type(4)
+static const size_t PAX_DESCRIPTOR_SIZE = 2 * sizeof(uint32_t);
+
+static size_t alignTo4(size_t value) {
+    return (value + 3) & ~static_cast<size_t>(3);
+}
+
+BlockLayout parseBlockLayout(const std::string& name) {
+    if (name == "row") return BlockLayout::ROW;
+    if (name == "pax") return BlockLayout::PAX;
+    throw std::runtime_error("Unknown block layout: " + name);
+}
+
+// ============================================================================
+// PaxPage 구현
+// ============================================================================
+
+PaxPage::PaxPage(const Block* block) : data(block->getData()) {
+    if (!isPaxPage(block)) {
+        throw std::runtime_error("Block is not a PAX page");
+    }
+    std::memcpy(&record_count, data + sizeof(uint32_t), sizeof(uint16_t));
+    std::memcpy(&column_count, data + sizeof(uint32_t) + sizeof(uint16_t), sizeof(uint16_t));
+}
+
+bool PaxPage::isPaxPage(const Block* block) {
+    if (block->getSize() < PAX_HEADER_SIZE) {
+        return false;
+    }
+    uint32_t magic;
+    std::memcpy(&magic, block->getData(), sizeof(uint32_t));
+    return magic == PAX_PAGE_MAGIC;
+}
+
+uint32_t PaxPage::getMinipageOffset(size_t col) const {
+    if (col >= column_count) {
+        throw std::out_of_range("PAX column index out of range: " + std::to_string(col));
+    }
+    uint32_t offset;
+    std::memcpy(&offset, data + PAX_HEADER_SIZE + col * PAX_DESCRIPTOR_SIZE, sizeof(uint32_t));
+    return offset;
+}
+
+ColumnType PaxPage::getColumnType(size_t col) const {
+    if (col >= column_count) {
+        throw std::out_of_range("PAX column index out of range: " + std::to_string(col));
+    }
+    uint32_t type;
+    std::memcpy(&type, data + PAX_HEADER_SIZE + col * PAX_DESCRIPTOR_SIZE + sizeof(uint32_t),
+                sizeof(uint32_t));
+    return static_cast<ColumnType>(type);
+}
+
+const int_t* PaxPage::getIntColumn(size_t col) const {
+    if (getColumnType(col) != ColumnType::INT) {
+        throw std::runtime_error("PAX column is not INT: " + std::to_string(col));
+    }
+    return reinterpret_cast<const int_t*>(data + getMinipageOffset(col));
+}
+
+const decimal_t* PaxPage::getDecimalColumn(size_t col) const {
+    if (getColumnType(col) != ColumnType::DECIMAL) {
+        throw std::runtime_error("PAX column is not DECIMAL: " + std::to_string(col));
+    }
+    return reinterpret_cast<const decimal_t*>(data + getMinipageOffset(col));
+}
+
+FieldRef PaxPage::getString(size_t col, size_t row) const {
+    if (getColumnType(col) != ColumnType::STRING) {
+        throw std::runtime_error("PAX column is not STRING: " + std::to_string(col));
+    }
+    const char* minipage = data + getMinipageOffset(col);
+    const char* bytes = minipage + record_count * sizeof(uint16_t);
+
+    uint16_t begin = 0, end;
+    if (row > 0) {
+        std::memcpy(&begin, minipage + (row - 1) * sizeof(uint16_t), sizeof(uint16_t));
+    }
+    std::memcpy(&end, minipage + row * sizeof(uint16_t), sizeof(uint16_t));
+
+    FieldRef ref = { bytes + begin, static_cast<size_t>(end - begin) };
+    return ref;
+}
+
+FieldRef PaxPage::getFieldText(size_t col, size_t row, std::string& scratch) const {
+    switch (getColumnType(col)) {
+        case ColumnType::INT:
+            scratch = std::to_string(getIntColumn(col)[row]);
+            break;
+        case ColumnType::DECIMAL:
+            scratch = std::to_string(getDecimalColumn(col)[row]);
+            break;
+        case ColumnType::STRING:
+            return getString(col, row);
+    }
+    FieldRef ref = { scratch.data(), scratch.size() };
+    return ref;
+}
+
+Record PaxPage::getRecord(size_t row) const {
+    if (row >= record_count) {
+        throw std::out_of_range("PAX row index out of range: " + std::to_string(row));
+    }
+
+    Record record;
+    for (size_t col = 0; col < column_count; ++col) {
+        switch (getColumnType(col)) {
+            case ColumnType::INT:
+                record.addField(std::to_string(getIntColumn(col)[row]));
+                break;
+            case ColumnType::DECIMAL:
+                record.addField(std::to_string(getDecimalColumn(col)[row]));
+                break;
+            case ColumnType::STRING:
+                record.addField(getString(col, row).toString());
+                break;
+        }
+    }
+    return record;
+}
+
+// ============================================================================
+// PaxPageBuilder 구현
+// ============================================================================
+
+PaxPageBuilder::PaxPageBuilder(const std::vector<ColumnType>& column_types, size_t blk_size)
+    : schema(column_types), page_size(blk_size), record_count(0), columns(column_types.size()) {
+    if (schema.empty() || schema.size() > UINT16_MAX) {
+        throw std::runtime_error("Invalid PAX schema");
+    }
+}
+
+size_t PaxPageBuilder::computePageSize(size_t records,
+                                       const std::vector<size_t>& string_bytes) const {
+    size_t size = alignTo4(PAX_HEADER_SIZE + schema.size() * PAX_DESCRIPTOR_SIZE);
+    for (size_t col = 0; col < schema.size(); ++col) {
+        if (schema[col] == ColumnType::STRING) {
+            size += alignTo4(records * sizeof(uint16_t) + string_bytes[col]);
+        } else {
+            size += records * sizeof(int_t);
+        }
+    }
+    return size;
+}
+
+bool PaxPageBuilder::add(const Record& record) {
+    if (record.getFieldCount() != schema.size()) {
+        throw std::runtime_error("PAX record field count mismatch: expected " +
+                                 std::to_string(schema.size()) + ", got " +
+                                 std::to_string(record.getFieldCount()));
+    }
+    if (record_count >= UINT16_MAX) {
+        return false;
+    }
+
+    // 추가 후 크기 확인
+    std::vector<size_t> string_bytes(schema.size(), 0);
+    for (size_t col = 0; col < schema.size(); ++col) {
+        if (schema[col] == ColumnType::STRING) {
+            string_bytes[col] = columns[col].string_bytes.size() + record.getField(col).size();
+            if (string_bytes[col] > UINT16_MAX) {
+                return false;
+            }
+        }
+    }
+    if (computePageSize(record_count + 1, string_bytes) > page_size) {
+        return false;
+    }
+
+    for (size_t col = 0; col < schema.size(); ++col) {
+        const std::string& field = record.getField(col);
+        switch (schema[col]) {
+            case ColumnType::INT:
+                columns[col].ints.push_back(
+                    static_cast<int_t>(std::strtol(field.c_str(), nullptr, 10)));
+                break;
+            case ColumnType::DECIMAL:
+                columns[col].decimals.push_back(std::strtof(field.c_str(), nullptr));
+                break;
+            case ColumnType::STRING:
+                columns[col].string_bytes += field;
+                columns[col].string_ends.push_back(
+                    static_cast<uint16_t>(columns[col].string_bytes.size()));
+                break;
+        }
+    }
+
+    record_count++;
+    return true;
+}
+
+void PaxPageBuilder::flush(Block* block) {
+    if (block->getSize() != page_size) {
+        throw std::runtime_error("PAX page size mismatch");
+    }
+
+    block->clear();
+    char* data = block->getData();
+
+    uint32_t magic = PAX_PAGE_MAGIC;
+    uint16_t count = static_cast<uint16_t>(record_count);
+    uint16_t col_count = static_cast<uint16_t>(schema.size());
+    std::memcpy(data, &magic, sizeof(uint32_t));
+    std::memcpy(data + sizeof(uint32_t), &count, sizeof(uint16_t));
+    std::memcpy(data + sizeof(uint32_t) + sizeof(uint16_t), &col_count, sizeof(uint16_t));
+
+    size_t pos = alignTo4(PAX_HEADER_SIZE + schema.size() * PAX_DESCRIPTOR_SIZE);
+
+    for (size_t col = 0; col < schema.size(); ++col) {
+        // 디스크립터 기록
+        uint32_t offset = static_cast<uint32_t>(pos);
+        uint32_t type = static_cast<uint32_t>(schema[col]);
+        char* desc = data + PAX_HEADER_SIZE + col * PAX_DESCRIPTOR_SIZE;
+        std::memcpy(desc, &offset, sizeof(uint32_t));
+        std::memcpy(desc + sizeof(uint32_t), &type, sizeof(uint32_t));
+
+        // 미니페이지 기록
+        const ColumnData& column = columns[col];
+        switch (schema[col]) {
+            case ColumnType::INT:
+                std::memcpy(data + pos, column.ints.data(), record_count * sizeof(int_t));
+                pos += record_count * sizeof(int_t);
+                break;
+            case ColumnType::DECIMAL:
+                std::memcpy(data + pos, column.decimals.data(), record_count * sizeof(decimal_t));
+                pos += record_count * sizeof(decimal_t);
+                break;
+            case ColumnType::STRING:
+                std::memcpy(data + pos, column.string_ends.data(), record_count * sizeof(uint16_t));
+                pos += record_count * sizeof(uint16_t);
+                std::memcpy(data + pos, column.string_bytes.data(), column.string_bytes.size());
+                pos = alignTo4(pos + column.string_bytes.size());
+                break;
+        }
+    }
+
+    block->setUsedSize(pos);
+    clear();
+}
+
+void PaxPageBuilder::clear() {
+    record_count = 0;
+    for (auto& column : columns) {
+        column.ints.clear();
+        column.decimals.clear();
+        column.string_ends.clear();
+        column.string_bytes.clear();
+    }
+}
+
+// ============================================================================
+// VectorizedScan 구현
+// ============================================================================
+
+VectorizedScan::VectorizedScan(TableReader& rdr, size_t blk_size, const std::string& table_type)
+    : reader(rdr), block(blk_size), schema(getTableSchema(table_type)),
+      is_pax(false), row_count(0),
+      int_cache(schema.size()), decimal_cache(schema.size()), cached(schema.size(), false) {
+}
+
+bool VectorizedScan::next() {
+    views.clear();
+    std::fill(cached.begin(), cached.end(), false);
+    row_count = 0;
+
+    if (!reader.readBlock(&block)) {
+        return false;
+    }
+
+    is_pax = PaxPage::isPaxPage(&block);
+    if (is_pax) {
+        PaxPage page(&block);
+        if (page.getColumnCount() != schema.size()) {
+            throw std::runtime_error("PAX page column count does not match table schema");
+        }
+        row_count = page.getRecordCount();
+    } else {
+        RecordReader rec_reader(&block);
+        while (rec_reader.hasNext()) {
+            views.push_back(rec_reader.readNextView());
+        }
+        row_count = views.size();
+    }
+    return true;
+}
+
+const int_t* VectorizedScan::getIntColumn(size_t col) {
+    if (is_pax) {
+        return PaxPage(&block).getIntColumn(col);
+    }
+    if (col >= schema.size() || schema[col] != ColumnType::INT) {
+        throw std::runtime_error("Column is not INT: " + std::to_string(col));
+    }
+
+    // 행 페이지: 요청된 컬럼만 배열로 전개
+    if (!cached[col]) {
+        std::vector<int_t>& values = int_cache[col];
+        values.resize(row_count);
+        for (size_t i = 0; i < row_count; ++i) {
+            std::string text = views[i].getField(col).toString();
+            values[i] = static_cast<int_t>(std::strtol(text.c_str(), nullptr, 10));
+        }
+        cached[col] = true;
+    }
+    return int_cache[col].data();
+}
+
+const decimal_t* VectorizedScan::getDecimalColumn(size_t col) {
+    if (is_pax) {
+        return PaxPage(&block).getDecimalColumn(col);
+    }
+    if (col >= schema.size() || schema[col] != ColumnType::DECIMAL) {
+        throw std::runtime_error("Column is not DECIMAL: " + std::to_string(col));
+    }
+
+    if (!cached[col]) {
+        std::vector<decimal_t>& values = decimal_cache[col];
+        values.resize(row_count);
+        for (size_t i = 0; i < row_count; ++i) {
+            std::string text = views[i].getField(col).toString();
+            values[i] = std::strtof(text.c_str(), nullptr);
+        }
+        cached[col] = true;
+    }
+    return decimal_cache[col].data();
+}
+
+FieldRef VectorizedScan::getString(size_t col, size_t row) const {
+    if (is_pax) {
+        return PaxPage(&block).getString(col, row);
+    }
+    return views[row].getField(col);
+}
+
+Record VectorizedScan::getRecord(size_t row) const {
+    if (is_pax) {
+        return PaxPage(&block).getRecord(row);
+    }
+    return views[row].toRecord();
+}
+
+// ============================================================================
+// 레이아웃 변환
+// ============================================================================
+
+size_t convertBlockLayout(const std::string& input_file,
+                          const std::string& output_file,
+                          const std::string& table_type,
+                          BlockLayout layout,
+                          size_t block_size,
+                          bool compress) {
+    TableReader reader(input_file, block_size, nullptr);
+    TableWriter writer(output_file, nullptr, compress);
+    writer.setTableType(table_type);
+
+    Block input_block(block_size);
+    Block output_block(block_size);
+    RecordWriter rec_writer(&output_block);
+    PaxPageBuilder pax_builder(getTableSchema(table_type), block_size);
+
+    size_t record_count = 0;
+
+    while (reader.readBlock(&input_block)) {
+        // RecordReader는 행/PAX 페이지를 모두 읽을 수 있음
+        RecordReader rec_reader(&input_block);
+
+        while (rec_reader.hasNext()) {
+            Record record = rec_reader.readNext();
+
+            if (layout == BlockLayout::PAX) {
+                if (!pax_builder.add(record)) {
+                    // 페이지가 가득 차면 디스크에 쓰고 새 페이지 시작
+                    pax_builder.flush(&output_block);
+                    writer.writeBlock(&output_block);
+
+                    if (!pax_builder.add(record)) {
+                        throw std::runtime_error("Record too large for PAX page");
+                    }
+                }
+            } else {
+                if (!rec_writer.writeRecord(record)) {
+                    writer.writeBlock(&output_block);
+                    output_block.clear();
+
+                    if (!rec_writer.writeRecord(record)) {
+                        throw std::runtime_error("Record too large for block");
+                    }
+                }
+            }
+
+            record_count++;
+        }
+    }
+
+    // 마지막 블록 쓰기
+    if (layout == BlockLayout::PAX && !pax_builder.isEmpty()) {
+        pax_builder.flush(&output_block);
+    }
+    if (!output_block.isEmpty()) {
+        writer.writeBlock(&output_block);
+    }
+
+    // 딕셔너리 사이드카는 레이아웃과 무관하므로 그대로 복사
+    std::unique_ptr<PartDictionary> dict = PartDictionary::loadIfExists(input_file);
+    if (dict) {
+        writer.setDictionaryEncoded(true);
+        dict->save(output_file);
+    }
+
+    std::cout << "Converted " << record_count << " records from " << input_file
+              << " to " << output_file << " ("
+              << (layout == BlockLayout::PAX ? "pax" : "row") << " layout)" << std::endl;
+    writer.printCompressionSummary();
+
+    return record_count;
+}
@@ -0,0 +1,270 @@
+#include "perf_counters.h"
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+bool g_enabled = false;
+thread_local OperatorPerfScope* t_scope = nullptr;
+
+const int PHASE_COUNT = static_cast<int>(MemoryPhase::COUNT);
+
+#ifdef __linux__
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+// PerfEvent 순서
+const EventConfig EVENT_CONFIGS[STAT_PERF_EVENT_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},   // 대부분의 CPU에서 LLC 미스
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+                         (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+};
+
+// 이 스레드의 사용자 공간 이벤트 하나를 엶 (실패하면 -1, errno 설정)
+int openEvent(const EventConfig& event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+} // namespace
+
+const char* perfEventName(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::CYCLES: return "cycles";
+        case PerfEvent::INSTRUCTIONS: return "instructions";
+        case PerfEvent::LLC_MISSES: return "llc_misses";
+        case PerfEvent::BRANCH_MISSES: return "branch_misses";
+        case PerfEvent::DTLB_MISSES: return "dtlb_misses";
+        default: return "unknown";
+    }
+}
+
+// ============================================================================
+// PerfCounters
+// ============================================================================
+void PerfCounters::setEnabled(bool enabled) {
+    g_enabled = enabled;
+}
+
+bool PerfCounters::isEnabled() {
+    return g_enabled;
+}
+
+PerfCounters::PerfCounters() {
+    for (int i = 0; i < STAT_PERF_EVENT_COUNT; ++i) {
+        fds[i] = -1;
+    }
+#ifdef __linux__
+    int first_errno = 0;
+    for (int i = 0; i < STAT_PERF_EVENT_COUNT; ++i) {
+        fds[i] = openEvent(EVENT_CONFIGS[i]);
+        if (fds[i] < 0 && first_errno == 0) {
+            first_errno = errno;
+        }
+    }
+    if (!available()) {
+        error = std::string("perf_event_open: ") + std::strerror(first_errno);
+        if (first_errno == EACCES || first_errno == EPERM) {
+            error += " (check /proc/sys/kernel/perf_event_paranoid)";
+        } else if (first_errno == ENOENT || first_errno == EOPNOTSUPP) {
+            error += " (no hardware PMU, e.g. inside a virtual machine)";
+        }
+    }
+#else
+    error = "hardware counters need Linux perf_event_open";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int i = 0; i < STAT_PERF_EVENT_COUNT; ++i) {
+        if (fds[i] >= 0) {
+            close(fds[i]);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::available() const {
+    for (int i = 0; i < STAT_PERF_EVENT_COUNT; ++i) {
+        if (fds[i] >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerfCounters::read(uint64_t values[STAT_PERF_EVENT_COUNT]) const {
+    for (int i = 0; i < STAT_PERF_EVENT_COUNT; ++i) {
+        values[i] = 0;
+#ifdef __linux__
+        if (fds[i] < 0) {
+            continue;
+        }
+        // [값, 활성 시간, 실제로 센 시간]
+        uint64_t data[3];
+        if (::read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+            continue;
+        }
+        if (data[2] > 0 && data[2] < data[1]) {
+            values[i] = static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+        } else {
+            values[i] = data[0];
+        }
+#endif
+    }
+}
+
+// ============================================================================
+// OperatorPerfScope
+// ============================================================================
+OperatorPerfScope::OperatorPerfScope()
+    : counters(nullptr), phase_counts(), last(),
+      current_phase(static_cast<int>(MemoryPhase::SETUP)),
+      saved_scope(t_scope), finished(false) {
+    if (!PerfCounters::isEnabled()) {
+        return;
+    }
+    counters = new PerfCounters();
+    if (counters->available()) {
+        counters->read(last);
+        t_scope = this;
+    }
+}
+
+OperatorPerfScope::~OperatorPerfScope() {
+    if (t_scope == this) {
+        t_scope = saved_scope;
+    }
+    delete counters;
+}
+
+OperatorPerfScope* OperatorPerfScope::current() {
+    return t_scope;
+}
+
+void OperatorPerfScope::accumulate() {
+    uint64_t now[STAT_PERF_EVENT_COUNT];
+    counters->read(now);
+    for (int i = 0; i < STAT_PERF_EVENT_COUNT; ++i) {
+        phase_counts[current_phase][i] += now[i] - last[i];
+        last[i] = now[i];
+    }
+}
+
+void OperatorPerfScope::switchPhase(MemoryPhase phase) {
+    if (finished || !counters || !counters->available()) {
+        return;
+    }
+    accumulate();
+    current_phase = static_cast<int>(phase);
+}
+
+void OperatorPerfScope::finish(Statistics& stats) {
+    if (!counters || !counters->available() || finished) {
+        return;
+    }
+    accumulate();
+    finished = true;
+    if (t_scope == this) {
+        t_scope = saved_scope;
+    }
+
+    stats.perf_valid = 0;
+    for (int i = 0; i < STAT_PERF_EVENT_COUNT; ++i) {
+        stats.perf_counts[i] = 0;
+        for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+            stats.perf_counts[i] += phase_counts[phase][i];
+        }
+        if (counters->has(static_cast<PerfEvent>(i))) {
+            stats.perf_valid |= 1u << i;
+        }
+    }
+}
+
+// ============================================================================
+// 출력
+// ============================================================================
+void printPerfCounters(std::ostream& out, const OperatorPerfScope& scope, size_t output_records) {
+    if (!scope.enabled()) {
+        return;
+    }
+    const PerfCounters* counters = scope.getCounters();
+    if (!counters->available()) {
+        out << "Hardware Counters: unavailable (" << counters->getError() << ")" << std::endl;
+        return;
+    }
+
+    const char* headers[STAT_PERF_EVENT_COUNT] = {"cycles", "instr", "LLC-miss", "br-miss", "dTLB-miss"};
+    double divisor = output_records > 0 ? static_cast<double>(output_records) : 1.0;
+
+    auto line = [&](const char* name, const uint64_t counts[STAT_PERF_EVENT_COUNT]) {
+        out << "  " << std::left << std::setw(10) << name << std::right;
+        for (int i = 0; i < STAT_PERF_EVENT_COUNT; ++i) {
+            out << std::setw(11);
+            if (counters->has(static_cast<PerfEvent>(i))) {
+                out << counts[i] / divisor;
+            } else {
+                out << "n/a";
+            }
+        }
+        int cycles = static_cast<int>(PerfEvent::CYCLES);
+        int instructions = static_cast<int>(PerfEvent::INSTRUCTIONS);
+        out << std::setw(7);
+        if (counters->has(PerfEvent::CYCLES) && counters->has(PerfEvent::INSTRUCTIONS) &&
+            counts[cycles] > 0) {
+            out << std::setprecision(2) << static_cast<double>(counts[instructions]) / counts[cycles]
+                << std::setprecision(1);
+        } else {
+            out << "n/a";
+        }
+        out << std::endl;
+    };
+
+    out << "Hardware Counters ("
+        << (output_records > 0 ? "per output tuple, " + std::to_string(output_records) + " tuples"
+                               : std::string("totals, no output tuples"))
+        << "):" << std::fixed << std::setprecision(1) << std::endl;
+    out << "  " << std::left << std::setw(10) << "phase" << std::right;
+    for (int i = 0; i < STAT_PERF_EVENT_COUNT; ++i) {
+        out << std::setw(11) << headers[i];
+    }
+    out << std::setw(7) << "IPC" << std::endl;
+
+    uint64_t total[STAT_PERF_EVENT_COUNT] = {};
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        const uint64_t* counts = scope.phaseCounts(static_cast<MemoryPhase>(phase));
+        bool any = false;
+        for (int i = 0; i < STAT_PERF_EVENT_COUNT; ++i) {
+            total[i] += counts[i];
+            any = any || counts[i] > 0;
+        }
+        if (any) {
+            line(memoryPhaseName(static_cast<MemoryPhase>(phase)), counts);
+        }
+    }
+    line("total", total);
+    out.unsetf(std::ios::fixed);
+    out << std::setprecision(6);
+}
@@ -0,0 +1,142 @@
+#include "phase_timer.h"
+#include "memory_tracker.h"
+#include "perf_counters.h"
+#include "result_sink.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+const char* timerPhaseName(TimerPhase phase) {
+    switch (phase) {
+        case TimerPhase::READ: return "read";
+        case TimerPhase::DECODE: return "decode";
+        case TimerPhase::COMPARE: return "compare";
+        case TimerPhase::ENCODE: return "encode";
+        case TimerPhase::WRITE: return "write";
+        default: return "unknown";
+    }
+}
+
+#ifdef PHASE_TIMER_RDTSC
+// rdtsc 틱과 steady_clock을 20ms 동안 함께 재서 초당 틱 수 계산
+static double calibrateTicksPerSecond() {
+    auto wall_start = std::chrono::steady_clock::now();
+    uint64_t tick_start = timerNow();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    uint64_t tick_end = timerNow();
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wall_start;
+    return (tick_end - tick_start) / wall.count();
+}
+#endif
+
+double timerTicksPerSecond() {
+#ifdef PHASE_TIMER_RDTSC
+    static const double ticks_per_second = calibrateTicksPerSecond();
+    return ticks_per_second;
+#else
+    return 1e9;
+#endif
+}
+
+void printPhaseBreakdown(std::ostream& out, const Statistics& stats) {
+#if DBSYS_PHASE_TIMERS
+    double measured = 0;
+    for (int i = 0; i < STAT_PHASE_COUNT; ++i) {
+        measured += phaseSeconds(stats, static_cast<TimerPhase>(i));
+    }
+    double total = std::max(stats.elapsed_time, measured);
+
+    auto line = [&](const char* name, double seconds) {
+        out << "  " << std::left << std::setw(10) << name << std::right
+            << std::setw(10) << seconds * 1000.0 << "  ("
+            << std::setw(5) << (total > 0 ? seconds / total * 100.0 : 0.0) << "%)" << std::endl;
+    };
+
+    out << "Phase Breakdown (ms):" << std::fixed << std::setprecision(1) << std::endl;
+    for (int i = 0; i < STAT_PHASE_COUNT; ++i) {
+        TimerPhase phase = static_cast<TimerPhase>(i);
+        line(timerPhaseName(phase), phaseSeconds(stats, phase));
+    }
+    // 계획, 파일 열기, 해시 테이블 정리 등 단계 밖의 시간
+    line("other", total - measured);
+    out.unsetf(std::ios::fixed);
+    out << std::setprecision(6);
+#else
+    (void)stats;
+    out << "Phase Breakdown: disabled (built with DBSYS_PHASE_TIMERS=0)" << std::endl;
+#endif
+}
+
+// JSON 문자열 이스케이프 (따옴표, 역슬래시, 제어 문자)
+std::string jsonString(const std::string& value) {
+    std::string escaped = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            escaped += buf;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped + "\"";
+}
+
+void writeStatisticsJson(const std::string& path, const std::string& algorithm,
+                         const Statistics& stats) {
+    std::ofstream file;
+    if (path != "-") {
+        file.open(path);
+        if (!file) {
+            throw std::runtime_error("Cannot open statistics file: " + path);
+        }
+    }
+    std::ostream& out = path == "-" ? std::cout : file;
+
+    out << "{\n"
+        << "  \"algorithm\": " << jsonString(algorithm) << ",\n"
+        << "  \"block_reads\": " << stats.block_reads << ",\n"
+        << "  \"block_writes\": " << stats.block_writes << ",\n"
+        << "  \"physical_block_reads\": " << stats.physical_block_reads << ",\n"
+        << "  \"physical_block_writes\": " << stats.physical_block_writes << ",\n"
+        << "  \"blocks_skipped\": " << stats.blocks_skipped << ",\n"
+        << "  \"buffer_hits\": " << stats.buffer_hits << ",\n"
+        << "  \"buffer_misses\": " << stats.buffer_misses << ",\n"
+        << "  \"output_records\": " << stats.output_records << ",\n"
+        << "  \"elapsed_seconds\": " << std::setprecision(9) << stats.elapsed_time << ",\n"
+        << "  \"memory_usage_bytes\": " << stats.memory_usage << ",\n"
+        << "  \"tracked_memory_peak_bytes\": " << stats.tracked_memory_peak << ",\n"
+        << "  \"alloc_tracking\": " << (DBSYS_TRACK_ALLOC ? "true" : "false") << ",\n"
+        << "  \"phase_timers\": " << (DBSYS_PHASE_TIMERS ? "true" : "false") << ",\n"
+        << "  \"phase_seconds\": {";
+    for (int i = 0; i < STAT_PHASE_COUNT; ++i) {
+        TimerPhase phase = static_cast<TimerPhase>(i);
+        out << (i > 0 ? ", " : "") << "\"" << timerPhaseName(phase) << "\": "
+            << (DBSYS_PHASE_TIMERS ? phaseSeconds(stats, phase) : 0.0);
+    }
+    // 측정한 하드웨어 카운터만 (--perf-counters, 열 수 없었으면 빈 객체)
+    out << "},\n  \"hardware_counters\": {";
+    bool first = true;
+    for (int i = 0; i < STAT_PERF_EVENT_COUNT; ++i) {
+        if (stats.perf_valid & (1u << i)) {
+            out << (first ? "" : ", ") << "\"" << perfEventName(static_cast<PerfEvent>(i))
+                << "\": " << stats.perf_counts[i];
+            first = false;
+        }
+    }
+    out << "}";
+    // --sink checksum: 결과 행 해시의 합 (64비트라 문자열로)
+    if (stats.has_checksum) {
+        out << ",\n  \"result_checksum\": " << jsonString(checksumString(stats.result_checksum));
+    }
+    out << "\n}" << std::endl;
+    out << std::setprecision(6);
+}
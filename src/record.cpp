@@ -1,12 +1,55 @@
 #include "record.h"
+#include "pax.h"
 #include <cstring>
+#include <cstdio>
 #include <stdexcept>
 
-std::vector<char> Record::serialize() const {
+RecordEncoding parseRecordEncoding(const std::string& name) {
+    if (name == "row" || name == "length-prefixed") {
+        return RecordEncoding::LENGTH_PREFIXED;
+    }
+    if (name == "indexed" || name == "offset-indexed") {
+        return RecordEncoding::OFFSET_INDEXED;
+    }
+    throw std::runtime_error("Unknown record format: " + name);
+}
+
+std::vector<char> Record::serialize(RecordEncoding encoding) const {
     std::vector<char> buffer;
 
+    if (encoding == RecordEncoding::OFFSET_INDEXED) {
+        // 헤더(태그 + 필드 개수 + 오프셋 테이블)를 먼저 채우고 데이터를 뒤에 이어 붙임
+        size_t header_size = sizeof(uint16_t) * (2 + fields.size());
+        buffer.resize(header_size);
+        buffer.reserve(getSerializedSize(encoding));
+
+        uint16_t tag = RECORD_INDEXED_TAG;
+        uint16_t count = static_cast<uint16_t>(fields.size());
+        std::memcpy(buffer.data(), &tag, sizeof(uint16_t));
+        std::memcpy(buffer.data() + sizeof(uint16_t), &count, sizeof(uint16_t));
+
+        size_t end_offset = 0;
+        for (size_t i = 0; i < fields.size(); ++i) {
+            end_offset += fields[i].size();
+            if (end_offset > UINT16_MAX) {
+                throw std::runtime_error("Record too large for offset-indexed encoding");
+            }
+            uint16_t end_val = static_cast<uint16_t>(end_offset);
+            std::memcpy(buffer.data() + sizeof(uint16_t) * (2 + i), &end_val, sizeof(uint16_t));
+            buffer.insert(buffer.end(), fields[i].begin(), fields[i].end());
+        }
+
+        return buffer;
+    }
+
     // 각 필드를 직렬화
-    for (const auto& field : fields) {
+    for (size_t i = 0; i < fields.size(); ++i) {
+        const std::string& field = fields[i];
+        // 첫 필드 길이가 태그와 같으면 읽을 때 오프셋 인덱스 형식으로 오인됨
+        if (field.size() > UINT16_MAX || (i == 0 && field.size() == RECORD_INDEXED_TAG)) {
+            throw std::runtime_error("Field too large for length-prefixed encoding");
+        }
+
         // 필드 길이 (2 bytes)
         uint16_t field_len = static_cast<uint16_t>(field.size());
         buffer.insert(buffer.end(),
@@ -31,6 +74,17 @@ Record Record::deserialize(const char* data, size_t& offset) {
 
     size_t end_pos = pos + record_size;
 
+    // 오프셋 인덱스 형식이면 뷰를 통해 필드 복사
+    if (record_size >= sizeof(uint16_t)) {
+        uint16_t tag;
+        std::memcpy(&tag, data + pos, sizeof(uint16_t));
+        if (tag == RECORD_INDEXED_TAG) {
+            record = RecordView(data + pos, record_size).toRecord();
+            offset = end_pos;
+            return record;
+        }
+    }
+
     // 필드들 읽기
     while (pos < end_pos) {
         // 필드 길이 읽기
@@ -48,15 +102,110 @@ Record Record::deserialize(const char* data, size_t& offset) {
     return record;
 }
 
-size_t Record::getSerializedSize() const {
+size_t Record::getSerializedSize(RecordEncoding encoding) const {
     size_t size = 0;
     for (const auto& field : fields) {
         size += sizeof(uint16_t) + field.size();
     }
+    if (encoding == RecordEncoding::OFFSET_INDEXED) {
+        // 태그 + 필드 개수
+        size += 2 * sizeof(uint16_t);
+    }
     return size;
 }
 
+// RecordView 구현
+RecordView::RecordView(const char* data, uint32_t size)
+    : body(data), body_size(size), indexed(false), field_count(0) {
+    if (body_size >= 2 * sizeof(uint16_t)) {
+        uint16_t tag;
+        std::memcpy(&tag, body, sizeof(uint16_t));
+        if (tag == RECORD_INDEXED_TAG) {
+            indexed = true;
+            std::memcpy(&field_count, body + sizeof(uint16_t), sizeof(uint16_t));
+
+            // 오프셋 테이블이 본문 안에 있고 끝 위치가 단조 증가하며 데이터 영역을 넘지 않는지
+            size_t header_size = sizeof(uint16_t) * (2 + static_cast<size_t>(field_count));
+            if (header_size > body_size) {
+                throw std::runtime_error("Corrupt offset-indexed record: offset table exceeds record");
+            }
+            size_t data_size = body_size - header_size;
+            uint16_t prev = 0;
+            for (size_t i = 0; i < field_count; ++i) {
+                uint16_t end;
+                std::memcpy(&end, body + sizeof(uint16_t) * (2 + i), sizeof(uint16_t));
+                if (end < prev || end > data_size) {
+                    throw std::runtime_error("Corrupt offset-indexed record: bad field offset");
+                }
+                prev = end;
+            }
+            return;
+        }
+    }
+
+    // 길이 접두 형식: 필드 개수를 알기 위해 한 번 훑음
+    size_t pos = 0;
+    while (pos + sizeof(uint16_t) <= body_size) {
+        uint16_t field_len;
+        std::memcpy(&field_len, body + pos, sizeof(uint16_t));
+        pos += sizeof(uint16_t) + field_len;
+        field_count++;
+    }
+}
+
+FieldRef RecordView::getField(size_t idx) const {
+    if (idx >= field_count) {
+        throw std::out_of_range("Field index out of range: " + std::to_string(idx));
+    }
+
+    if (indexed) {
+        const char* offsets = body + 2 * sizeof(uint16_t);
+        const char* field_data = offsets + field_count * sizeof(uint16_t);
+
+        uint16_t begin = 0, end;
+        if (idx > 0) {
+            std::memcpy(&begin, offsets + (idx - 1) * sizeof(uint16_t), sizeof(uint16_t));
+        }
+        std::memcpy(&end, offsets + idx * sizeof(uint16_t), sizeof(uint16_t));
+
+        FieldRef ref = { field_data + begin, static_cast<size_t>(end - begin) };
+        return ref;
+    }
+
+    size_t pos = 0;
+    for (size_t i = 0; i < idx; ++i) {
+        uint16_t field_len;
+        std::memcpy(&field_len, body + pos, sizeof(uint16_t));
+        pos += sizeof(uint16_t) + field_len;
+    }
+
+    uint16_t field_len;
+    std::memcpy(&field_len, body + pos, sizeof(uint16_t));
+    FieldRef ref = { body + pos + sizeof(uint16_t), field_len };
+    return ref;
+}
+
+Record RecordView::toRecord() const {
+    Record record;
+    for (size_t i = 0; i < field_count; ++i) {
+        record.addField(getField(i).toString());
+    }
+    return record;
+}
+
+RecordReader::RecordReader(const Block* blk)
+    : block(blk), current_offset(0), is_pax(PaxPage::isPaxPage(blk)),
+      pax_row(0), pax_row_count(0) {
+    if (is_pax) {
+        pax_row_count = PaxPage(blk).getRecordCount();
+    }
+}
+
 bool RecordReader::hasNext() const {
+    if (is_pax) {
+        return pax_row < pax_row_count;
+    }
+
     // Need at least 4 bytes for record size
     if (current_offset + sizeof(uint32_t) > block->getUsedSize()) {
         return false;
@@ -82,13 +231,192 @@ Record RecordReader::readNext() {
         throw std::runtime_error("No more records in block");
     }
 
+    if (is_pax) {
+        return PaxPage(block).getRecord(pax_row++);
+    }
+
     const char* data = block->getData();
     Record record = Record::deserialize(data, current_offset);
 
     return record;
 }
 
+RecordView RecordReader::readNextView() {
+    if (!hasNext()) {
+        throw std::runtime_error("No more records in block");
+    }
+
+    if (is_pax) {
+        // PAX 레코드는 연속된 바이트가 아니므로 임시 버퍼에 행 형식으로 복원
+        // (호환용 경로, 스캔/분석/존 맵은 PAX 페이지를 컬럼 접근자로 직접 읽음)
+        scratch = PaxPage(block).getRecord(pax_row++).serialize(RecordEncoding::OFFSET_INDEXED);
+        return RecordView(scratch.data(), static_cast<uint32_t>(scratch.size()));
+    }
+
+    const char* data = block->getData();
+    uint32_t record_size;
+    std::memcpy(&record_size, data + current_offset, sizeof(uint32_t));
+
+    RecordView view(data + current_offset + sizeof(uint32_t), record_size);
+    current_offset += sizeof(uint32_t) + record_size;
+
+    return view;
+}
+
+// RecordBuilder 구현
+RecordBuilder::RecordBuilder(Block* blk, RecordEncoding enc)
+    : block(blk), encoding(enc), record_start(0), data_start(0), write_pos(0),
+      expected_fields(0), field_index(0), overflow(false), active(false) {}
+
+bool RecordBuilder::reserve(size_t len) {
+    if (overflow) {
+        return false;
+    }
+    if (write_pos + len > block->getSize()) {
+        overflow = true;
+        return false;
+    }
+    return true;
+}
+
+void RecordBuilder::begin(size_t num_fields) {
+    record_start = block->getUsedSize();
+    expected_fields = num_fields;
+    field_index = 0;
+    overflow = false;
+    active = true;
+
+    // record_size 자리 확보
+    write_pos = record_start;
+    size_t header_size = sizeof(uint32_t);
+    if (encoding == RecordEncoding::OFFSET_INDEXED) {
+        header_size += sizeof(uint16_t) * (2 + num_fields);
+    }
+    if (!reserve(header_size)) {
+        return;
+    }
+
+    if (encoding == RecordEncoding::OFFSET_INDEXED) {
+        char* data = block->getData();
+        uint16_t tag = RECORD_INDEXED_TAG;
+        uint16_t count = static_cast<uint16_t>(num_fields);
+        std::memcpy(data + record_start + sizeof(uint32_t), &tag, sizeof(uint16_t));
+        std::memcpy(data + record_start + sizeof(uint32_t) + sizeof(uint16_t),
+                    &count, sizeof(uint16_t));
+    }
+
+    write_pos += header_size;
+    data_start = write_pos;
+}
+
+RecordBuilder& RecordBuilder::addString(const char* value, size_t len) {
+    if (!active || len > UINT16_MAX) {
+        overflow = true;
+        return *this;
+    }
+
+    char* data = block->getData();
+
+    if (encoding == RecordEncoding::OFFSET_INDEXED) {
+        if (field_index >= expected_fields || !reserve(len)) {
+            overflow = true;
+            return *this;
+        }
+        std::memcpy(data + write_pos, value, len);
+        write_pos += len;
+
+        size_t end_offset = write_pos - data_start;
+        if (end_offset > UINT16_MAX) {
+            overflow = true;
+            return *this;
+        }
+        uint16_t end_val = static_cast<uint16_t>(end_offset);
+        std::memcpy(data + record_start + sizeof(uint32_t) + sizeof(uint16_t) * (2 + field_index),
+                    &end_val, sizeof(uint16_t));
+    } else {
+        // 첫 필드 길이가 태그와 같으면 오프셋 인덱스 형식으로 오인됨
+        if (field_index == 0 && len == RECORD_INDEXED_TAG) {
+            overflow = true;
+            return *this;
+        }
+        if (!reserve(sizeof(uint16_t) + len)) {
+            return *this;
+        }
+        uint16_t field_len = static_cast<uint16_t>(len);
+        std::memcpy(data + write_pos, &field_len, sizeof(uint16_t));
+        std::memcpy(data + write_pos + sizeof(uint16_t), value, len);
+        write_pos += sizeof(uint16_t) + len;
+    }
+
+    field_index++;
+    return *this;
+}
+
+RecordBuilder& RecordBuilder::addInt(int_t value) {
+    // std::to_string과 동일한 10진 표기를 스택 버퍼에 생성
+    char buf[16];
+    char* end = buf + sizeof(buf);
+    char* p = end;
+    uint32_t magnitude = value < 0 ? 0u - static_cast<uint32_t>(value)
+                                   : static_cast<uint32_t>(value);
+    do {
+        *--p = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) {
+        *--p = '-';
+    }
+    return addString(p, static_cast<size_t>(end - p));
+}
+
+RecordBuilder& RecordBuilder::addDecimal(decimal_t value) {
+    // std::to_string(float)과 동일한 "%f" 표기
+    char buf[64];
+    int len = std::snprintf(buf, sizeof(buf), "%f", static_cast<double>(value));
+    if (len < 0 || static_cast<size_t>(len) >= sizeof(buf)) {
+        overflow = true;
+        return *this;
+    }
+    return addString(buf, static_cast<size_t>(len));
+}
+
+bool RecordBuilder::commit() {
+    if (!active) {
+        return false;
+    }
+    if (overflow ||
+        (encoding == RecordEncoding::OFFSET_INDEXED && field_index != expected_fields)) {
+        rollback();
+        return false;
+    }
+
+    uint32_t record_size = static_cast<uint32_t>(write_pos - record_start - sizeof(uint32_t));
+    std::memcpy(block->getData() + record_start, &record_size, sizeof(uint32_t));
+    block->setUsedSize(write_pos);
+    active = false;
+    return true;
+}
+
+void RecordBuilder::rollback() {
+    if (!active) {
+        return;
+    }
+
+    // 부분적으로 쓴 바이트 제거 (빈 공간은 0이어야 RecordReader가 끝을 인식함)
+    size_t dirty_end = write_pos < block->getSize() ? write_pos : block->getSize();
+    if (dirty_end > record_start) {
+        std::memset(block->getData() + record_start, 0, dirty_end - record_start);
+    }
+    block->setUsedSize(record_start);
+    active = false;
+}
+
 bool RecordWriter::writeRecord(const Record& record) {
-    std::vector<char> serialized = record.serialize();
-    return block->append(serialized.data(), serialized.size());
+    // 임시 직렬화 버퍼 없이 블록에 직접 인코딩
+    RecordBuilder builder(block, encoding);
+    builder.begin(record.getFieldCount());
+    for (const auto& field : record.getFields()) {
+        builder.addString(field);
+    }
+    return builder.commit();
 }
@@ -0,0 +1,97 @@
+#include "result_sink.h"
+#include "table_stats.h"
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+
+SinkMode parseSinkMode(const std::string& name) {
+    if (name == "file") return SinkMode::FILE;
+    if (name == "null") return SinkMode::NULL_SINK;
+    if (name == "count") return SinkMode::COUNT;
+    if (name == "checksum") return SinkMode::CHECKSUM;
+    throw std::runtime_error("Unknown sink: " + name + " (use file, null, count or checksum)");
+}
+
+const char* sinkModeName(SinkMode mode) {
+    switch (mode) {
+        case SinkMode::FILE: return "file";
+        case SinkMode::NULL_SINK: return "null";
+        case SinkMode::COUNT: return "count";
+        case SinkMode::CHECKSUM: return "checksum";
+    }
+    return "unknown";
+}
+
+std::string checksumString(uint64_t checksum) {
+    char text[24];
+    std::snprintf(text, sizeof(text), "0x%016llx", static_cast<unsigned long long>(checksum));
+    return text;
+}
+
+ResultSink::ResultSink(SinkMode sink_mode, const std::string& output_file, StatisticsRef st)
+    : mode(sink_mode), stats(st), checksum(0), grant(nullptr), granted_bytes(0) {
+    if (mode == SinkMode::FILE) {
+        writer.reset(new TableWriter(output_file, stats));
+        writer->setTableType("JOIN");
+    }
+}
+
+void ResultSink::setMemoryGrant(MemoryGrant* memory_grant) {
+    grant = memory_grant;
+    granted_bytes = 0;
+    if (grant && writer) {
+        // 라이터 객체 자체도 힙에 있음
+        granted_bytes = sizeof(TableWriter) + writer->memoryBytes();
+        if (!grant->use(granted_bytes)) {
+            throw std::runtime_error(grant->getOwner() + ": memory limit too small for output writer");
+        }
+    }
+}
+
+void ResultSink::writeBlock(const Block* block) {
+    if (mode == SinkMode::FILE) {
+        // 존 맵 배열이 자라면 새 배열을 먼저 예약하고, 쓴 뒤 실제 크기로 맞춤
+        // (예약을 더 받지 못하면 출력 존 맵을 버리고 결과만 씀)
+        size_t growth = grant ? writer->writeGrowthBytes() : 0;
+        if (growth > 0 && !grant->use(growth)) {
+            std::cout << "Output zone map dropped (exceeds " << grant->getOwner()
+                      << " memory grant)" << std::endl;
+            writer->dropZoneMap();
+            growth = 0;
+        }
+        writer->writeBlock(block);
+        if (grant) {
+            size_t now = sizeof(TableWriter) + writer->memoryBytes();
+            grant->unuse(granted_bytes + growth - now);
+            granted_bytes = now;
+        }
+    } else if (mode == SinkMode::CHECKSUM) {
+        // 블록 형식: [record_size(4)][레코드 바이트] 반복
+        const char* data = block->getData();
+        size_t used = block->getUsedSize();
+        size_t pos = 0;
+        while (pos + sizeof(uint32_t) <= used) {
+            uint32_t size;
+            std::memcpy(&size, data + pos, sizeof(uint32_t));
+            pos += sizeof(uint32_t);
+            checksum += hashBytes(data + pos, size, 0);
+            pos += size;
+        }
+    }
+}
+
+void ResultSink::close() {
+    if (writer) {
+        writer->close();
+    }
+    if (grant) {
+        grant->unuse(granted_bytes);
+        grant = nullptr;
+        granted_bytes = 0;
+    }
+    Statistics* counters = stats.get();
+    if (mode == SinkMode::CHECKSUM && counters) {
+        counters->result_checksum = checksum;
+        counters->has_checksum = true;
+    }
+}
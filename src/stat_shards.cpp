@@ -0,0 +1,89 @@
+#include "stat_shards.h"
+#include <atomic>
+
+namespace {
+
+std::atomic<uint64_t> g_next_generation(1);
+
+// 스레드가 최근에 쓴 샤드 몇 개 (generation 0 = 빈 칸)
+const int SHARD_CACHE_ENTRIES = 4;
+
+struct ShardCacheEntry {
+    uint64_t generation;
+    Statistics* counters;
+};
+
+thread_local ShardCacheEntry t_cache[SHARD_CACHE_ENTRIES] = {};
+thread_local int t_cache_next = 0;
+
+} // namespace
+
+void addStatistics(Statistics& into, const Statistics& from) {
+    into.block_reads += from.block_reads;
+    into.block_writes += from.block_writes;
+    into.physical_block_reads += from.physical_block_reads;
+    into.physical_block_writes += from.physical_block_writes;
+    into.blocks_skipped += from.blocks_skipped;
+    into.buffer_hits += from.buffer_hits;
+    into.buffer_misses += from.buffer_misses;
+    into.output_records += from.output_records;
+    for (int i = 0; i < STAT_PHASE_COUNT; ++i) {
+        into.phase_ticks[i] += from.phase_ticks[i];
+    }
+    into.result_checksum += from.result_checksum;
+    into.has_checksum = into.has_checksum || from.has_checksum;
+}
+
+StatisticsShards::StatisticsShards(Statistics* merge_target)
+    : target(merge_target), owner(std::this_thread::get_id()),
+      generation(g_next_generation.fetch_add(1, std::memory_order_relaxed)) {}
+
+Statistics* StatisticsShards::local() {
+    if (!target) {
+        return nullptr;
+    }
+    for (const auto& entry : t_cache) {
+        if (entry.generation == generation) {
+            return entry.counters;
+        }
+    }
+    return registerThread();
+}
+
+Statistics* StatisticsShards::registerThread() {
+    std::thread::id self = std::this_thread::get_id();
+    Statistics* counters = nullptr;
+    if (self == owner) {
+        counters = target;
+    } else {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& shard : shards) {
+            if (shard->thread == self) {
+                counters = &shard->counters;
+                break;
+            }
+        }
+        if (!counters) {
+            shards.emplace_back(new Shard());
+            shards.back()->thread = self;
+            counters = &shards.back()->counters;
+        }
+    }
+
+    ShardCacheEntry& entry = t_cache[t_cache_next];
+    t_cache_next = (t_cache_next + 1) % SHARD_CACHE_ENTRIES;
+    entry.generation = generation;
+    entry.counters = counters;
+    return counters;
+}
+
+void StatisticsShards::merge() {
+    if (!target) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& shard : shards) {
+        addStatistics(*target, shard->counters);
+        shard->counters = Statistics();
+    }
+}
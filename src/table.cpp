@@ -1,8 +1,26 @@
 #include "table.h"
+#include "dictionary.h"
+#include "compression.h"
+#include "pax.h"
+#include "csv_loader.h"
+#include "buffer.h"
+#include "table_stats.h"
+#include "memory_governor.h"
+#include "phase_timer.h"
+#include "trace.h"
 #include <sstream>
 #include <iostream>
 #include <algorithm>
 #include <cctype>
+#include <cstdio>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <share.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
 
 // Helper function to trim whitespace from strings
 static std::string trim(const std::string& str) {
@@ -13,29 +31,127 @@ static std::string trim(const std::string& str) {
 }
 
 // Helper function to safely convert string to int
-static int safe_stoi(const std::string& str, const std::string& field_name) {
-    std::string trimmed = trim(str);
-    if (trimmed.empty()) {
-        throw std::runtime_error("Empty field for " + field_name);
-    }
-    try {
-        return std::stoi(trimmed);
-    } catch (const std::exception& e) {
+static int safe_stoi(const char* begin, const char* end, const std::string& field_name) {
+    int_t value;
+    if (!parseCsvInt(begin, end, value)) {
+        std::string trimmed = trim(std::string(begin, end));
+        if (trimmed.empty()) {
+            throw std::runtime_error("Empty field for " + field_name);
+        }
         throw std::runtime_error("Invalid integer in " + field_name + ": '" + trimmed + "'");
     }
+    return value;
+}
+
+static int safe_stoi(const std::string& str, const std::string& field_name) {
+    return safe_stoi(str.data(), str.data() + str.size(), field_name);
+}
+
+static float safe_stof(const char* begin, const char* end, const std::string& field_name) {
+    decimal_t value;
+    if (!parseCsvDecimal(begin, end, value)) {
+        std::string trimmed = trim(std::string(begin, end));
+        if (trimmed.empty()) {
+            throw std::runtime_error("Empty field for " + field_name);
+        }
+        throw std::runtime_error("Invalid float in " + field_name + ": '" + trimmed + "'");
+    }
+    return value;
 }
 
-// Helper function to safely convert string to float
 static float safe_stof(const std::string& str, const std::string& field_name) {
-    std::string trimmed = trim(str);
-    if (trimmed.empty()) {
-        throw std::runtime_error("Empty field for " + field_name);
+    return safe_stof(str.data(), str.data() + str.size(), field_name);
+}
+
+// '|' 구분 필드 토크나이저 (std::getline처럼 없는 필드는 빈 값)
+struct FieldTokenizer {
+    const char* pos;
+    const char* end;
+
+    FieldTokenizer(const char* begin, const char* line_end) : pos(begin), end(line_end) {}
+
+    void next(const char*& field_begin, const char*& field_end) {
+        field_begin = pos;
+        const char* delim = static_cast<const char*>(std::memchr(pos, '|', end - pos));
+        field_end = delim ? delim : end;
+        pos = delim ? delim + 1 : end;
     }
-    try {
-        return std::stof(trimmed);
-    } catch (const std::exception& e) {
-        throw std::runtime_error("Invalid float in " + field_name + ": '" + trimmed + "'");
+
+    std::string nextString() {
+        const char* b;
+        const char* e;
+        next(b, e);
+        return std::string(b, e);
+    }
+
+    int_t nextInt(const std::string& field_name) {
+        const char* b;
+        const char* e;
+        next(b, e);
+        return safe_stoi(b, e, field_name);
+    }
+
+    decimal_t nextDecimal(const std::string& field_name) {
+        const char* b;
+        const char* e;
+        next(b, e);
+        return safe_stof(b, e, field_name);
     }
+};
+
+// 테이블 스키마
+const std::vector<ColumnType>& getTableSchema(const std::string& table_type) {
+    static const std::vector<ColumnType> part_schema = {
+        ColumnType::INT,      // partkey
+        ColumnType::STRING,   // name
+        ColumnType::STRING,   // mfgr
+        ColumnType::STRING,   // brand
+        ColumnType::STRING,   // type
+        ColumnType::INT,      // size
+        ColumnType::STRING,   // container
+        ColumnType::DECIMAL,  // retailprice
+        ColumnType::STRING    // comment
+    };
+    static const std::vector<ColumnType> partsupp_schema = {
+        ColumnType::INT,      // partkey
+        ColumnType::INT,      // suppkey
+        ColumnType::INT,      // availqty
+        ColumnType::DECIMAL,  // supplycost
+        ColumnType::STRING    // comment
+    };
+    static const std::vector<ColumnType> join_schema = [] {
+        std::vector<ColumnType> schema = part_schema;
+        schema.insert(schema.end(), partsupp_schema.begin(), partsupp_schema.end());
+        return schema;
+    }();
+
+    if (table_type == "PART") return part_schema;
+    if (table_type == "PARTSUPP") return partsupp_schema;
+    if (table_type == "JOIN") return join_schema;
+    throw std::runtime_error("Unknown table type: " + table_type);
+}
+
+const std::vector<std::string>& getTableColumnNames(const std::string& table_type) {
+    static const std::vector<std::string> part_columns = {
+        "partkey", "name", "mfgr", "brand", "type", "size", "container", "retailprice", "comment"
+    };
+    static const std::vector<std::string> partsupp_columns = {
+        "partkey", "suppkey", "availqty", "supplycost", "comment"
+    };
+
+    if (table_type == "PART") return part_columns;
+    if (table_type == "PARTSUPP") return partsupp_columns;
+    throw std::runtime_error("Unknown table type: " + table_type);
+}
+
+size_t getColumnIndex(const std::string& table_type, const std::string& column_name) {
+    const std::vector<std::string>& names = getTableColumnNames(table_type);
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == column_name) {
+            return i;
+        }
+    }
+    throw std::runtime_error("Unknown column for " + table_type + ": " + column_name);
 }
 
 // PartRecord 구현
@@ -53,49 +169,99 @@ Record PartRecord::toRecord() const {
     return Record(fields);
 }
 
-PartRecord PartRecord::fromRecord(const Record& rec) {
+bool PartRecord::writeTo(RecordBuilder& builder) const {
+    builder.begin(9);
+    builder.addInt(partkey)
+           .addString(name)
+           .addString(mfgr)
+           .addString(brand)
+           .addString(type)
+           .addInt(size)
+           .addString(container)
+           .addDecimal(retailprice)
+           .addString(comment);
+    return builder.commit();
+}
+
+bool PartRecord::writeTo(RecordBuilder& builder, PartDictionary* dict) const {
+    if (!dict) {
+        return writeTo(builder);
+    }
+
+    // 저카디널리티 컬럼은 2바이트 코드로 기록
+    uint16_t mfgr_code = dict->getColumn(2).encode(mfgr);
+    uint16_t brand_code = dict->getColumn(3).encode(brand);
+    uint16_t type_code = dict->getColumn(4).encode(type);
+    uint16_t container_code = dict->getColumn(6).encode(container);
+
+    builder.begin(9);
+    builder.addInt(partkey)
+           .addString(name)
+           .addString(reinterpret_cast<const char*>(&mfgr_code), sizeof(uint16_t))
+           .addString(reinterpret_cast<const char*>(&brand_code), sizeof(uint16_t))
+           .addString(reinterpret_cast<const char*>(&type_code), sizeof(uint16_t))
+           .addInt(size)
+           .addString(reinterpret_cast<const char*>(&container_code), sizeof(uint16_t))
+           .addDecimal(retailprice)
+           .addString(comment);
+    return builder.commit();
+}
+
+// 딕셔너리 코드 필드를 문자열로 복원
+static const std::string& decodeField(const PartDictionary* dict, size_t col,
+                                      const std::string& field) {
+    return dict->getColumn(col).decode(PartDictionary::fieldToCode(field.data(), field.size()));
+}
+
+PartRecord PartRecord::fromRecord(const Record& rec, const PartDictionary* dict) {
     PartRecord part;
     if (rec.getFieldCount() < 9) {
         throw std::runtime_error("Invalid PART record: expected 9 fields, got " + std::to_string(rec.getFieldCount()));
     }
     part.partkey = safe_stoi(rec.getField(0), "PART.partkey");
     part.name = rec.getField(1);
-    part.mfgr = rec.getField(2);
-    part.brand = rec.getField(3);
-    part.type = rec.getField(4);
+    if (dict) {
+        part.mfgr = decodeField(dict, 2, rec.getField(2));
+        part.brand = decodeField(dict, 3, rec.getField(3));
+        part.type = decodeField(dict, 4, rec.getField(4));
+    } else {
+        part.mfgr = rec.getField(2);
+        part.brand = rec.getField(3);
+        part.type = rec.getField(4);
+    }
     part.size = safe_stoi(rec.getField(5), "PART.size");
-    part.container = rec.getField(6);
+    part.container = dict ? decodeField(dict, 6, rec.getField(6)) : rec.getField(6);
     part.retailprice = safe_stof(rec.getField(7), "PART.retailprice");
     part.comment = rec.getField(8);
     return part;
 }
 
 PartRecord PartRecord::fromCSV(const std::string& line) {
-    PartRecord part;
-    std::stringstream ss(line);
-    std::string field;
-
-    std::getline(ss, field, '|');
-    part.partkey = safe_stoi(field, "PART.partkey (CSV)");
-
-    std::getline(ss, part.name, '|');
-    std::getline(ss, part.mfgr, '|');
-    std::getline(ss, part.brand, '|');
-    std::getline(ss, part.type, '|');
-
-    std::getline(ss, field, '|');
-    part.size = safe_stoi(field, "PART.size (CSV)");
-
-    std::getline(ss, part.container, '|');
+    return fromCSV(line.data(), line.data() + line.size());
+}
 
-    std::getline(ss, field, '|');
-    part.retailprice = safe_stof(field, "PART.retailprice (CSV)");
+PartRecord PartRecord::fromCSV(const char* begin, const char* end) {
+    PartRecord part;
+    FieldTokenizer tokens(begin, end);
 
-    std::getline(ss, part.comment, '|');
+    part.partkey = tokens.nextInt("PART.partkey (CSV)");
+    part.name = tokens.nextString();
+    part.mfgr = tokens.nextString();
+    part.brand = tokens.nextString();
+    part.type = tokens.nextString();
+    part.size = tokens.nextInt("PART.size (CSV)");
+    part.container = tokens.nextString();
+    part.retailprice = tokens.nextDecimal("PART.retailprice (CSV)");
+    part.comment = tokens.nextString();
 
     return part;
 }
 
+size_t PartRecord::heapBytes() const {
+    return stringHeapBytes(name) + stringHeapBytes(mfgr) + stringHeapBytes(brand) +
+           stringHeapBytes(type) + stringHeapBytes(container) + stringHeapBytes(comment);
+}
+
 // PartSuppRecord 구현
 Record PartSuppRecord::toRecord() const {
     std::vector<std::string> fields;
@@ -107,6 +273,16 @@ Record PartSuppRecord::toRecord() const {
     return Record(fields);
 }
 
+bool PartSuppRecord::writeTo(RecordBuilder& builder) const {
+    builder.begin(5);
+    builder.addInt(partkey)
+           .addInt(suppkey)
+           .addInt(availqty)
+           .addDecimal(supplycost)
+           .addString(comment);
+    return builder.commit();
+}
+
 PartSuppRecord PartSuppRecord::fromRecord(const Record& rec) {
     PartSuppRecord partsupp;
     if (rec.getFieldCount() < 5) {
@@ -121,27 +297,26 @@ PartSuppRecord PartSuppRecord::fromRecord(const Record& rec) {
 }
 
 PartSuppRecord PartSuppRecord::fromCSV(const std::string& line) {
-    PartSuppRecord partsupp;
-    std::stringstream ss(line);
-    std::string field;
-
-    std::getline(ss, field, '|');
-    partsupp.partkey = safe_stoi(field, "PARTSUPP.partkey (CSV)");
-
-    std::getline(ss, field, '|');
-    partsupp.suppkey = safe_stoi(field, "PARTSUPP.suppkey (CSV)");
-
-    std::getline(ss, field, '|');
-    partsupp.availqty = safe_stoi(field, "PARTSUPP.availqty (CSV)");
+    return fromCSV(line.data(), line.data() + line.size());
+}
 
-    std::getline(ss, field, '|');
-    partsupp.supplycost = safe_stof(field, "PARTSUPP.supplycost (CSV)");
+PartSuppRecord PartSuppRecord::fromCSV(const char* begin, const char* end) {
+    PartSuppRecord partsupp;
+    FieldTokenizer tokens(begin, end);
 
-    std::getline(ss, partsupp.comment, '|');
+    partsupp.partkey = tokens.nextInt("PARTSUPP.partkey (CSV)");
+    partsupp.suppkey = tokens.nextInt("PARTSUPP.suppkey (CSV)");
+    partsupp.availqty = tokens.nextInt("PARTSUPP.availqty (CSV)");
+    partsupp.supplycost = tokens.nextDecimal("PARTSUPP.supplycost (CSV)");
+    partsupp.comment = tokens.nextString();
 
     return partsupp;
 }
 
+size_t PartSuppRecord::heapBytes() const {
+    return stringHeapBytes(comment);
+}
+
 // JoinResultRecord 구현
 Record JoinResultRecord::toRecord() const {
     std::vector<std::string> fields;
@@ -167,13 +342,136 @@ Record JoinResultRecord::toRecord() const {
     return Record(fields);
 }
 
+bool JoinResultRecord::encode(RecordBuilder& builder, const PartRecord& part,
+                              const PartSuppRecord& partsupp) {
+    builder.begin(14);
+
+    // PART 필드
+    builder.addInt(part.partkey)
+           .addString(part.name)
+           .addString(part.mfgr)
+           .addString(part.brand)
+           .addString(part.type)
+           .addInt(part.size)
+           .addString(part.container)
+           .addDecimal(part.retailprice)
+           .addString(part.comment);
+
+    // PARTSUPP 필드
+    builder.addInt(partsupp.partkey)
+           .addInt(partsupp.suppkey)
+           .addInt(partsupp.availqty)
+           .addDecimal(partsupp.supplycost)
+           .addString(partsupp.comment);
+
+    return builder.commit();
+}
+
 // TableReader 구현
-TableReader::TableReader(const std::string& fname, size_t blk_size, Statistics* st)
-    : filename(fname), block_size(blk_size), stats(st) {
+TableReader::TableReader(const std::string& fname, size_t blk_size, StatisticsRef st)
+    : filename(fname), block_size(blk_size), stats(st),
+      has_header(false), data_start(0), compressed(false), staging(blk_size), staging_pos(0), staging_len(0),
+      next_block(0), range_active(false), range_lo(0), range_hi(0), need_seek(false),
+      pool(nullptr), pool_file_id(0), logical_pos(0) {
     file.open(filename, std::ios::binary);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to open file: " + filename);
     }
+
+    // 파일 헤더 확인 (헤더가 없는 이전 형식이면 처음부터 블록)
+    has_header = readFileHeader(file, header);
+    if (has_header) {
+        data_start = FILE_HEADER_SIZE;
+        if (header.block_size != 0 && header.block_size != block_size) {
+            throw std::runtime_error("Block size mismatch for " + filename + ": file uses " +
+                                     std::to_string(header.block_size) + " bytes, reader uses " +
+                                     std::to_string(block_size));
+        }
+    }
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(data_start), std::ios::beg);
+
+    // 압축 파일 여부 확인 (데이터 첫 4바이트 magic)
+    uint32_t magic = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(uint32_t));
+    compressed = (file.gcount() == sizeof(uint32_t) && magic == COMPRESSED_FILE_MAGIC);
+
+    if (compressed) {
+        uint32_t logical_block_size = 0;
+        file.read(reinterpret_cast<char*>(&logical_block_size), sizeof(uint32_t));
+        if (logical_block_size != block_size) {
+            throw std::runtime_error("Block size mismatch for " + filename + ": file uses " +
+                                     std::to_string(logical_block_size) + " bytes, reader uses " +
+                                     std::to_string(block_size));
+        }
+    }
+
+    reset();
+    loadZoneMap();
+}
+
+void TableReader::loadZoneMap() {
+    zone_map = ZoneMap::loadIfExists(filename);
+    if (!zone_map) {
+        return;
+    }
+
+    // 오래된 사이드카면 사용하지 않음
+    std::ifstream probe(filename, std::ios::binary | std::ios::ate);
+    uint64_t file_size = static_cast<uint64_t>(probe.tellg());
+    bool consistent = true;
+
+    if (compressed) {
+        uint64_t prev = data_start;
+        for (const auto& entry : zone_map->getEntries()) {
+            if (entry.offset < prev || entry.offset >= file_size) {
+                consistent = false;
+                break;
+            }
+            prev = entry.offset;
+        }
+    } else {
+        consistent = (data_start + zone_map->size() * block_size == file_size);
+    }
+
+    if (!consistent) {
+        zone_map.reset();
+    }
+}
+
+void TableReader::seekTo(uint64_t offset) {
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    staging_pos = 0;
+    staging_len = 0;
+    logical_pos = offset;
+}
+
+void TableReader::setBufferPool(BufferManager* buffer_pool) {
+    pool = buffer_pool;
+    if (pool) {
+        pool_file_id = pool->registerFile(filename);
+    }
+}
+
+size_t TableReader::memoryBytes() const {
+    size_t bytes = TABLE_STREAM_BUFFER_BYTES + staging.capacity();
+    if (compressed) {
+        // 압축 프레임 버퍼는 읽는 동안 블록 크기 정도까지, 프레임 위치는 블록 수만큼 자람
+        bytes += std::max(frame.capacity(), block_size);
+        bytes += (has_header ? static_cast<size_t>(header.block_count) : frame_offsets.capacity()) *
+                 sizeof(uint64_t);
+    }
+    if (zone_map) {
+        bytes += sizeof(ZoneMap) + zone_map->size() * sizeof(ZoneEntry);
+    }
+    return bytes;
+}
+
+void TableReader::setKeyRange(int_t lo, int_t hi) {
+    range_active = true;
+    range_lo = lo;
+    range_hi = hi;
 }
 
 TableReader::~TableReader() {
@@ -182,8 +480,177 @@ TableReader::~TableReader() {
     }
 }
 
+bool TableReader::readPhysical(char* dst, size_t n) {
+    size_t copied = 0;
+
+    while (copied < n) {
+        if (staging_pos == staging_len) {
+            // 다음 물리 블록 읽기
+            file.read(staging.data(), block_size);
+            staging_len = static_cast<size_t>(file.gcount());
+            staging_pos = 0;
+
+            if (staging_len == 0) {
+                if (copied > 0) {
+                    throw std::runtime_error("Truncated compressed frame in " + filename);
+                }
+                return false;
+            }
+
+            if (Statistics* counters = stats.get()) {
+                counters->physical_block_reads++;
+            }
+        }
+
+        size_t chunk = std::min(n - copied, staging_len - staging_pos);
+        std::memcpy(dst + copied, staging.data() + staging_pos, chunk);
+        staging_pos += chunk;
+        copied += chunk;
+        logical_pos += chunk;
+    }
+
+    return true;
+}
+
 bool TableReader::readBlock(Block* block) {
-    if (!file.is_open() || file.eof()) {
+    if (!file.is_open()) {
+        return false;
+    }
+    PHASE_TIMER(stats.get(), TimerPhase::READ);
+    TRACE_SPAN("read block", "io");
+
+    // 존 맵으로 키 범위 밖 블록 건너뛰기
+    if (zone_map && range_active) {
+        while (next_block < zone_map->size() &&
+               !zone_map->get(next_block).overlaps(range_lo, range_hi)) {
+            next_block++;
+            need_seek = true;
+            if (Statistics* counters = stats.get()) {
+                counters->blocks_skipped++;
+            }
+        }
+        if (next_block >= zone_map->size()) {
+            return false;
+        }
+    }
+
+    if (!pool) {
+        return readFromFile(block);
+    }
+
+    // 페이지 캐시 확인 (미스면 프레임으로 읽어 들임)
+    size_t page_no = next_block;
+    bool loaded = false;
+    Block* page = pool->fetchPage(pool_file_id, page_no, [&](Block* frame) {
+        loaded = true;
+        return readFromFile(frame);
+    });
+
+    if (!page) {
+        if (loaded) {
+            return false;  // 파일 끝
+        }
+        // 모든 프레임이 고정됨: 캐시 없이 읽기
+        if (Statistics* counters = stats.get()) {
+            counters->buffer_misses++;
+        }
+        return readFromFile(block);
+    }
+
+    std::memcpy(block->getData(), page->getData(), page->getUsedSize());
+    block->setUsedSize(page->getUsedSize());
+    pool->unpinPage(pool_file_id, page_no);
+
+    if (loaded) {
+        if (Statistics* counters = stats.get()) {
+            counters->buffer_misses++;
+        }
+    } else {
+        // 적중: 파일을 읽지 않았으므로 다음 미스에서 위치 이동
+        next_block++;
+        need_seek = true;
+        if (Statistics* counters = stats.get()) {
+            counters->block_reads++;
+            counters->buffer_hits++;
+        }
+    }
+    return true;
+}
+
+void TableReader::positionAtNextBlock() {
+    need_seek = false;
+
+    if (zone_map && next_block < zone_map->size()) {
+        seekTo(zone_map->get(next_block).offset);
+        return;
+    }
+    if (!compressed) {
+        seekTo(data_start + static_cast<uint64_t>(next_block) * block_size);
+        return;
+    }
+
+    // 압축 파일: 알려진 마지막 프레임부터 프레임 헤더만 읽어 위치 계산
+    if (frame_offsets.empty()) {
+        frame_offsets.push_back(data_start + COMPRESSED_FILE_HEADER_SIZE);
+    }
+    while (frame_offsets.size() <= next_block) {
+        char header[COMPRESSED_FRAME_HEADER_SIZE];
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(frame_offsets.back()), std::ios::beg);
+        file.read(header, sizeof(header));
+        if (file.gcount() != static_cast<std::streamsize>(sizeof(header))) {
+            break;
+        }
+        uint32_t compressed_size;
+        std::memcpy(&compressed_size, header, sizeof(uint32_t));
+        frame_offsets.push_back(frame_offsets.back() + sizeof(header) + compressed_size);
+    }
+    seekTo(frame_offsets[std::min<size_t>(next_block, frame_offsets.size() - 1)]);
+}
+
+bool TableReader::readFromFile(Block* block) {
+    if (need_seek) {
+        positionAtNextBlock();
+    }
+
+    if (compressed) {
+        // 프레임 위치 기록 (버퍼 풀 적중 뒤 이동에 사용)
+        if (frame_offsets.size() == next_block) {
+            frame_offsets.push_back(logical_pos);
+        }
+
+        // 프레임 헤더: [compressed_size][raw_size][codec]
+        char header[COMPRESSED_FRAME_HEADER_SIZE];
+        if (!readPhysical(header, sizeof(header))) {
+            return false;
+        }
+
+        uint32_t compressed_size, raw_size;
+        std::memcpy(&compressed_size, header, sizeof(uint32_t));
+        std::memcpy(&raw_size, header + sizeof(uint32_t), sizeof(uint32_t));
+        CompressionCodec codec = static_cast<CompressionCodec>(header[2 * sizeof(uint32_t)]);
+
+        if (raw_size != block->getSize()) {
+            throw std::runtime_error("Compressed page size mismatch in " + filename);
+        }
+
+        frame.resize(compressed_size);
+        if (compressed_size > 0 && !readPhysical(frame.data(), compressed_size)) {
+            throw std::runtime_error("Truncated compressed frame in " + filename);
+        }
+
+        // 버퍼 프레임(block)으로 바로 복원
+        decompressPage(codec, frame.data(), compressed_size, block->getData(), raw_size);
+        block->setUsedSize(raw_size);
+        next_block++;
+
+        if (Statistics* counters = stats.get()) {
+            counters->block_reads++;
+        }
+        return true;
+    }
+
+    if (file.eof()) {
         return false;
     }
 
@@ -199,31 +666,307 @@ bool TableReader::readBlock(Block* block) {
 
     // 실제로 읽은 바이트 수를 used_size로 설정
     block->setUsedSize(static_cast<size_t>(bytes_read));
+    next_block++;
 
-    if (stats) {
-        stats->block_reads++;
+    if (Statistics* counters = stats.get()) {
+        counters->block_reads++;
+        counters->physical_block_reads++;
     }
 
     return true;
 }
 
 void TableReader::reset() {
-    file.clear();
-    file.seekg(0, std::ios::beg);
+    seekTo(data_start);
+    next_block = 0;
+    need_seek = false;
+
+    if (compressed) {
+        // 파일 헤더 건너뛰기 (첫 물리 블록에 포함)
+        char header[COMPRESSED_FILE_HEADER_SIZE];
+        readPhysical(header, sizeof(header));
+    }
+}
+
+void TableReader::seekBlock(size_t index) {
+    if (index == next_block && !need_seek) {
+        return;
+    }
+
+    // 실제 이동은 다음 파일 읽기에서 (버퍼 풀 적중이면 이동하지 않음)
+    next_block = index;
+    need_seek = true;
 }
 
 // TableWriter 구현
-TableWriter::TableWriter(const std::string& fname, Statistics* st)
-    : filename(fname), stats(st) {
+
+// 행 페이지에서 레코드가 차지한 바이트 수 (record_size 0에서 끝)
+static size_t rowPageUsedSize(const Block* block) {
+    const char* data = block->getData();
+    size_t pos = 0;
+    while (pos + sizeof(uint32_t) <= block->getSize()) {
+        uint32_t record_size;
+        std::memcpy(&record_size, data + pos, sizeof(uint32_t));
+        if (record_size == 0 || pos + sizeof(uint32_t) + record_size > block->getSize()) {
+            break;
+        }
+        pos += sizeof(uint32_t) + record_size;
+    }
+    return pos;
+}
+
+// 파일을 size 바이트로 줄임
+static void truncateFile(const std::string& path, uint64_t size) {
+#ifdef _WIN32
+    int fd = -1;
+    if (_sopen_s(&fd, path.c_str(), _O_RDWR | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE) != 0) {
+        throw std::runtime_error("Failed to truncate file: " + path);
+    }
+    int result = _chsize_s(fd, static_cast<__int64>(size));
+    _close(fd);
+    if (result != 0) {
+        throw std::runtime_error("Failed to truncate file: " + path);
+    }
+#else
+    if (truncate(path.c_str(), static_cast<off_t>(size)) != 0) {
+        throw std::runtime_error("Failed to truncate file: " + path);
+    }
+#endif
+}
+
+// 블록 안의 레코드 개수 (행/PAX 페이지)
+static size_t countBlockRecords(const Block* block) {
+    if (PaxPage::isPaxPage(block)) {
+        return PaxPage(block).getRecordCount();
+    }
+
+    size_t count = 0;
+    RecordReader reader(block);
+    while (reader.hasNext()) {
+        reader.readNextView();
+        count++;
+    }
+    return count;
+}
+TableWriter::TableWriter(const std::string& fname, StatisticsRef st, bool compress_pages,
+                         bool append_mode)
+    : filename(fname), stats(st), compress(compress_pages), header_written(false),
+      bytes_written(0), physical_block_size(0), codec_counts{0, 0, 0, 0},
+      zone_map_valid(true), closed(false),
+      append(append_mode), tail_pending(false), original_size(0) {
+    if (append) {
+        openForAppend();
+        return;
+    }
+
     file.open(filename, std::ios::binary | std::ios::trunc);
     if (!file.is_open()) {
         throw std::runtime_error("Failed to open file: " + filename);
     }
+
+    // 헤더 자리 확보 (COMPLETE 플래그 없이 기록, close()에서 확정)
+    header.write_id = newWriteId();
+    if (compress) {
+        header.flags |= FILE_FLAG_COMPRESSED;
+    }
+    char buf[FILE_HEADER_SIZE];
+    header.serialize(buf);
+    file.write(buf, FILE_HEADER_SIZE);
+}
+
+void TableWriter::openForAppend() {
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    original_size = static_cast<uint64_t>(in.tellg());
+    in.seekg(0, std::ios::beg);
+
+    if (!readFileHeader(in, header) || !header.isComplete()) {
+        throw std::runtime_error("Cannot append to " + filename +
+                                 ": missing or incomplete file header");
+    }
+    compress = header.hasFlag(FILE_FLAG_COMPRESSED);
+    bytes_written = original_size - FILE_HEADER_SIZE;
+    header_written = compress && bytes_written > 0;
+    physical_block_size = header.block_size;
+
+    // 존 맵은 블록 수가 맞을 때만 이어서 관리 (아니면 닫을 때 제거)
+    std::unique_ptr<ZoneMap> existing = ZoneMap::loadIfExists(filename);
+    if (existing && existing->size() == header.block_count) {
+        zone_map = *existing;
+    } else if (header.block_count > 0) {
+        zone_map_valid = false;
+    }
+
+    // 마지막 페이지 읽기
+    if (header.block_count > 0) {
+        uint64_t last = header.last_block_offset;
+        if (last == 0) {
+            if (compress) {
+                throw std::runtime_error("Cannot append to " + filename +
+                                         ": last block offset unknown");
+            }
+            last = FILE_HEADER_SIZE + (header.block_count - 1) * header.block_size;
+        }
+
+        tail.reset(new Block(header.block_size));
+        in.clear();
+        in.seekg(static_cast<std::streamoff>(last), std::ios::beg);
+
+        if (compress) {
+            char frame_header[COMPRESSED_FRAME_HEADER_SIZE];
+            in.read(frame_header, sizeof(frame_header));
+            uint32_t compressed_size, raw_size;
+            std::memcpy(&compressed_size, frame_header, sizeof(uint32_t));
+            std::memcpy(&raw_size, frame_header + sizeof(uint32_t), sizeof(uint32_t));
+            CompressionCodec codec =
+                static_cast<CompressionCodec>(frame_header[2 * sizeof(uint32_t)]);
+
+            std::vector<char> payload(compressed_size);
+            in.read(payload.data(), compressed_size);
+            if (!in || raw_size != header.block_size) {
+                throw std::runtime_error("Corrupt last frame in " + filename);
+            }
+            decompressPage(codec, payload.data(), compressed_size, tail->getData(), raw_size);
+        } else {
+            in.read(tail->getData(), header.block_size);
+            if (!in) {
+                throw std::runtime_error("Truncated last block in " + filename);
+            }
+        }
+
+        if (PaxPage::isPaxPage(tail.get())) {
+            // PAX 페이지는 이어 채우지 않고 뒤에 새 페이지 추가
+            tail.reset();
+        } else {
+            // 마지막 페이지는 다시 쓰므로 개수와 존 맵에서 제외
+            tail->setUsedSize(rowPageUsedSize(tail.get()));
+            header.block_count--;
+            header.record_count -= countBlockRecords(tail.get());
+            if (zone_map_valid) {
+                zone_map.removeLast();
+            }
+            bytes_written = last - FILE_HEADER_SIZE;
+            tail_pending = true;
+        }
+    }
+
+    file.open(filename, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    file.seekp(static_cast<std::streamoff>(FILE_HEADER_SIZE + bytes_written), std::ios::beg);
+}
+
+bool TableWriter::takeTail(Block& block) {
+    if (!tail_pending) {
+        return false;
+    }
+    if (block.getSize() != tail->getSize()) {
+        throw std::runtime_error("Block size mismatch for " + filename + ": file uses " +
+                                 std::to_string(tail->getSize()) + " bytes");
+    }
+
+    block.clear();
+    std::memcpy(block.getData(), tail->getData(), tail->getUsedSize());
+    block.setUsedSize(tail->getUsedSize());
+    tail.reset();
+    tail_pending = false;
+    return true;
+}
+
+void TableWriter::setDictionaryEncoded(bool encoded) {
+    if (encoded) {
+        header.flags |= FILE_FLAG_DICTIONARY;
+    } else {
+        header.flags &= ~FILE_FLAG_DICTIONARY;
+    }
 }
 
 TableWriter::~TableWriter() {
+    try {
+        close();
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: " << e.what() << std::endl;
+    }
+}
+
+void TableWriter::close() {
+    if (closed) {
+        return;
+    }
+    closed = true;
+
+    // 가져가지 않은 마지막 페이지는 그대로 다시 기록
+    if (tail_pending && file.is_open()) {
+        tail_pending = false;
+        writeBlock(tail.get());
+    }
+
     if (file.is_open()) {
+        // 헤더 확정: 개수와 정렬 여부는 쓴 블록들로부터 계산
+        header.flags |= FILE_FLAG_COMPLETE;
+        header.flags &= ~FILE_FLAG_SORTED;
+        if (zone_map_valid && !zone_map.empty() && zone_map.isSorted()) {
+            header.flags |= FILE_FLAG_SORTED;
+        }
+
+        char buf[FILE_HEADER_SIZE];
+        header.serialize(buf);
+        file.seekp(0, std::ios::beg);
+        file.write(buf, FILE_HEADER_SIZE);
         file.close();
+
+        // 다시 쓴 마지막 압축 프레임이 더 짧아졌으면 남은 바이트 제거
+        uint64_t file_end = FILE_HEADER_SIZE + bytes_written;
+        if (append && original_size > file_end) {
+            truncateFile(filename, file_end);
+        }
+    }
+
+    // 모든 블록의 키 범위를 구했을 때만 존 맵 저장 (아니면 오래된 사이드카 제거)
+    if (zone_map_valid && !zone_map.empty()) {
+        zone_map.save(filename);
+    } else {
+        ZoneMap::remove(filename);
+    }
+
+    // 내용이 바뀌었으므로 통계 사이드카는 버림 (다시 --analyze)
+    std::remove(TableStats::sidecarPath(filename).c_str());
+
+    // 딕셔너리 인코딩으로 쓰지 않았으면 이전 실행의 딕셔너리 사이드카 제거
+    if (!header.hasFlag(FILE_FLAG_DICTIONARY)) {
+        PartDictionary::remove(filename);
+    }
+}
+
+size_t TableWriter::memoryBytes() const {
+    return TABLE_STREAM_BUFFER_BYTES + compressed_page.capacity() +
+           zone_map.capacity() * sizeof(ZoneEntry) + (tail ? tail->getSize() : 0);
+}
+
+size_t TableWriter::writeGrowthBytes() const {
+    if (!zone_map_valid || zone_map.size() < zone_map.capacity()) {
+        return 0;
+    }
+    return std::max<size_t>(zone_map.capacity() * 2, 1) * sizeof(ZoneEntry);
+}
+
+void TableWriter::dropZoneMap() {
+    zone_map_valid = false;
+    ZoneMap().swap(zone_map);
+}
+
+void TableWriter::accountPhysicalWrite(size_t bytes) {
+    size_t before = bytes_written;
+    bytes_written += bytes;
+
+    Statistics* counters = stats.get();
+    if (counters && physical_block_size > 0) {
+        size_t blocks_before = (before + physical_block_size - 1) / physical_block_size;
+        size_t blocks_after = (bytes_written + physical_block_size - 1) / physical_block_size;
+        counters->physical_block_writes += blocks_after - blocks_before;
     }
 }
 
@@ -232,73 +975,229 @@ bool TableWriter::writeBlock(const Block* block) {
         return false;
     }
 
-    // 사용된 크기만큼만 쓰기
-    file.write(block->getData(), block->getUsedSize());
+    // 추가 쓰기: 이어 채울 페이지를 가져가지 않았으면 먼저 다시 기록
+    if (tail_pending) {
+        tail_pending = false;
+        writeBlock(tail.get());
+    }
+    PHASE_TIMER(stats.get(), TimerPhase::WRITE);
+    TRACE_SPAN("write block", "io");
+
+    // 첫 블록에서 블록 크기와 레이아웃 기록
+    if (header.block_count == 0) {
+        header.block_size = static_cast<uint32_t>(block->getSize());
+        if (PaxPage::isPaxPage(block)) {
+            header.flags |= FILE_FLAG_PAX;
+        }
+    }
 
-    if (stats) {
-        stats->block_writes++;
+    // 블록 위치 (파일 헤더와 압축 파일 헤더만큼 오프셋 보정)
+    uint64_t offset = FILE_HEADER_SIZE + bytes_written;
+    if (compress && !header_written) {
+        offset += COMPRESSED_FILE_HEADER_SIZE;
+    }
+    header.last_block_offset = offset;
+
+    // 존 맵 항목 기록
+    ZoneEntry entry;
+    bool has_entry = false;
+    if (zone_map_valid) {
+        has_entry = ZoneMap::computeEntry(block, offset, entry);
+        if (has_entry) {
+            zone_map.add(entry);
+        } else {
+            zone_map_valid = false;
+        }
+    }
+
+    header.block_count++;
+    header.record_count += has_entry ? entry.record_count : countBlockRecords(block);
+
+    if (compress) {
+        // 첫 블록에서 파일 헤더 기록 (물리 블록 크기 = 논리 블록 크기)
+        if (!header_written) {
+            physical_block_size = block->getSize();
+            uint32_t magic = COMPRESSED_FILE_MAGIC;
+            uint32_t logical_block_size = static_cast<uint32_t>(block->getSize());
+            file.write(reinterpret_cast<const char*>(&magic), sizeof(uint32_t));
+            file.write(reinterpret_cast<const char*>(&logical_block_size), sizeof(uint32_t));
+            accountPhysicalWrite(COMPRESSED_FILE_HEADER_SIZE);
+            header_written = true;
+        } else if (block->getSize() != physical_block_size) {
+            throw std::runtime_error("Block size changed while writing " + filename);
+        }
+
+        CompressionCodec codec = compressPage(block->getData(), block->getSize(), compressed_page);
+        codec_counts[static_cast<size_t>(codec)]++;
+
+        char header[COMPRESSED_FRAME_HEADER_SIZE];
+        uint32_t compressed_size = static_cast<uint32_t>(compressed_page.size());
+        uint32_t raw_size = static_cast<uint32_t>(block->getSize());
+        std::memcpy(header, &compressed_size, sizeof(uint32_t));
+        std::memcpy(header + sizeof(uint32_t), &raw_size, sizeof(uint32_t));
+        header[2 * sizeof(uint32_t)] = static_cast<char>(codec);
+
+        file.write(header, sizeof(header));
+        file.write(compressed_page.data(), compressed_page.size());
+        accountPhysicalWrite(sizeof(header) + compressed_page.size());
+
+        if (Statistics* counters = stats.get()) {
+            counters->block_writes++;
+        }
+        return file.good();
+    }
+
+    // 블록 전체 크기로 쓰기 (남는 공간은 clear()로 0 채움)
+    // TableReader가 block_size 단위로 읽으므로 파일 내 블록 경계가 맞아야 함
+    file.write(block->getData(), block->getSize());
+    bytes_written += block->getSize();
+
+    if (Statistics* counters = stats.get()) {
+        counters->block_writes++;
+        counters->physical_block_writes++;
     }
 
     return file.good();
 }
 
-// CSV를 블록 파일로 변환
-void convertCSVToBlocks(const std::string& csv_file,
-                        const std::string& block_file,
-                        const std::string& table_type,
-                        size_t block_size) {
-    std::ifstream input(csv_file);
-    if (!input.is_open()) {
-        throw std::runtime_error("Failed to open CSV file: " + csv_file);
+void TableWriter::printCompressionSummary() const {
+    if (!compress) {
+        return;
     }
 
-    TableWriter writer(block_file, nullptr);
-    Block block(block_size);
-    RecordWriter rec_writer(&block);
+    size_t pages = 0;
+    for (size_t count : codec_counts) {
+        pages += count;
+    }
+    size_t logical_bytes = pages * physical_block_size;
+    size_t physical_blocks = physical_block_size > 0
+        ? (bytes_written + physical_block_size - 1) / physical_block_size : 0;
 
-    std::string line;
-    int record_count = 0;
+    std::cout << "Compression: " << pages << " logical blocks -> " << physical_blocks
+              << " physical blocks (" << bytes_written << " / " << logical_bytes << " bytes";
+    if (logical_bytes > 0) {
+        std::cout << ", ratio " << (static_cast<double>(logical_bytes) / bytes_written) << "x";
+    }
+    std::cout << ")" << std::endl;
+    std::cout << "Codecs: ";
+    for (size_t i = 0; i < 4; ++i) {
+        std::cout << getCodecName(static_cast<CompressionCodec>(i)) << "=" << codec_counts[i]
+                  << (i + 1 < 4 ? ", " : "\n");
+    }
+}
+
+// CSV를 블록 파일로 변환
+// ============================================================================
+// RecordStaging 구현
+// ============================================================================
+
+// 스테이징 블록 최소 크기 (출력 블록보다 크게 잡아 복사 횟수를 줄임)
+static const size_t STAGING_RUN_SIZE = 256 * 1024;
 
-    while (std::getline(input, line)) {
-        if (line.empty()) continue;
+RecordStaging::RecordStaging(size_t blk_size, RecordEncoding enc)
+    : run_size(std::max(STAGING_RUN_SIZE, blk_size)), encoding(enc) {}
 
-        try {
-            Record record;
+size_t RecordStaging::drainTo(Block& block, TableWriter& writer, size_t& oversized) {
+    size_t added = 0;
 
-            if (table_type == "PART") {
-                PartRecord part = PartRecord::fromCSV(line);
-                record = part.toRecord();
-            } else if (table_type == "PARTSUPP") {
-                PartSuppRecord partsupp = PartSuppRecord::fromCSV(line);
-                record = partsupp.toRecord();
-            } else {
-                throw std::runtime_error("Unknown table type: " + table_type);
+    for (const auto& run : runs) {
+        const char* data = run->getData();
+        size_t used = run->getUsedSize();
+        size_t offset = 0;
+
+        while (offset + sizeof(uint32_t) <= used) {
+            uint32_t record_size;
+            std::memcpy(&record_size, data + offset, sizeof(uint32_t));
+            size_t entry_size = sizeof(uint32_t) + record_size;
+
+            if (entry_size > block.getSize()) {
+                oversized++;
+                offset += entry_size;
+                continue;
             }
 
-            // 블록에 레코드 쓰기
-            if (!rec_writer.writeRecord(record)) {
-                // 블록이 가득 차면 디스크에 쓰고 새 블록 시작
+            // RecordBuilder와 같은 채우기 규칙: 남은 공간에 들어가지 않으면 새 블록
+            if (block.getUsedSize() + entry_size > block.getSize()) {
                 writer.writeBlock(&block);
                 block.clear();
-
-                // 새 블록에 레코드 쓰기
-                if (!rec_writer.writeRecord(record)) {
-                    throw std::runtime_error("Record too large for block");
-                }
             }
 
-            record_count++;
-        } catch (const std::exception& e) {
-            std::cerr << "Error parsing line: " << line << "\nError: " << e.what() << std::endl;
+            std::memcpy(block.getData() + block.getUsedSize(), data + offset, entry_size);
+            block.setUsedSize(block.getUsedSize() + entry_size);
+            offset += entry_size;
+            added++;
         }
     }
 
-    // 마지막 블록 쓰기
-    if (!block.isEmpty()) {
-        writer.writeBlock(&block);
+    runs.clear();
+    return added;
+}
+
+void convertCSVToBlocks(const std::string& csv_file,
+                        const std::string& block_file,
+                        const std::string& table_type,
+                        size_t block_size,
+                        RecordEncoding encoding,
+                        bool dictionary_encode,
+                        bool compress,
+                        size_t num_threads,
+                        bool append) {
+    if (dictionary_encode && table_type != "PART") {
+        throw std::runtime_error("Dictionary encoding is only supported for PART");
+    }
+
+    TableWriter writer(block_file, nullptr, compress, append);
+
+    std::unique_ptr<PartDictionary> dict;
+    if (append) {
+        // 기존 파일의 테이블 정보를 그대로 사용
+        const FileHeader& existing = writer.getHeader();
+        if (existing.table_type != table_type) {
+            throw std::runtime_error("Cannot append " + table_type + " records to " +
+                                     existing.table_type + " file: " + block_file);
+        }
+        if (existing.block_count > 0) {
+            block_size = existing.block_size;
+        }
+        encoding = static_cast<RecordEncoding>(existing.record_encoding);
+
+        if (existing.hasFlag(FILE_FLAG_DICTIONARY)) {
+            // 기존 코드는 유지하고 새 값만 코드를 추가로 할당
+            dict = PartDictionary::loadIfExists(block_file);
+            if (!dict) {
+                throw std::runtime_error("Dictionary sidecar missing: " +
+                                         PartDictionary::sidecarPath(block_file));
+            }
+        } else if (dictionary_encode) {
+            throw std::runtime_error("Cannot append dictionary-encoded records to " + block_file);
+        }
+    } else {
+        writer.setTableType(table_type);
+        writer.setRecordEncoding(encoding);
+        writer.setDictionaryEncoded(dictionary_encode);
+
+        // 딕셔너리는 변환하면서 구축하고 마지막에 사이드카로 저장
+        if (dictionary_encode) {
+            dict.reset(new PartDictionary());
+        }
     }
 
-    input.close();
-    std::cout << "Converted " << record_count << " records from " << csv_file
-              << " to " << block_file << std::endl;
+    // 청크 단위 병렬 파싱 후 입력 순서대로 블록 기록
+    CsvLoader loader(table_type, block_size, encoding, num_threads);
+    loader.setDictionary(dict.get());
+    size_t record_count = loader.load(csv_file, writer);
+
+    std::cout << (append ? "Appended " : "Converted ") << record_count << " records from "
+              << csv_file << " to " << block_file << " (" << loader.getThreadCount()
+              << " threads)" << std::endl;
+    writer.printCompressionSummary();
+
+    if (dict) {
+        dict->save(block_file);
+        std::cout << "Dictionary: mfgr=" << dict->getColumn(2).size()
+                  << ", brand=" << dict->getColumn(3).size()
+                  << ", type=" << dict->getColumn(4).size()
+                  << ", container=" << dict->getColumn(6).size()
+                  << " values -> " << PartDictionary::sidecarPath(block_file) << std::endl;
+    }
 }
@@ -0,0 +1,635 @@
+#include "table_stats.h"
+#include "table.h"
+#include "record.h"
+#include "dictionary.h"
+#include "pax.h"
+#include "join.h"
+#include "trace.h"
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <unordered_map>
+#include <thread>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+// ============================================================================
+// 해시와 HyperLogLog
+// ============================================================================
+
+// splitmix64 마무리 단계: 비트를 고르게 섞음
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t hashBytes(const char* data, size_t size, uint64_t seed) {
+    // FNV-1a 후 섞기
+    uint64_t h = 0xcbf29ce484222325ULL ^ seed;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 0x100000001b3ULL;
+    }
+    return mix64(h);
+}
+
+void HyperLogLog::add(uint64_t hash) {
+    // 상위 p비트로 레지스터 선택, 나머지 비트의 선행 0 개수 + 1 기록
+    size_t index = static_cast<size_t>(hash >> (64 - STATS_HLL_PRECISION));
+    uint64_t rest = hash << STATS_HLL_PRECISION;
+    uint8_t rank = 1;
+    while (rank <= 64 - STATS_HLL_PRECISION && (rest & 0x8000000000000000ULL) == 0) {
+        rank++;
+        rest <<= 1;
+    }
+    if (rank > registers[index]) {
+        registers[index] = rank;
+    }
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    for (size_t i = 0; i < registers.size(); ++i) {
+        registers[i] = std::max(registers[i], other.registers[i]);
+    }
+}
+
+double HyperLogLog::estimate() const {
+    double m = static_cast<double>(registers.size());
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t r : registers) {
+        sum += std::ldexp(1.0, -static_cast<int>(r));
+        if (r == 0) zeros++;
+    }
+    double raw = alpha * m * m / sum;
+
+    // 작은 범위: 빈 레지스터 비율로 선형 계수
+    if (raw <= 2.5 * m && zeros > 0) {
+        return m * std::log(m / static_cast<double>(zeros));
+    }
+    return raw;
+}
+
+// ============================================================================
+// 스레드별 부분 통계
+// ============================================================================
+namespace {
+
+struct ColumnAccumulator {
+    uint64_t count = 0;
+    uint64_t nulls = 0;
+    uint64_t bytes = 0;
+    bool has_value = false;
+    double min_num = 0;
+    double max_num = 0;
+    std::string min_str;
+    std::string max_str;
+    HyperLogLog hll;
+};
+
+struct SampleRow {
+    uint64_t hash;
+    std::vector<std::string> fields;
+};
+
+bool sampleLess(const SampleRow& a, const SampleRow& b) { return a.hash < b.hash; }
+
+struct PartialStats {
+    std::vector<ColumnAccumulator> columns;
+    std::vector<SampleRow> sample;                     // hash 기준 최대 힙
+    std::unordered_map<std::string, uint64_t> heavy;   // Misra-Gries 카운터
+    uint64_t records = 0;
+};
+
+void addHeavy(std::unordered_map<std::string, uint64_t>& heavy, const std::string& key) {
+    auto it = heavy.find(key);
+    if (it != heavy.end()) {
+        it->second++;
+        return;
+    }
+    if (heavy.size() < STATS_HEAVY_COUNTERS) {
+        heavy.emplace(key, 1);
+        return;
+    }
+    // 카운터가 가득 차면 모두 1씩 줄이고 0이 된 값 제거
+    for (auto entry = heavy.begin(); entry != heavy.end();) {
+        if (--entry->second == 0) {
+            entry = heavy.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+}
+
+// 합친 카운터가 STATS_HEAVY_COUNTERS개를 넘으면 (k+1)번째 값만큼 빼서 줄임
+void mergeHeavy(std::unordered_map<std::string, uint64_t>& into,
+                const std::unordered_map<std::string, uint64_t>& other) {
+    for (const auto& entry : other) {
+        into[entry.first] += entry.second;
+    }
+    if (into.size() <= STATS_HEAVY_COUNTERS) {
+        return;
+    }
+
+    std::vector<uint64_t> counts;
+    for (const auto& entry : into) counts.push_back(entry.second);
+    std::nth_element(counts.begin(), counts.begin() + STATS_HEAVY_COUNTERS, counts.end(),
+                     std::greater<uint64_t>());
+    uint64_t cut = counts[STATS_HEAVY_COUNTERS];
+
+    for (auto entry = into.begin(); entry != into.end();) {
+        if (entry->second <= cut) {
+            entry = into.erase(entry);
+        } else {
+            entry->second -= cut;
+            ++entry;
+        }
+    }
+}
+
+double parseNumber(const std::string& text) {
+    return std::strtod(text.c_str(), nullptr);
+}
+
+// [first_block, last_block) 범위 읽기
+void analyzeRange(const std::string& block_file, size_t block_size,
+                  const std::vector<ColumnType>& schema, const PartDictionary* dict,
+                  size_t first_block, size_t last_block, PartialStats& partial,
+                  StatisticsRef io) {
+    partial.columns.resize(schema.size());
+
+    TableReader reader(block_file, block_size, io);
+    reader.seekBlock(first_block);
+    Block block(block_size);
+    std::string value;
+    std::string scratch;
+
+    for (size_t index = first_block; index < last_block && reader.readBlock(&block); ++index) {
+        // PAX 페이지는 행을 복원하지 않고 컬럼 접근자로 값만 읽음
+        std::unique_ptr<PaxPage> page;
+        if (PaxPage::isPaxPage(&block)) {
+            page.reset(new PaxPage(&block));
+        }
+        RecordReader rec_reader(&block);
+        uint64_t row = 0;
+
+        while (page ? row < page->getRecordCount() : rec_reader.hasNext()) {
+            RecordView view;
+            size_t fields;
+            if (page) {
+                fields = std::min(page->getColumnCount(), schema.size());
+            } else {
+                view = rec_reader.readNextView();
+                fields = std::min(view.getFieldCount(), schema.size());
+            }
+            uint64_t current_row = row++;
+
+            // 표본 후보 여부 (행 위치 해시가 현재 표본의 최댓값보다 작으면)
+            uint64_t row_hash = mix64((static_cast<uint64_t>(index) << 32) | current_row);
+            bool sampled = partial.sample.size() < STATS_SAMPLE_SIZE ||
+                           row_hash < partial.sample.front().hash;
+            SampleRow sample_row;
+            if (sampled) {
+                sample_row.hash = row_hash;
+                sample_row.fields.resize(schema.size());
+            }
+
+            for (size_t c = 0; c < fields; ++c) {
+                FieldRef field = page ? page->getFieldText(c, current_row, scratch) : view.getField(c);
+                ColumnAccumulator& acc = partial.columns[c];
+                if (field.size == 0) {
+                    acc.nulls++;
+                    continue;
+                }
+
+                // 딕셔너리 코드는 문자열로 복원해 통계 계산
+                if (dict && PartDictionary::isEncodedColumn(c)) {
+                    value = dict->getColumn(c).decode(PartDictionary::fieldToCode(field.data, field.size));
+                } else {
+                    value.assign(field.data, field.size);
+                }
+
+                acc.count++;
+                acc.bytes += value.size();
+                acc.hll.add(hashBytes(value.data(), value.size()));
+
+                if (schema[c] != ColumnType::STRING) {
+                    double number = parseNumber(value);
+                    if (!acc.has_value || number < acc.min_num) { acc.min_num = number; acc.min_str = value; }
+                    if (!acc.has_value || number > acc.max_num) { acc.max_num = number; acc.max_str = value; }
+                } else {
+                    if (!acc.has_value || value < acc.min_str) acc.min_str = value;
+                    if (!acc.has_value || value > acc.max_str) acc.max_str = value;
+                }
+                acc.has_value = true;
+
+                if (c == 0) {
+                    addHeavy(partial.heavy, value);
+                }
+                if (sampled) {
+                    sample_row.fields[c] = value;
+                }
+            }
+
+            if (sampled) {
+                if (partial.sample.size() >= STATS_SAMPLE_SIZE) {
+                    std::pop_heap(partial.sample.begin(), partial.sample.end(), sampleLess);
+                    partial.sample.pop_back();
+                }
+                partial.sample.push_back(std::move(sample_row));
+                std::push_heap(partial.sample.begin(), partial.sample.end(), sampleLess);
+            }
+            partial.records++;
+        }
+    }
+}
+
+std::vector<std::string> columnNames(const std::string& table_type) {
+    if (table_type != "JOIN") {
+        return getTableColumnNames(table_type);
+    }
+    // 조인 결과: TPC-H 접두사로 구분
+    std::vector<std::string> names;
+    for (const auto& name : getTableColumnNames("PART")) names.push_back("p_" + name);
+    for (const auto& name : getTableColumnNames("PARTSUPP")) names.push_back("ps_" + name);
+    return names;
+}
+
+} // namespace
+
+// ============================================================================
+// ANALYZE
+// ============================================================================
+TableStats TableStats::analyze(const std::string& block_file, const std::string& table_type,
+                               size_t block_size, size_t num_threads, Statistics* io_stats) {
+    const std::vector<ColumnType>& schema = getTableSchema(table_type);
+    std::vector<std::string> names = columnNames(table_type);
+    std::unique_ptr<PartDictionary> dict;
+    if (table_type == "PART") {
+        dict = PartDictionary::loadIfExists(block_file);
+    }
+
+    size_t block_count = countTableBlocks(block_file, block_size);
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = std::max<size_t>(1, std::min(num_threads,
+                                               block_count / STATS_MIN_BLOCKS_PER_THREAD));
+
+    // 블록 범위를 스레드별로 나눠 읽음 (I/O 카운터는 스레드별 샤드에 세고 끝나면 합침)
+    std::vector<PartialStats> partials(num_threads);
+    StatisticsShards io_shards(io_stats);
+    std::vector<std::thread> workers;
+    std::vector<std::string> errors(num_threads);
+    size_t per_thread = (block_count + num_threads - 1) / num_threads;
+
+    for (size_t t = 0; t < num_threads; ++t) {
+        size_t first = std::min(block_count, t * per_thread);
+        size_t last = std::min(block_count, first + per_thread);
+        // 마지막 스레드는 끝까지 (헤더가 없는 파일의 블록 수가 틀려도 모두 읽음)
+        if (t + 1 == num_threads) last = SIZE_MAX;
+
+        workers.emplace_back([&, t, first, last]() {
+            TRACE_SPAN("analyze range", "analyze");
+            try {
+                analyzeRange(block_file, block_size, schema, dict.get(), first, last, partials[t],
+                             &io_shards);
+            } catch (const std::exception& e) {
+                errors[t] = e.what();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    io_shards.merge();
+    for (const auto& error : errors) {
+        if (!error.empty()) {
+            throw std::runtime_error("Analyze failed: " + error);
+        }
+    }
+
+    // ========== 부분 통계 병합 ==========
+    PartialStats merged;
+    merged.columns.resize(schema.size());
+    for (auto& partial : partials) {
+        merged.records += partial.records;
+        for (size_t c = 0; c < partial.columns.size(); ++c) {
+            ColumnAccumulator& into = merged.columns[c];
+            const ColumnAccumulator& from = partial.columns[c];
+            into.count += from.count;
+            into.nulls += from.nulls;
+            into.bytes += from.bytes;
+            into.hll.merge(from.hll);
+            if (!from.has_value) continue;
+
+            if (schema[c] != ColumnType::STRING) {
+                if (!into.has_value || from.min_num < into.min_num) { into.min_num = from.min_num; into.min_str = from.min_str; }
+                if (!into.has_value || from.max_num > into.max_num) { into.max_num = from.max_num; into.max_str = from.max_str; }
+            } else {
+                if (!into.has_value || from.min_str < into.min_str) into.min_str = from.min_str;
+                if (!into.has_value || from.max_str > into.max_str) into.max_str = from.max_str;
+            }
+            into.has_value = true;
+        }
+        mergeHeavy(merged.heavy, partial.heavy);
+        for (auto& row : partial.sample) {
+            merged.sample.push_back(std::move(row));
+        }
+    }
+
+    // 표본: 전체에서 해시가 가장 작은 STATS_SAMPLE_SIZE개 (한 스레드로 읽은 것과 같음)
+    std::sort(merged.sample.begin(), merged.sample.end(), sampleLess);
+    if (merged.sample.size() > STATS_SAMPLE_SIZE) {
+        merged.sample.resize(STATS_SAMPLE_SIZE);
+    }
+
+    // ========== 결과 구성 ==========
+    TableStats result;
+    result.table_type = table_type;
+    result.record_count = merged.records;
+    result.block_count = block_count;
+
+    for (size_t c = 0; c < schema.size(); ++c) {
+        const ColumnAccumulator& acc = merged.columns[c];
+        ColumnStats column;
+        column.name = c < names.size() ? names[c] : "col" + std::to_string(c);
+        column.type = schema[c];
+        column.count = acc.count;
+        column.null_count = acc.nulls;
+        column.total_bytes = acc.bytes;
+        column.distinct = std::min<uint64_t>(acc.count,
+                                             static_cast<uint64_t>(std::llround(acc.hll.estimate())));
+        column.min_value = acc.min_str;
+        column.max_value = acc.max_str;
+
+        // 등깊이 히스토그램: 표본 값을 정렬해 분위수 경계 선택 (양 끝은 실제 최소/최대)
+        std::vector<std::string> values;
+        for (const auto& row : merged.sample) {
+            if (!row.fields[c].empty()) values.push_back(row.fields[c]);
+        }
+        if (!values.empty()) {
+            if (schema[c] != ColumnType::STRING) {
+                std::sort(values.begin(), values.end(), [](const std::string& a, const std::string& b) {
+                    return parseNumber(a) < parseNumber(b);
+                });
+            } else {
+                std::sort(values.begin(), values.end());
+            }
+            size_t buckets = std::min<size_t>(STATS_HISTOGRAM_BUCKETS, values.size());
+            for (size_t b = 0; b <= buckets; ++b) {
+                column.histogram.push_back(values[b * (values.size() - 1) / buckets]);
+            }
+            column.histogram.front() = acc.min_str;
+            column.histogram.back() = acc.max_str;
+        }
+
+        if (c == 0) {
+            // 평균 빈도의 STATS_HEAVY_MIN_RATIO배를 넘는 것이 확실한 값만 빈발 값으로 남김
+            // (균등 분포면 카운터에 남은 값은 의미가 없음)
+            double average = column.distinct > 0 ? double(column.count) / double(column.distinct) : 0.0;
+            for (const auto& entry : merged.heavy) {
+                if (double(entry.second) > STATS_HEAVY_MIN_RATIO * average) {
+                    column.heavy_hitters.push_back(HeavyHitter{entry.first, entry.second});
+                }
+            }
+            std::sort(column.heavy_hitters.begin(), column.heavy_hitters.end(),
+                      [](const HeavyHitter& a, const HeavyHitter& b) {
+                          return a.count != b.count ? a.count > b.count : a.value < b.value;
+                      });
+            if (column.heavy_hitters.size() > STATS_HEAVY_KEPT) {
+                column.heavy_hitters.resize(STATS_HEAVY_KEPT);
+            }
+        }
+
+        result.columns.push_back(column);
+    }
+
+    return result;
+}
+
+double TableStats::averageRecordWidth() const {
+    double width = 0;
+    for (const auto& column : columns) {
+        width += column.averageWidth();
+    }
+    return width;
+}
+
+uint64_t TableStats::heavyHitterCount(size_t column, const std::string& value) const {
+    if (column >= columns.size()) return 0;
+    for (const auto& hitter : columns[column].heavy_hitters) {
+        if (hitter.value == value) return hitter.count;
+    }
+    return 0;
+}
+
+double estimateJoinSize(const TableStats& left, size_t left_col,
+                        const TableStats& right, size_t right_col) {
+    const ColumnStats& l = left.columns.at(left_col);
+    const ColumnStats& r = right.columns.at(right_col);
+
+    // 양쪽 모두 빈발 값인 키는 횟수 곱
+    double size = 0;
+    double matched_left = 0, matched_right = 0, matched_keys = 0;
+    for (const auto& hitter : l.heavy_hitters) {
+        uint64_t right_count = right.heavyHitterCount(right_col, hitter.value);
+        if (right_count == 0) continue;
+        size += double(hitter.count) * double(right_count);
+        matched_left += hitter.count;
+        matched_right += right_count;
+        matched_keys += 1;
+    }
+
+    // 나머지는 균등 분포 가정
+    double rest_left = std::max(0.0, double(l.count) - matched_left);
+    double rest_right = std::max(0.0, double(r.count) - matched_right);
+    double distinct = std::max(1.0, std::max(double(l.distinct), double(r.distinct)) - matched_keys);
+    return size + rest_left * rest_right / distinct;
+}
+
+// ============================================================================
+// 사이드카 저장/로드
+// ============================================================================
+static void writeString(std::ofstream& file, const std::string& value) {
+    uint32_t len = static_cast<uint32_t>(value.size());
+    file.write(reinterpret_cast<const char*>(&len), sizeof(uint32_t));
+    file.write(value.data(), len);
+}
+
+static bool readString(std::ifstream& file, std::string& value) {
+    uint32_t len = 0;
+    if (!file.read(reinterpret_cast<char*>(&len), sizeof(uint32_t))) return false;
+    value.resize(len);
+    return len == 0 || static_cast<bool>(file.read(&value[0], len));
+}
+
+template <typename T>
+static void writeValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool readValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void TableStats::save(const std::string& block_file) const {
+    std::string path = sidecarPath(block_file);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open statistics file: " + path);
+    }
+
+    writeValue<uint32_t>(file, TABLE_STATS_MAGIC);
+    writeValue<uint32_t>(file, TABLE_STATS_VERSION);
+    writeValue(file, record_count);
+    writeValue(file, block_count);
+    writeString(file, table_type);
+    writeValue<uint32_t>(file, static_cast<uint32_t>(columns.size()));
+
+    for (const auto& column : columns) {
+        writeString(file, column.name);
+        writeValue<uint8_t>(file, static_cast<uint8_t>(column.type));
+        writeValue(file, column.count);
+        writeValue(file, column.null_count);
+        writeValue(file, column.total_bytes);
+        writeValue(file, column.distinct);
+        writeString(file, column.min_value);
+        writeString(file, column.max_value);
+
+        uint32_t buckets = column.histogram.empty() ? 0
+                         : static_cast<uint32_t>(column.histogram.size() - 1);
+        writeValue(file, buckets);
+        for (const auto& bound : column.histogram) {
+            writeString(file, bound);
+        }
+
+        writeValue<uint32_t>(file, static_cast<uint32_t>(column.heavy_hitters.size()));
+        for (const auto& hitter : column.heavy_hitters) {
+            writeString(file, hitter.value);
+            writeValue(file, hitter.count);
+        }
+    }
+
+    if (!file.good()) {
+        throw std::runtime_error("Failed to write statistics file: " + path);
+    }
+}
+
+std::unique_ptr<TableStats> TableStats::loadIfExists(const std::string& block_file) {
+    std::string path = sidecarPath(block_file);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    uint32_t magic = 0, version = 0;
+    if (!readValue(file, magic) || magic != TABLE_STATS_MAGIC) {
+        throw std::runtime_error("Invalid statistics file: " + path);
+    }
+    if (!readValue(file, version) || version != TABLE_STATS_VERSION) {
+        throw std::runtime_error("Unsupported statistics file version: " + path);
+    }
+
+    std::unique_ptr<TableStats> stats(new TableStats());
+    uint32_t column_count = 0;
+    bool ok = readValue(file, stats->record_count) && readValue(file, stats->block_count) &&
+              readString(file, stats->table_type) && readValue(file, column_count);
+
+    for (uint32_t c = 0; ok && c < column_count; ++c) {
+        ColumnStats column;
+        uint8_t type = 0;
+        uint32_t buckets = 0, heavy = 0;
+        ok = readString(file, column.name) && readValue(file, type) &&
+             readValue(file, column.count) && readValue(file, column.null_count) &&
+             readValue(file, column.total_bytes) && readValue(file, column.distinct) &&
+             readString(file, column.min_value) && readString(file, column.max_value) &&
+             readValue(file, buckets);
+        column.type = static_cast<ColumnType>(type);
+
+        for (uint32_t b = 0; ok && buckets > 0 && b <= buckets; ++b) {
+            std::string bound;
+            ok = readString(file, bound);
+            column.histogram.push_back(bound);
+        }
+
+        ok = ok && readValue(file, heavy);
+        for (uint32_t h = 0; ok && h < heavy; ++h) {
+            HeavyHitter hitter;
+            ok = readString(file, hitter.value) && readValue(file, hitter.count);
+            column.heavy_hitters.push_back(hitter);
+        }
+        stats->columns.push_back(column);
+    }
+
+    if (!ok) {
+        throw std::runtime_error("Truncated statistics file: " + path);
+    }
+    return stats;
+}
+
+// ============================================================================
+// 출력
+// ============================================================================
+static std::string clip(const std::string& value, size_t width) {
+    return value.size() <= width ? value : value.substr(0, width - 3) + "...";
+}
+
+void TableStats::print(std::ostream& out) const {
+    static const char* type_names[] = {"INT", "DECIMAL", "STRING"};
+
+    out << "\n=== Table Statistics ===" << std::endl;
+    out << "Table Type: " << table_type << std::endl;
+    out << "Records: " << record_count << std::endl;
+    out << "Blocks: " << block_count << std::endl;
+    out << "Average Record Width: " << averageRecordWidth() << " bytes\n" << std::endl;
+
+    out << std::left << std::setw(16) << "Column" << std::setw(9) << "Type"
+        << std::right << std::setw(8) << "Nulls" << std::setw(10) << "Distinct"
+        << std::setw(8) << "Width" << "  " << std::left << std::setw(22) << "Min"
+        << "Max" << std::endl;
+    for (const auto& column : columns) {
+        size_t type = static_cast<size_t>(column.type);
+        out << std::left << std::setw(16) << column.name
+            << std::setw(9) << (type < 3 ? type_names[type] : "?")
+            << std::right << std::setw(8) << column.null_count
+            << std::setw(10) << column.distinct
+            << std::setw(8) << std::fixed << std::setprecision(1) << column.averageWidth()
+            << "  " << std::left << std::setw(22) << clip(column.min_value, 20)
+            << clip(column.max_value, 20) << std::endl;
+        out.unsetf(std::ios::fixed);
+        out << std::setprecision(6) << std::right;
+    }
+
+    // 수치 컬럼 히스토그램
+    for (const auto& column : columns) {
+        if (!column.isNumeric() || column.histogram.empty()) continue;
+        out << "\nHistogram (" << column.name << ", "
+            << column.histogram.size() - 1 << " equi-depth buckets):" << std::endl << " ";
+        for (const auto& bound : column.histogram) {
+            out << " " << bound;
+        }
+        out << std::endl;
+    }
+
+    if (!columns.empty()) {
+        const ColumnStats& key = columns.front();
+        out << "\nHeavy Hitters (" << key.name << "):";
+        if (key.heavy_hitters.empty()) {
+            out << " none";
+        }
+        for (const auto& hitter : key.heavy_hitters) {
+            out << " " << hitter.value << " (>= " << hitter.count << ")";
+        }
+        out << std::endl;
+    }
+}
@@ -0,0 +1,432 @@
+#include "tpch_gen.h"
+#include "dictionary.h"
+#include "trace.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+// 한 스레드가 한 번에 생성하는 부품 수
+static const size_t PARTS_PER_BATCH = 8192;
+
+// 주석 문자열을 잘라낼 텍스트 풀 크기
+static const size_t TEXT_POOL_SIZE = 2 * 1024 * 1024;
+
+// 난수열 구분자
+static const uint64_t STREAM_TEXT = 1;
+static const uint64_t STREAM_PART = 2;
+static const uint64_t STREAM_PARTSUPP = 3;
+
+// ============================================================================
+// 명세 단어 목록
+// ============================================================================
+
+#define COUNT_OF(a) (sizeof(a) / sizeof((a)[0]))
+
+static const char* const P_NAME_WORDS[] = {
+    "almond", "antique", "aquamarine", "azure", "beige", "bisque", "black", "blanched",
+    "blue", "blush", "brown", "burlywood", "burnished", "chartreuse", "chiffon", "chocolate",
+    "coral", "cornflower", "cornsilk", "cream", "cyan", "dark", "deep", "dim",
+    "dodger", "drab", "firebrick", "floral", "forest", "frosted", "gainsboro", "ghost",
+    "goldenrod", "green", "grey", "honeydew", "hot", "indian", "ivory", "khaki",
+    "lace", "lavender", "lawn", "lemon", "light", "lime", "linen", "magenta",
+    "maroon", "medium", "metallic", "midnight", "mint", "misty", "moccasin", "navajo",
+    "navy", "olive", "orange", "orchid", "pale", "papaya", "peach", "peru",
+    "pink", "plum", "powder", "puff", "purple", "red", "rose", "rosy",
+    "royal", "saddle", "salmon", "sandy", "seashell", "sienna", "sky", "slate",
+    "smoke", "snow", "spring", "steel", "tan", "thistle", "tomato", "turquoise",
+    "violet", "wheat", "white", "yellow"
+};
+
+static const char* const TYPE_SYLLABLE1[] = {
+    "STANDARD", "SMALL", "MEDIUM", "LARGE", "ECONOMY", "PROMO"
+};
+static const char* const TYPE_SYLLABLE2[] = {
+    "ANODIZED", "BURNISHED", "PLATED", "POLISHED", "BRUSHED"
+};
+static const char* const TYPE_SYLLABLE3[] = {
+    "TIN", "NICKEL", "BRASS", "STEEL", "COPPER"
+};
+
+static const char* const CONTAINER_SYLLABLE1[] = {
+    "SM", "LG", "MED", "JUMBO", "WRAP"
+};
+static const char* const CONTAINER_SYLLABLE2[] = {
+    "CASE", "BOX", "BAG", "JAR", "PKG", "PACK", "CAN", "DRUM"
+};
+
+static const char* const NOUNS[] = {
+    "foxes", "ideas", "theodolites", "pinto beans", "instructions", "dependencies",
+    "excuses", "platelets", "asymptotes", "courts", "dolphins", "multipliers",
+    "sauternes", "warthogs", "frets", "dinos", "attainments", "somas", "Tiresias'",
+    "patterns", "forges", "braids", "hockey players", "frays", "warhorses", "dugouts",
+    "notornis", "epitaphs", "pearls", "tithes", "waters", "orbits", "gifts", "sheaves",
+    "depths", "sentiments", "decoys", "realms", "pains", "grouches", "escapades"
+};
+static const char* const VERBS[] = {
+    "sleep", "wake", "are", "cajole", "haggle", "nag", "use", "boost", "affix",
+    "detect", "integrate", "maintain", "nod", "was", "lose", "sublate", "solve",
+    "thrash", "promise", "engage", "hinder", "print", "x-ray", "breach", "eat",
+    "grow", "impress", "mold", "poach", "serve", "run", "dazzle", "snooze", "doze",
+    "unwind", "kindle", "play", "hang", "believe", "doubt"
+};
+static const char* const ADJECTIVES[] = {
+    "furious", "sly", "careful", "blithe", "quick", "fluffy", "slow", "quiet",
+    "ruthless", "thin", "close", "dogged", "daring", "brave", "stealthy", "permanent",
+    "enticing", "idle", "busy", "regular", "final", "ironic", "even", "bold", "silent"
+};
+static const char* const ADVERBS[] = {
+    "sometimes", "always", "never", "furiously", "slyly", "carefully", "blithely",
+    "quickly", "fluffily", "slowly", "quietly", "ruthlessly", "thinly", "closely",
+    "doggedly", "daringly", "bravely", "stealthily", "permanently", "enticingly",
+    "idly", "busily", "regularly", "finally", "ironically", "evenly", "boldly", "silently"
+};
+static const char* const PREPOSITIONS[] = {
+    "about", "above", "according to", "across", "after", "against", "along",
+    "alongside of", "among", "around", "at", "atop", "before", "behind", "beneath",
+    "beside", "besides", "between", "beyond", "by", "despite", "during", "except",
+    "for", "from", "in place of", "inside", "instead of", "into", "near", "of", "on",
+    "outside", "over", "past", "since", "through", "throughout", "to", "toward",
+    "under", "until", "up", "upon", "without", "with", "within"
+};
+static const char* const AUXILIARIES[] = {
+    "do", "may", "might", "shall", "will", "would", "can", "could", "should",
+    "ought to", "must", "will have to", "shall have to", "could have to",
+    "should have to", "must have to", "need to", "try to"
+};
+static const char* const TERMINATORS[] = {
+    ".", ";", ":", "?", "!", "--"
+};
+
+// ============================================================================
+// 행 단위 난수열 (splitmix64)
+// ============================================================================
+
+static uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+class RowRandom {
+private:
+    uint64_t state;
+
+public:
+    RowRandom(uint64_t seed, uint64_t stream, uint64_t row)
+        : state(mix64(seed ^ mix64(stream * 0x9E3779B97F4A7C15ull + row))) {}
+
+    uint64_t next() {
+        state += 0x9E3779B97F4A7C15ull;
+        return mix64(state);
+    }
+
+    // [lo, hi] 균등 분포
+    int64_t range(int64_t lo, int64_t hi) {
+        return lo + static_cast<int64_t>(next() % static_cast<uint64_t>(hi - lo + 1));
+    }
+
+    template <size_t N>
+    const char* pick(const char* const (&words)[N]) {
+        return words[next() % N];
+    }
+};
+
+// ============================================================================
+// TpchGenerator 구현
+// ============================================================================
+
+TpchGenerator::TpchGenerator(double sf, uint64_t rng_seed, size_t threads)
+    : scale_factor(sf), seed(rng_seed), num_threads(threads) {
+    if (!(scale_factor > 0)) {
+        throw std::runtime_error("Scale factor must be positive");
+    }
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    buildTextPool();
+}
+
+size_t TpchGenerator::getPartCount() const {
+    return std::max<size_t>(1, static_cast<size_t>(std::llround(scale_factor * 200000)));
+}
+
+size_t TpchGenerator::getSupplierCount() const {
+    return std::max<size_t>(1, static_cast<size_t>(std::llround(scale_factor * 10000)));
+}
+
+void TpchGenerator::buildTextPool() {
+    RowRandom rng(seed, STREAM_TEXT, 0);
+    text_pool.clear();
+    text_pool.reserve(TEXT_POOL_SIZE + 256);
+
+    auto word = [&](const char* w) {
+        if (!text_pool.empty() && text_pool.back() != ' ') {
+            text_pool += ' ';
+        }
+        text_pool += w;
+    };
+
+    // 명사구: noun | adjective noun | adjective, adjective noun | adverb adjective noun
+    auto nounPhrase = [&]() {
+        switch (rng.next() % 4) {
+            case 0:
+                word(rng.pick(NOUNS));
+                break;
+            case 1:
+                word(rng.pick(ADJECTIVES));
+                word(rng.pick(NOUNS));
+                break;
+            case 2:
+                word(rng.pick(ADJECTIVES));
+                text_pool += ',';
+                word(rng.pick(ADJECTIVES));
+                word(rng.pick(NOUNS));
+                break;
+            default:
+                word(rng.pick(ADVERBS));
+                word(rng.pick(ADJECTIVES));
+                word(rng.pick(NOUNS));
+                break;
+        }
+    };
+
+    // 동사구: verb | auxiliary verb | verb adverb | auxiliary verb adverb
+    auto verbPhrase = [&]() {
+        uint64_t form = rng.next() % 4;
+        if (form == 1 || form == 3) {
+            word(rng.pick(AUXILIARIES));
+        }
+        word(rng.pick(VERBS));
+        if (form >= 2) {
+            word(rng.pick(ADVERBS));
+        }
+    };
+
+    // 전치사구: preposition the noun phrase
+    auto prepositionalPhrase = [&]() {
+        word(rng.pick(PREPOSITIONS));
+        word("the");
+        nounPhrase();
+    };
+
+    while (text_pool.size() < TEXT_POOL_SIZE) {
+        switch (rng.next() % 5) {
+            case 0:
+                nounPhrase(); verbPhrase();
+                break;
+            case 1:
+                nounPhrase(); verbPhrase(); prepositionalPhrase();
+                break;
+            case 2:
+                nounPhrase(); verbPhrase(); nounPhrase();
+                break;
+            case 3:
+                nounPhrase(); prepositionalPhrase(); verbPhrase(); nounPhrase();
+                break;
+            default:
+                nounPhrase(); prepositionalPhrase(); verbPhrase(); prepositionalPhrase();
+                break;
+        }
+        text_pool += rng.pick(TERMINATORS);
+        text_pool += ' ';
+    }
+}
+
+// 텍스트 풀에서 [min_len, max_len] 길이 문자열을 잘라냄
+static std::string randomText(RowRandom& rng, const std::string& pool,
+                              size_t min_len, size_t max_len) {
+    size_t length = static_cast<size_t>(rng.range(min_len, max_len));
+    size_t offset = static_cast<size_t>(rng.range(0, pool.size() - max_len));
+    return pool.substr(offset, length);
+}
+
+PartRecord TpchGenerator::makePart(int_t partkey) const {
+    RowRandom rng(seed, STREAM_PART, static_cast<uint64_t>(partkey));
+    PartRecord part;
+    part.partkey = partkey;
+
+    // P_NAME: 서로 다른 색상 단어 5개
+    size_t chosen[5];
+    for (size_t i = 0; i < 5; ++i) {
+        bool duplicate;
+        do {
+            chosen[i] = rng.next() % COUNT_OF(P_NAME_WORDS);
+            duplicate = std::find(chosen, chosen + i, chosen[i]) != chosen + i;
+        } while (duplicate);
+
+        if (i > 0) part.name += ' ';
+        part.name += P_NAME_WORDS[chosen[i]];
+    }
+
+    // P_MFGR / P_BRAND (브랜드 첫 자리는 제조사 번호)
+    int64_t manufacturer = rng.range(1, 5);
+    part.mfgr = "Manufacturer#" + std::to_string(manufacturer);
+    part.brand = "Brand#" + std::to_string(manufacturer) + std::to_string(rng.range(1, 5));
+
+    part.type = std::string(rng.pick(TYPE_SYLLABLE1)) + " " + rng.pick(TYPE_SYLLABLE2) +
+                " " + rng.pick(TYPE_SYLLABLE3);
+    part.size = static_cast<int_t>(rng.range(1, 50));
+    part.container = std::string(rng.pick(CONTAINER_SYLLABLE1)) + " " +
+                     rng.pick(CONTAINER_SYLLABLE2);
+
+    // P_RETAILPRICE = (90000 + ((P_PARTKEY/10) mod 20001) + 100 * (P_PARTKEY mod 1000)) / 100
+    int64_t cents = 90000 + ((partkey / 10) % 20001) + 100 * (partkey % 1000);
+    part.retailprice = static_cast<float>(cents) / 100.0f;
+
+    part.comment = randomText(rng, text_pool, 5, 22);
+    return part;
+}
+
+PartSuppRecord TpchGenerator::makePartSupp(int_t partkey, int supplier_index) const {
+    RowRandom rng(seed, STREAM_PARTSUPP,
+                  static_cast<uint64_t>(partkey) * 4 + static_cast<uint64_t>(supplier_index));
+    PartSuppRecord partsupp;
+    partsupp.partkey = partkey;
+
+    // PS_SUPPKEY = (partkey + (i * ((S/4) + (partkey-1)/S))) mod S + 1
+    int64_t suppliers = static_cast<int64_t>(getSupplierCount());
+    int64_t pk = partkey;
+    partsupp.suppkey = static_cast<int_t>(
+        (pk + (supplier_index * ((suppliers / 4) + (pk - 1) / suppliers))) % suppliers + 1);
+
+    partsupp.availqty = static_cast<int_t>(rng.range(1, 9999));
+    partsupp.supplycost = static_cast<float>(rng.range(100, 100000)) / 100.0f;
+    partsupp.comment = randomText(rng, text_pool, 49, 198);
+    return partsupp;
+}
+
+size_t TpchGenerator::generate(const std::string& table_type, TableWriter& writer,
+                               size_t block_size, RecordEncoding encoding,
+                               PartDictionary* dict) {
+    bool is_part = (table_type == "PART");
+    if (!is_part && table_type != "PARTSUPP") {
+        throw std::runtime_error("Unknown table type: " + table_type);
+    }
+    if (dict && !is_part) {
+        throw std::runtime_error("Dictionary encoding is only supported for PART");
+    }
+
+    size_t part_count = getPartCount();
+    size_t batch_count = (part_count + PARTS_PER_BATCH - 1) / PARTS_PER_BATCH;
+
+    Block block(block_size);
+    RecordBuilder builder(&block, encoding);
+    size_t record_count = 0;
+    size_t oversized = 0;
+
+    // 라운드마다 스레드 수만큼 배치를 병렬 생성하고 partkey 순서대로 기록
+    for (size_t first = 0; first < batch_count; first += num_threads) {
+        size_t batches = std::min(num_threads, batch_count - first);
+
+        std::vector<RecordStaging> staged;
+        staged.reserve(batches);
+        for (size_t i = 0; i < batches; ++i) {
+            staged.emplace_back(block_size, encoding);
+        }
+        std::vector<std::vector<PartRecord>> parts(batches);
+        std::vector<std::exception_ptr> failures(batches);
+
+        auto work = [&](size_t i) {
+            TRACE_SPAN("generate batch", "load");
+            try {
+                size_t begin = (first + i) * PARTS_PER_BATCH + 1;
+                size_t end = std::min(begin + PARTS_PER_BATCH, part_count + 1);
+                for (size_t key = begin; key < end; ++key) {
+                    int_t partkey = static_cast<int_t>(key);
+                    if (!is_part) {
+                        for (int s = 0; s < 4; ++s) {
+                            staged[i].add(makePartSupp(partkey, s));
+                        }
+                    } else if (dict) {
+                        parts[i].push_back(makePart(partkey));
+                    } else {
+                        staged[i].add(makePart(partkey));
+                    }
+                }
+            } catch (...) {
+                failures[i] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < batches; ++i) {
+            workers.emplace_back(work, i);
+        }
+        work(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        for (size_t i = 0; i < batches; ++i) {
+            if (failures[i]) {
+                std::rethrow_exception(failures[i]);
+            }
+
+            // 딕셔너리 모드: partkey 순서로 코드 할당
+            for (const auto& part : parts[i]) {
+                if (!part.writeTo(builder, dict)) {
+                    writer.writeBlock(&block);
+                    block.clear();
+                    if (!part.writeTo(builder, dict)) {
+                        throw std::runtime_error("Record too large for block");
+                    }
+                }
+                record_count++;
+            }
+
+            record_count += staged[i].drainTo(block, writer, oversized);
+        }
+    }
+
+    if (oversized > 0) {
+        throw std::runtime_error("Record too large for block");
+    }
+
+    // 마지막 블록 쓰기
+    if (!block.isEmpty()) {
+        writer.writeBlock(&block);
+    }
+
+    return record_count;
+}
+
+size_t generateTpchTable(const std::string& block_file,
+                         const std::string& table_type,
+                         double scale_factor,
+                         uint64_t seed,
+                         size_t block_size,
+                         RecordEncoding encoding,
+                         bool dictionary_encode,
+                         bool compress,
+                         size_t num_threads) {
+    if (dictionary_encode && table_type != "PART") {
+        throw std::runtime_error("Dictionary encoding is only supported for PART");
+    }
+
+    TpchGenerator generator(scale_factor, seed, num_threads);
+
+    TableWriter writer(block_file, nullptr, compress);
+    writer.setTableType(table_type);
+    writer.setRecordEncoding(encoding);
+    writer.setDictionaryEncoded(dictionary_encode);
+
+    std::unique_ptr<PartDictionary> dict;
+    if (dictionary_encode) {
+        dict.reset(new PartDictionary());
+    }
+
+    size_t record_count = generator.generate(table_type, writer, block_size, encoding, dict.get());
+
+    std::cout << "Generated " << record_count << " " << table_type << " records (SF "
+              << scale_factor << ", seed " << seed << ", " << generator.getThreadCount()
+              << " threads) to " << block_file << std::endl;
+    writer.printCompressionSummary();
+
+    if (dict) {
+        dict->save(block_file);
+    }
+    return record_count;
+}
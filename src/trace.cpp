@@ -0,0 +1,174 @@
+#include "trace.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+
+// ============================================================================
+// 스레드별 버퍼
+// ============================================================================
+namespace {
+
+const size_t TRACE_CHUNK_EVENTS = 4096;
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    const char* arg_name;
+    uint64_t arg_value;
+    uint64_t start_ns;
+    uint64_t end_ns;
+};
+
+struct TraceChunk {
+    TraceChunk* next;
+    size_t count;
+    TraceEvent events[TRACE_CHUNK_EVENTS];
+};
+
+struct ThreadBuffer {
+    ThreadBuffer* next;      // 전역 목록 (등록 순서의 역순)
+    int tid;
+    const char* name;        // nullptr이면 기본 이름
+    TraceChunk* head;
+    TraceChunk* tail;
+};
+
+std::mutex g_registry_mutex;
+ThreadBuffer* g_buffers = nullptr;
+int g_next_tid = 1;
+std::string g_path;
+bool g_finished = false;
+std::chrono::steady_clock::time_point g_start;
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+// 이 스레드의 버퍼 (처음 한 번만 잠금을 잡고 등록)
+ThreadBuffer* threadBuffer() {
+    if (!t_buffer) {
+        ThreadBuffer* buffer = static_cast<ThreadBuffer*>(std::malloc(sizeof(ThreadBuffer)));
+        if (!buffer) {
+            return nullptr;
+        }
+        buffer->name = nullptr;
+        buffer->head = buffer->tail = nullptr;
+
+        std::lock_guard<std::mutex> lock(g_registry_mutex);
+        buffer->tid = g_next_tid++;
+        buffer->next = g_buffers;
+        g_buffers = buffer;
+        t_buffer = buffer;
+    }
+    return t_buffer;
+}
+
+} // namespace
+
+// ============================================================================
+// Trace 구현
+// ============================================================================
+std::atomic<bool> Trace::active(false);
+
+void Trace::start(const std::string& path) {
+    g_path = path;
+    g_start = std::chrono::steady_clock::now();
+    active.store(true, std::memory_order_relaxed);
+    setThreadName("main");
+    std::atexit([]() { Trace::finish(); });
+}
+
+uint64_t Trace::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - g_start).count());
+}
+
+void Trace::setThreadName(const char* name) {
+    if (!enabled()) {
+        return;
+    }
+    if (ThreadBuffer* buffer = threadBuffer()) {
+        buffer->name = name;
+    }
+}
+
+void Trace::record(const char* name, const char* category, uint64_t start_ns,
+                   uint64_t end_ns, const char* arg_name, uint64_t arg_value) {
+    ThreadBuffer* buffer = threadBuffer();
+    if (!buffer) {
+        return;
+    }
+    if (!buffer->tail || buffer->tail->count == TRACE_CHUNK_EVENTS) {
+        TraceChunk* chunk = static_cast<TraceChunk*>(std::malloc(sizeof(TraceChunk)));
+        if (!chunk) {
+            return;
+        }
+        chunk->next = nullptr;
+        chunk->count = 0;
+        if (buffer->tail) {
+            buffer->tail->next = chunk;
+        } else {
+            buffer->head = chunk;
+        }
+        buffer->tail = chunk;
+    }
+
+    TraceEvent& event = buffer->tail->events[buffer->tail->count++];
+    event.name = name;
+    event.category = category;
+    event.arg_name = arg_name;
+    event.arg_value = arg_value;
+    event.start_ns = start_ns;
+    event.end_ns = end_ns;
+}
+
+void Trace::finish() {
+    active.store(false, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    if (g_finished || g_path.empty()) {
+        return;
+    }
+    g_finished = true;
+
+    std::ofstream out(g_path);
+    if (!out) {
+        std::cerr << "Cannot open trace file: " << g_path << std::endl;
+        return;
+    }
+
+    // ts, dur는 마이크로초
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"dbsys\"}}";
+    out << std::fixed << std::setprecision(3);
+
+    size_t event_count = 0;
+    for (ThreadBuffer* buffer = g_buffers; buffer; buffer = buffer->next) {
+        std::string thread_name = buffer->name ? buffer->name
+                                : buffer->tid == 1 ? "main"
+                                : "worker " + std::to_string(buffer->tid - 1);
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+            << ",\"args\":{\"name\":\"" << thread_name << "\"}}";
+        out << ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+            << ",\"args\":{\"sort_index\":" << buffer->tid << "}}";
+
+        for (TraceChunk* chunk = buffer->head; chunk; chunk = chunk->next) {
+            for (size_t i = 0; i < chunk->count; ++i) {
+                const TraceEvent& event = chunk->events[i];
+                out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                    << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                    << ",\"ts\":" << event.start_ns / 1000.0
+                    << ",\"dur\":" << (event.end_ns - event.start_ns) / 1000.0;
+                if (event.arg_name) {
+                    out << ",\"args\":{\"" << event.arg_name << "\":" << event.arg_value << "}";
+                }
+                out << "}";
+                event_count++;
+            }
+        }
+    }
+    out << "\n]}\n";
+
+    std::cout << "Trace: " << event_count << " spans written to " << g_path << std::endl;
+}
@@ -0,0 +1,168 @@
+#include "zone_map.h"
+#include "record.h"
+#include "pax.h"
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+// 10진 정수 필드 파싱 (std::to_string 표기). 숫자가 아니면 false
+static bool parseKey(const FieldRef& field, int_t& value) {
+    if (field.size == 0 || field.size > 11) {
+        return false;
+    }
+
+    size_t pos = 0;
+    bool negative = false;
+    if (field.data[0] == '-') {
+        negative = true;
+        pos = 1;
+        if (field.size == 1) return false;
+    }
+
+    int64_t result = 0;
+    for (; pos < field.size; ++pos) {
+        char c = field.data[pos];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        result = result * 10 + (c - '0');
+    }
+    if (negative) {
+        result = -result;
+    }
+    if (result < INT32_MIN || result > INT32_MAX) {
+        return false;
+    }
+
+    value = static_cast<int_t>(result);
+    return true;
+}
+
+bool ZoneMap::computeEntry(const Block* block, uint64_t offset, ZoneEntry& entry) {
+    entry.min_key = INT32_MAX;
+    entry.max_key = INT32_MIN;
+    entry.offset = offset;
+    entry.record_count = 0;
+    entry.flags = ZONE_FLAG_SORTED;
+
+    int_t prev = INT32_MIN;
+    auto observe = [&](int_t key) {
+        if (key < entry.min_key) entry.min_key = key;
+        if (key > entry.max_key) entry.max_key = key;
+        if (key < prev) entry.flags &= ~ZONE_FLAG_SORTED;
+        prev = key;
+        entry.record_count++;
+    };
+
+    if (PaxPage::isPaxPage(block)) {
+        PaxPage page(block);
+        if (page.getColumnCount() == 0 || page.getColumnType(0) != ColumnType::INT) {
+            return false;
+        }
+        const int_t* keys = page.getIntColumn(0);
+        for (size_t i = 0; i < page.getRecordCount(); ++i) {
+            observe(keys[i]);
+        }
+        return true;
+    }
+
+    RecordReader reader(block);
+    while (reader.hasNext()) {
+        RecordView view = reader.readNextView();
+        int_t key;
+        if (view.getFieldCount() == 0 || !parseKey(view.getField(0), key)) {
+            return false;
+        }
+        observe(key);
+    }
+    return true;
+}
+
+bool ZoneMap::getKeyRange(int_t& lo, int_t& hi) const {
+    bool found = false;
+    lo = INT32_MAX;
+    hi = INT32_MIN;
+    for (const auto& entry : entries) {
+        if (entry.record_count == 0) continue;
+        if (entry.min_key < lo) lo = entry.min_key;
+        if (entry.max_key > hi) hi = entry.max_key;
+        found = true;
+    }
+    return found;
+}
+
+bool ZoneMap::isSorted() const {
+    bool has_prev = false;
+    int_t prev_max = INT32_MIN;
+    for (const auto& entry : entries) {
+        if (entry.record_count == 0) continue;
+        if (!entry.isSorted()) return false;
+        if (has_prev && entry.min_key < prev_max) return false;
+        prev_max = entry.max_key;
+        has_prev = true;
+    }
+    return true;
+}
+
+void ZoneMap::save(const std::string& block_file) const {
+    std::string path = sidecarPath(block_file);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open zone map file: " + path);
+    }
+
+    uint32_t magic = ZONE_MAP_MAGIC;
+    uint32_t count = static_cast<uint32_t>(entries.size());
+    file.write(reinterpret_cast<const char*>(&magic), sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(uint32_t));
+
+    for (const auto& entry : entries) {
+        file.write(reinterpret_cast<const char*>(&entry.min_key), sizeof(int_t));
+        file.write(reinterpret_cast<const char*>(&entry.max_key), sizeof(int_t));
+        file.write(reinterpret_cast<const char*>(&entry.offset), sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(&entry.record_count), sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(&entry.flags), sizeof(uint32_t));
+    }
+
+    if (!file.good()) {
+        throw std::runtime_error("Failed to write zone map file: " + path);
+    }
+}
+
+std::unique_ptr<ZoneMap> ZoneMap::loadIfExists(const std::string& block_file) {
+    std::ifstream file(sidecarPath(block_file), std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    uint32_t magic = 0, count = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(uint32_t));
+    file.read(reinterpret_cast<char*>(&count), sizeof(uint32_t));
+    if (!file || magic != ZONE_MAP_MAGIC) {
+        return nullptr;
+    }
+
+    std::unique_ptr<ZoneMap> zone_map(new ZoneMap());
+    zone_map->entries.reserve(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        ZoneEntry entry;
+        file.read(reinterpret_cast<char*>(&entry.min_key), sizeof(int_t));
+        file.read(reinterpret_cast<char*>(&entry.max_key), sizeof(int_t));
+        file.read(reinterpret_cast<char*>(&entry.offset), sizeof(uint64_t));
+        file.read(reinterpret_cast<char*>(&entry.record_count), sizeof(uint32_t));
+        file.read(reinterpret_cast<char*>(&entry.flags), sizeof(uint32_t));
+        if (!file) {
+            // 잘린 사이드카는 무시 (건너뛰기 없이 전체 스캔)
+            return nullptr;
+        }
+        zone_map->entries.push_back(entry);
+    }
+
+    return zone_map;
+}
+
+void ZoneMap::remove(const std::string& block_file) {
+    std::remove(sidecarPath(block_file).c_str());
+}
@@ -0,0 +1,59 @@
+#!/bin/sh
+# ============================================================================
+# 델타 조인: 개수가 같게 다시 쓴 입력은 전체 재계산해야 함
+# ============================================================================
+# 사용법: delta_join_rewrite.sh <dbsys 경로> <작업 디렉터리>
+#
+# 1. PART / PARTSUPP 생성 후 --delta-join (처음이라 전체 재계산)
+# 2. PARTSUPP를 다른 seed로 다시 생성 (행/블록 수는 같음)
+# 3. --delta-join 다시 실행 → 워터마크 지문이 달라 전체 재계산이어야 하고,
+#    결과 파일은 새로 계산한 결과와 바이트 단위로 같아야 함 (실행마다 바뀌는 헤더 제외)
+# 4. 가운데 블록의 값 하나만 바꿔 PARTSUPP CSV를 다시 변환 (첫/마지막 블록은 같음)
+#    → write_id가 달라 역시 전체 재계산이어야 함
+set -e
+
+DBSYS="$1"
+WORK="$2"
+rm -rf "$WORK"
+mkdir -p "$WORK"
+cd "$WORK"
+
+# 두 블록 파일이 헤더(write_id가 실행마다 다름)를 빼고 같은지
+same_blocks() {
+    tail -c +65 "$1" > "$1.body"
+    tail -c +65 "$2" > "$2.body"
+    cmp "$1.body" "$2.body"
+}
+
+"$DBSYS" --generate --table PART --scale-factor 0.005 --seed 1 --block-file part.dat > /dev/null
+"$DBSYS" --generate --table PARTSUPP --scale-factor 0.005 --seed 1 --block-file ps.dat > /dev/null
+"$DBSYS" --delta-join --outer-table part.dat --inner-table ps.dat --output delta.dat > /dev/null
+
+# 같은 입력이면 델타 모드 (새 행 0개)
+"$DBSYS" --delta-join --outer-table part.dat --inner-table ps.dat --output delta.dat > log.txt
+grep -q "Mode: delta" log.txt || { echo "FAIL: unchanged inputs did not use delta mode"; cat log.txt; exit 1; }
+
+# 개수는 같고 내용만 다른 PARTSUPP
+"$DBSYS" --generate --table PARTSUPP --scale-factor 0.005 --seed 2 --block-file ps.dat > /dev/null
+"$DBSYS" --delta-join --outer-table part.dat --inner-table ps.dat --output delta.dat > log.txt
+grep -q "Mode: full recompute" log.txt || { echo "FAIL: rewritten input was not recomputed"; cat log.txt; exit 1; }
+
+# 워터마크 없이 새로 계산한 결과와 비교
+"$DBSYS" --delta-join --outer-table part.dat --inner-table ps.dat --output fresh.dat > /dev/null
+same_blocks delta.dat fresh.dat || { echo "FAIL: result differs from a fresh full recompute"; exit 1; }
+
+# 가운데 블록만 다른 PARTSUPP (CSV에서 가운데 행의 availqty만 같은 자릿수로 바꿈)
+awk 'BEGIN { for (i = 1; i <= 4000; i++)
+    printf "%d|%d|%d|%d.%02d|comment %d|\n", (i - 1) % 1000 + 1, i, 1000 + i % 9000, i % 1000, i % 100, i }' > ps.tbl
+"$DBSYS" --convert-csv --csv-file ps.tbl --block-file ps.dat --table-type PARTSUPP > /dev/null
+"$DBSYS" --delta-join --outer-table part.dat --inner-table ps.dat --output delta.dat > /dev/null
+
+awk -F'|' 'BEGIN { OFS = "|" } NR == 2000 { $3 = ($3 == 1111 ? 2222 : 1111) } { print }' ps.tbl > ps2.tbl
+"$DBSYS" --convert-csv --csv-file ps2.tbl --block-file ps.dat --table-type PARTSUPP > /dev/null
+"$DBSYS" --delta-join --outer-table part.dat --inner-table ps.dat --output delta.dat > log.txt
+grep -q "Mode: full recompute" log.txt || { echo "FAIL: middle-block rewrite was not recomputed"; cat log.txt; exit 1; }
+
+"$DBSYS" --delta-join --outer-table part.dat --inner-table ps.dat --output fresh.dat > /dev/null
+same_blocks delta.dat fresh.dat || { echo "FAIL: result differs from a fresh full recompute after a middle-block rewrite"; exit 1; }
+
+echo "PASS"
@@ -0,0 +1,74 @@
+#!/bin/sh
+# ============================================================================
+# 블록 파일 형식 왕복: 압축 / 오프셋 인덱스 레코드 / PAX 레이아웃
+# ============================================================================
+# 사용법: format_roundtrip.sh <dbsys 경로> <작업 디렉터리>
+#
+# 1. 같은 seed로 PART / PARTSUPP를 형식별로 생성
+#    (row, indexed, compress, indexed + compress, dict-encode + compress)
+# 2. row → PAX → row, row → PAX(압축) 레이아웃 변환
+# 3. 모든 변형의 조인 결과 체크섬(--sink checksum)이 row 파일과 같아야 함
+# 4. 압축 파일의 프레임을 망가뜨리면 오류로 끝나야 하고 비정상 종료(시그널)는 안 됨
+set -e
+
+DBSYS="$1"
+WORK="$2"
+rm -rf "$WORK"
+mkdir -p "$WORK"
+cd "$WORK"
+
+SF=0.005
+
+# 조인 결과 체크섬 줄 ("Result Checksum: 0x... (N rows)")
+checksum() {
+    "$DBSYS" --join --outer-table "$1" --inner-table "$2" --algorithm hash \
+        --sink checksum > log.txt
+    grep "Result Checksum:" log.txt || { echo "FAIL: no checksum for $1 x $2"; cat log.txt; exit 1; }
+}
+
+for table in PART PARTSUPP; do
+    name=$(echo "$table" | tr 'A-Z' 'a-z')
+    "$DBSYS" --generate --table $table --scale-factor $SF --seed 7 --block-file $name.row.dat > /dev/null
+    "$DBSYS" --generate --table $table --scale-factor $SF --seed 7 --block-file $name.indexed.dat \
+        --record-format indexed > /dev/null
+    "$DBSYS" --generate --table $table --scale-factor $SF --seed 7 --block-file $name.lz.dat \
+        --compress > /dev/null
+    "$DBSYS" --generate --table $table --scale-factor $SF --seed 7 --block-file $name.indexed_lz.dat \
+        --record-format indexed --compress > /dev/null
+
+    "$DBSYS" --convert-layout --block-file $name.row.dat --output $name.pax.dat --layout pax > /dev/null
+    "$DBSYS" --convert-layout --block-file $name.pax.dat --output $name.back.dat --layout row > /dev/null
+    "$DBSYS" --convert-layout --block-file $name.row.dat --output $name.pax_lz.dat --layout pax \
+        --compress > /dev/null
+done
+"$DBSYS" --generate --table PART --scale-factor $SF --seed 7 --block-file part.dict_lz.dat \
+    --dict-encode --compress > /dev/null
+
+expected=$(checksum part.row.dat partsupp.row.dat)
+for variant in indexed lz indexed_lz pax back pax_lz; do
+    actual=$(checksum part.$variant.dat partsupp.$variant.dat)
+    [ "$actual" = "$expected" ] || {
+        echo "FAIL: $variant result differs from the row files"
+        echo "  expected: $expected"
+        echo "  actual:   $actual"
+        exit 1
+    }
+done
+actual=$(checksum part.dict_lz.dat partsupp.lz.dat)
+[ "$actual" = "$expected" ] || { echo "FAIL: dictionary-encoded compressed PART differs"; exit 1; }
+
+# 압축 프레임 손상: 헤더(64B) + 압축 파일 헤더 뒤의 바이트를 덮어씀
+cp partsupp.lz.dat corrupt.dat
+printf '\377\377\377\377\377\377\377\377\377\377\377\377\377\377\377\377' |
+    dd of=corrupt.dat bs=1 seek=80 conv=notrunc 2> /dev/null
+status=0
+"$DBSYS" --join --outer-table part.row.dat --inner-table corrupt.dat --algorithm hash \
+    --sink count > log.txt 2>&1 || status=$?
+if [ $status -ge 128 ]; then
+    echo "FAIL: corrupt compressed frame crashed dbsys (status $status)"
+    cat log.txt
+    exit 1
+fi
+[ $status -ne 0 ] || { echo "FAIL: corrupt compressed frame was not reported"; cat log.txt; exit 1; }
+
+echo "PASS"
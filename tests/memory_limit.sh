@@ -0,0 +1,117 @@
+#!/bin/sh
+# ============================================================================
+# --memory-limit: 할당 추적기가 잰 최대 메모리가 메모리 그랜트 안에 있어야 함
+# ============================================================================
+# 사용법: memory_limit.sh <dbsys 경로> <작업 디렉터리>
+#
+# 1. PART / PARTSUPP 생성 후 한도 없이 해시 조인 체크섬(--sink checksum)을 구함
+# 2. BNLJ / 해시 조인 × 양쪽 방향 × 출력(file, checksum)을 한도 96K / 128K / 256K로 실행
+# 3. --stats-json의 tracked_memory_peak_bytes가 memory_usage_bytes(그랜트 최대 사용량)
+#    이하여야 하고, 체크섬은 한도 없는 실행과 같아야 함 (할당 추적을 끈 빌드는 체크섬만)
+# 4. 버퍼 풀과 페이지 캐시가 큰 BNLJ도 한도 4M에서 같은 검사
+# 5. inner를 버퍼에 캐시하는 BNLJ는 inner를 한 번만 디코딩해야 함 (한도 8M)
+set -e
+
+DBSYS="$1"
+WORK="$2"
+rm -rf "$WORK"
+mkdir -p "$WORK"
+cd "$WORK"
+
+SF=0.01
+
+"$DBSYS" --generate --table PART --scale-factor $SF --seed 11 --block-file part.dat > /dev/null
+"$DBSYS" --generate --table PARTSUPP --scale-factor $SF --seed 11 --block-file partsupp.dat > /dev/null
+
+# 조인 결과 체크섬 줄 ("Result Checksum: 0x... (N rows)")
+checksum() {
+    grep "Result Checksum:" "$1" || { echo "FAIL: no checksum"; cat "$1"; exit 1; }
+}
+
+# stats.json에서 정수 필드 값
+stat() {
+    sed -n "s/.*\"$1\": *\([0-9][0-9]*\).*/\1/p" stats.json | head -n 1
+}
+
+"$DBSYS" --join --outer-table part.dat --inner-table partsupp.dat --algorithm hash \
+    --sink checksum --stats-json stats.json > log.txt
+expected=$(checksum log.txt)
+
+# DBSYS_TRACK_ALLOC=0 빌드는 추적한 최대치가 0이므로 그랜트 비교를 건너뛰고 체크섬만 검사
+tracking=true
+grep -q '"alloc_tracking": false' stats.json && tracking=false
+[ $tracking = true ] || echo "allocation tracking disabled; checking results only"
+
+for limit in 96K 128K 256K; do
+    for algorithm in bnlj hash; do
+        for order in "part.dat partsupp.dat" "partsupp.dat part.dat"; do
+            set -- $order
+            for sink in file checksum; do
+                "$DBSYS" --join --outer-table "$1" --inner-table "$2" --algorithm $algorithm \
+                    --memory-limit $limit --sink $sink --output out.dat \
+                    --stats-json stats.json > log.txt 2>&1 || {
+                    echo "FAIL: $algorithm $1 x $2 ($sink) failed under --memory-limit $limit"
+                    cat log.txt
+                    exit 1
+                }
+                granted=$(stat memory_usage_bytes)
+                tracked=$(stat tracked_memory_peak_bytes)
+                [ -n "$granted" ] && [ -n "$tracked" ] || {
+                    echo "FAIL: memory fields missing from stats.json"
+                    cat stats.json
+                    exit 1
+                }
+                [ $tracking = false ] || [ "$tracked" -le "$granted" ] || {
+                    echo "FAIL: $algorithm $1 x $2 ($sink, --memory-limit $limit)"
+                    echo "  tracked peak $tracked bytes exceeds grant peak $granted bytes"
+                    exit 1
+                }
+                if [ $sink = checksum ]; then
+                    actual=$(checksum log.txt)
+                    [ "$actual" = "$expected" ] || {
+                        echo "FAIL: $algorithm $1 x $2 under --memory-limit $limit differs"
+                        echo "  expected: $expected"
+                        echo "  actual:   $actual"
+                        exit 1
+                    }
+                fi
+            done
+        done
+    done
+done
+
+# 버퍼 풀이 큰 BNLJ: 프레임마다 Block 객체와 페이지 캐시 메타데이터도 예약에 들어가야 함
+for options in "--buffer-size 100 --cache-size 400" "--auto --buffer-size 400 --cache-size 50"; do
+    "$DBSYS" --join --outer-table part.dat --inner-table partsupp.dat --algorithm bnlj $options \
+        --memory-limit 4M --sink checksum --stats-json stats.json > log.txt 2>&1 || {
+        echo "FAIL: bnlj $options failed under --memory-limit 4M"
+        cat log.txt
+        exit 1
+    }
+    [ $tracking = false ] || [ "$(stat tracked_memory_peak_bytes)" -le "$(stat memory_usage_bytes)" ] || {
+        echo "FAIL: bnlj $options tracked peak exceeds grant peak under --memory-limit 4M"
+        exit 1
+    }
+    [ "$(checksum log.txt)" = "$expected" ] || { echo "FAIL: bnlj $options result differs"; exit 1; }
+done
+
+# 캐시한 inner: 한 번만 디코딩해 모든 청크가 다시 쓰고, 그 레코드도 예약 안에 있어야 함
+"$DBSYS" --join --outer-table part.dat --inner-table partsupp.dat --algorithm bnlj --auto \
+    --buffer-size 400 --memory-limit 8M --sink checksum --stats-json stats.json > log.txt 2>&1 || {
+    echo "FAIL: cached inner failed under --memory-limit 8M"
+    cat log.txt
+    exit 1
+}
+grep -q "(cached)" log.txt || { echo "FAIL: inner table was not cached"; cat log.txt; exit 1; }
+grep -q "Inner table decoded once" log.txt || {
+    echo "FAIL: cached inner table was not decoded once"
+    cat log.txt
+    exit 1
+}
+[ $tracking = false ] || [ "$(stat tracked_memory_peak_bytes)" -le "$(stat memory_usage_bytes)" ] || {
+    echo "FAIL: decoded cached inner exceeds grant peak under --memory-limit 8M"
+    exit 1
+}
+[ "$(checksum log.txt)" = "$expected" ] || { echo "FAIL: cached inner result differs"; exit 1; }
+
+echo "PASS"